@@ -4,18 +4,17 @@
  */
 #include <getopt.h>
 #include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/SchedulerGroup.h>
 #include <nitrocoro/http/Form.h>
 #include <nitrocoro/http/HttpServer.h>
 #include <nitrocoro/utils/Debug.h>
-#include <thread>
-#include <vector>
 
 using namespace nitrocoro;
 using namespace nitrocoro::http;
 
-Task<> server_main(uint16_t port)
+Task<> server_main(uint16_t port, SchedulerGroup & group)
 {
-    HttpServer server(port);
+    HttpServer server(port, group);
 
     server.route("/", { "GET" }, [](auto && req, auto && resp) -> Task<> {
         resp.setStatus(StatusCode::k200OK);
@@ -101,16 +100,9 @@ int main(int argc, char * argv[])
         }
     }
 
-    auto runWorker = [port]() {
-        Scheduler scheduler;
-        scheduler.spawn([port]() -> Task<> { co_await server_main(port); });
-        scheduler.run();
-    };
-
-    std::vector<std::thread> threads;
-    threads.reserve(threadCount);
-    for (size_t i = 0; i < threadCount; ++i)
-        threads.emplace_back(runWorker);
+    SchedulerGroup group(threadCount);
+    group.start();
+    group.at(0)->spawn([port, &group]() -> Task<> { co_await server_main(port, group); });
 
     printf("=== HTTP Server Test === threads=%zu\n"
            "Try:\n"
@@ -119,8 +111,7 @@ int main(int argc, char * argv[])
            "  curl -X POST -d 'test data' http://localhost:%hu/echo\n"
            "  curl -X POST -d 'name=Alice&age=25' http://localhost:%hu/form\n",
            threadCount, port, port, port, port);
-    for (auto & t : threads)
-        t.join();
+    group.wait();
 
     return 0;
 }
@@ -5,12 +5,16 @@
 #pragma once
 #include <nitrocoro/http/HttpTypes.h>
 
+#include <nitrocoro/core/AsyncGenerator.h>
 #include <nitrocoro/core/Mutex.h>
 #include <nitrocoro/core/Task.h>
 #include <nitrocoro/io/Stream.h>
 #include <nitrocoro/utils/ExtendableBuffer.h>
+#include <nitrocoro/utils/IoBuffer.h>
 #include <nitrocoro/utils/StringBuffer.h>
 
+#include <string_view>
+
 namespace nitrocoro::http
 {
 
@@ -19,7 +23,7 @@ class BodyReader
 public:
     static std::shared_ptr<BodyReader> create(
         io::StreamPtr stream,
-        std::shared_ptr<utils::StringBuffer> buffer,
+        std::shared_ptr<utils::IoBuffer> buffer,
         TransferMode mode,
         size_t contentLength);
 
@@ -36,6 +40,11 @@ public:
     template <utils::ExtendableBuffer T>
     Task<size_t> readToEnd(T & buf);
 
+    // Streams the body in pieces of up to maxChunk bytes through one reused
+    // buffer, so memory stays flat however large the body is. Each view is
+    // valid until the next next(); the reader must outlive the generator.
+    AsyncGenerator<std::string_view> chunks(size_t maxChunk = 16 * 1024);
+
 protected:
     virtual Task<size_t> readImpl(char * buf, size_t len) = 0;
 
@@ -10,6 +10,8 @@
 
 #include <memory>
 #include <string_view>
+#include <sys/types.h>
+#include <sys/uio.h>
 
 namespace nitrocoro::http
 {
@@ -19,13 +21,25 @@ class BodyWriter
 public:
     virtual ~BodyWriter() = default;
 
-    virtual Task<> write(std::string_view data) = 0;
+    // @p head, when non-empty, is the header block not yet sent; it goes out in
+    // the same writev() as the body bytes and any framing.
+    virtual Task<> write(std::string_view data, std::string_view head = {}) = 0;
     virtual Task<> end() = 0;
+    // write(data, head) followed by end(), as one writev().
+    virtual Task<> end(std::string_view data, std::string_view head = {}) = 0;
+    // Body bytes taken from @p fd, sent with io::Stream::sendFile().
+    virtual Task<> sendFile(int fd, off_t offset, size_t len, std::string_view head = {}) = 0;
 
     static std::unique_ptr<BodyWriter> create(
         TransferMode mode,
         io::StreamPtr stream,
         size_t contentLength = 0);
+
+protected:
+    static iovec buffer(std::string_view data) noexcept
+    {
+        return { const_cast<char *>(data.data()), data.size() };
+    }
 };
 
 } // namespace nitrocoro::http
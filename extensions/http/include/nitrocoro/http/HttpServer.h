@@ -33,6 +33,9 @@ public:
 
     explicit HttpServer(uint16_t port, Scheduler * scheduler = Scheduler::current());
     explicit HttpServer(HttpServerConfig config, Scheduler * scheduler = Scheduler::current());
+    // Multi-loop: connections are accepted and served on every Scheduler of @p group.
+    HttpServer(uint16_t port, SchedulerGroup & group, Scheduler * scheduler = Scheduler::current());
+    HttpServer(HttpServerConfig config, SchedulerGroup & group, Scheduler * scheduler = Scheduler::current());
 
     uint16_t listeningPort() const { return port_; }
 
@@ -60,6 +63,7 @@ public:
     SharedFuture<> wait() const;
 
 private:
+    void init();
     Task<> handleConnection(net::TcpConnectionPtr conn);
 
     HttpServerConfig config_;
@@ -34,6 +34,13 @@ public:
         co_return co_await bodyReader_->readToEnd(buf);
     }
 
+    // Body as a stream of views; see BodyReader::chunks(). Prefer this to
+    // readToEnd() for large bodies. The stream must outlive the generator.
+    AsyncGenerator<std::string_view> chunks(size_t maxChunk = 16 * 1024)
+    {
+        return bodyReader_->chunks(maxChunk);
+    }
+
 protected:
     std::shared_ptr<BodyReader> bodyReader_;
 };
@@ -46,12 +46,19 @@ public:
     void setHeader(HttpHeader header);
     Task<> write(const char * data, size_t len);
     Task<> write(std::string_view data);
+    /**
+     * Writes @p len bytes of @p fd, starting at @p offset, as body data. On a
+     * plain TCP connection they go from the page cache to the socket with
+     * sendfile(2)/splice(2), never through user space.
+     */
+    Task<> sendFile(int fd, off_t offset, size_t len);
     Task<> end();
     Task<> end(std::string_view data);
 
 protected:
     static const char * getDefaultReason(uint16_t code);
     Task<> writeHeaders();
+    Task<std::string> takeHeaders();
     void buildHeaders(std::string & buf);
     void decideTransferMode(std::optional<size_t> lengthHint = std::nullopt);
 
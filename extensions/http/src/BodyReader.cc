@@ -8,6 +8,8 @@
 #include "body_reader/ContentLengthReader.h"
 #include "body_reader/UntilCloseReader.h"
 
+#include <string>
+
 namespace nitrocoro::http
 {
 
@@ -22,7 +24,7 @@ protected:
 
 std::shared_ptr<BodyReader> BodyReader::create(
     io::StreamPtr stream,
-    std::shared_ptr<utils::StringBuffer> buffer,
+    std::shared_ptr<utils::IoBuffer> buffer,
     TransferMode mode,
     size_t contentLength)
 {
@@ -51,6 +53,18 @@ Task<size_t> BodyReader::read(char * buf, size_t len)
     co_return co_await readImpl(buf, len);
 }
 
+AsyncGenerator<std::string_view> BodyReader::chunks(size_t maxChunk)
+{
+    std::string buf(maxChunk, '\0');
+    while (true)
+    {
+        size_t n = co_await read(buf.data(), buf.size());
+        if (n == 0)
+            co_return;
+        co_yield std::string_view(buf.data(), n);
+    }
+}
+
 Task<> BodyReader::drain()
 {
     [[maybe_unused]] auto lock = co_await mutex_.scoped_lock();
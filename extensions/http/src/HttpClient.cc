@@ -17,7 +17,7 @@
 namespace nitrocoro::http
 {
 
-static Task<HttpParseResult<HttpResponse>> parseNext(io::StreamPtr stream, std::shared_ptr<utils::StringBuffer> buffer)
+static Task<HttpParseResult<HttpResponse>> parseNext(io::StreamPtr stream, std::shared_ptr<utils::IoBuffer> buffer)
 {
     HttpParser<HttpResponse> parser;
 
@@ -26,15 +26,16 @@ static Task<HttpParseResult<HttpResponse>> parseNext(io::StreamPtr stream, std::
         size_t pos = buffer->find("\r\n");
         if (pos == std::string::npos)
         {
-            char * writePtr = buffer->prepareWrite(4096);
-            size_t n = co_await stream->read(writePtr, 4096);
+            iovec iov[2];
+            size_t count = buffer->prepareWritev(iov, 2, 4096);
+            size_t n = co_await stream->readv({ iov, count });
             if (n == 0)
                 co_return { {}, HttpParseError::ConnectionClosed, "Connection closed before headers complete" };
             buffer->commitWrite(n);
             continue;
         }
 
-        std::string_view line = buffer->view().substr(0, pos);
+        std::string_view line = buffer->pullup(pos);
         auto state = parser.parseLine(line);
         buffer->consume(pos + 2);
 
@@ -122,7 +123,7 @@ Task<HttpCompleteResponse> HttpClient::sendRequest(const HttpMethod & method, co
 
 Task<HttpCompleteResponse> HttpClient::readResponse(io::StreamPtr stream, bool ignoreContentLength)
 {
-    auto buffer = std::make_shared<utils::StringBuffer>();
+    auto buffer = std::make_shared<utils::IoBuffer>();
     auto result = co_await parseNext(stream, buffer);
     if (result.error())
         throw std::runtime_error(result.errorMessage);
@@ -174,7 +175,7 @@ Task<HttpClientSession> HttpClient::stream(const HttpMethod & method, const std:
     Scheduler::current()->spawn([anyStream, promise = std::move(promise)]() mutable -> Task<> {
         try
         {
-            auto buffer = std::make_shared<utils::StringBuffer>();
+            auto buffer = std::make_shared<utils::IoBuffer>();
             auto result = co_await parseNext(anyStream, buffer);
             if (result.error())
             {
@@ -8,10 +8,34 @@
 
 #include <ctime>
 #include <optional>
+#include <string_view>
 
 namespace nitrocoro::http
 {
 
+// IMF-fixdate of the current second. One Scheduler runs per thread, so the
+// thread-local copy is per-loop and reformatted at most once a second.
+static std::string_view cachedDateHeader()
+{
+    thread_local std::time_t cachedSecond = -1;
+    thread_local char dateBuf[32];
+    thread_local size_t dateLen = 0;
+
+    std::time_t now = std::time(nullptr);
+    if (now != cachedSecond)
+    {
+        std::tm tm{};
+#ifdef _WIN32
+        gmtime_s(&tm, &now);
+#else
+        gmtime_r(&now, &tm);
+#endif
+        dateLen = std::strftime(dateBuf, sizeof(dateBuf), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+        cachedSecond = now;
+    }
+    return { dateBuf, dateLen };
+}
+
 static const char * toVersionString(Version version)
 {
     switch (version)
@@ -154,16 +178,7 @@ void HttpOutgoingStreamBase<DataType>::buildHeaders(std::string & buf)
 
         if (sendDateHeader_ && data_.headers.find(HttpHeader::Name::Date_L) == data_.headers.end())
         {
-            char dateBuf[32];
-            std::time_t now = std::time(nullptr);
-            std::tm tm{};
-#ifdef _WIN32
-            gmtime_s(&tm, &now);
-#else
-            gmtime_r(&now, &tm);
-#endif
-            std::strftime(dateBuf, sizeof(dateBuf), "%a, %d %b %Y %H:%M:%S GMT", &tm);
-            buf.append("Date: ").append(dateBuf).append("\r\n");
+            buf.append("Date: ").append(cachedDateHeader()).append("\r\n");
         }
 
         if (data_.headers.find(HttpHeader::Name::Connection_L) == data_.headers.end())
@@ -192,10 +207,11 @@ Task<> HttpOutgoingStreamBase<DataType>::write(const char * data, size_t len)
     if (!bodyWriter_)
         decideTransferMode();
 
+    std::string head;
     if (!headersSent_)
-        co_await writeHeaders();
+        head = co_await takeHeaders();
 
-    co_await bodyWriter_->write(std::string_view(data, len));
+    co_await bodyWriter_->write(std::string_view(data, len), head);
 }
 
 template <typename DataType>
@@ -204,6 +220,25 @@ Task<> HttpOutgoingStreamBase<DataType>::write(std::string_view data)
     co_await write(data.data(), data.size());
 }
 
+template <typename DataType>
+Task<> HttpOutgoingStreamBase<DataType>::sendFile(int fd, off_t offset, size_t len)
+{
+    bodyLength_ += len;
+    if (ignoreBody_)
+    {
+        co_return;
+    }
+
+    if (!bodyWriter_)
+        decideTransferMode();
+
+    std::string head;
+    if (!headersSent_)
+        head = co_await takeHeaders();
+
+    co_await bodyWriter_->sendFile(fd, offset, len, head);
+}
+
 template <typename DataType>
 Task<> HttpOutgoingStreamBase<DataType>::end()
 {
@@ -223,8 +258,6 @@ Task<> HttpOutgoingStreamBase<DataType>::end()
 template <typename DataType>
 Task<> HttpOutgoingStreamBase<DataType>::end(std::string_view data)
 {
-    constexpr size_t kMaxMergedBodySize = 32 * 1024; // 32KB
-
     bodyLength_ += data.size();
     if (ignoreBody_)
     {
@@ -241,36 +274,30 @@ Task<> HttpOutgoingStreamBase<DataType>::end(std::string_view data)
     if (!bodyWriter_)
         decideTransferMode(data.size());
 
+    // Header block, body and framing leave in one writev(), without copying the body.
+    std::string head;
     if (!headersSent_)
-    {
-        // Optimization: merge headers and body for small responses to reduce syscalls
-        if (transferMode_ == TransferMode::ContentLength && data.size() <= kMaxMergedBodySize)
-        {
-            headersSent_ = true;
-            if (prevFuture_)
-                co_await prevFuture_->get();
-            std::string response;
-            response.reserve(256 + data.size());
-            buildHeaders(response);
-            response.append("\r\n").append(data);
-            co_await stream_->write(response.c_str(), response.size());
-            finishedPromise_.set_value();
-            co_return;
-        }
-
-        co_await writeHeaders();
-    }
+        head = co_await takeHeaders();
 
-    co_await bodyWriter_->write(data);
-    co_await bodyWriter_->end();
+    co_await bodyWriter_->end(data, head);
     finishedPromise_.set_value();
 }
 
 template <typename DataType>
 Task<> HttpOutgoingStreamBase<DataType>::writeHeaders()
+{
+    std::string headers = co_await takeHeaders();
+    if (!headers.empty())
+        co_await stream_->write(headers.c_str(), headers.size());
+}
+
+// Marks the headers sent and returns the block to put on the wire, once the
+// previous message on this connection has finished; empty if already taken.
+template <typename DataType>
+Task<std::string> HttpOutgoingStreamBase<DataType>::takeHeaders()
 {
     if (headersSent_)
-        co_return;
+        co_return std::string();
     headersSent_ = true;
 
     if (prevFuture_)
@@ -280,7 +307,7 @@ Task<> HttpOutgoingStreamBase<DataType>::writeHeaders()
     headers.reserve(256);
     buildHeaders(headers);
     headers.append("\r\n");
-    co_await stream_->write(headers.c_str(), headers.size());
+    co_return headers;
 }
 
 // TODO: move to http helpers
@@ -38,7 +38,7 @@ static bool isUpgradeRequest(const HttpIncomingStream<HttpRequest> & request)
     return true;
 }
 
-static Task<HttpParseResult<HttpRequest>> parseNext(io::StreamPtr stream, std::shared_ptr<utils::StringBuffer> buffer)
+static Task<HttpParseResult<HttpRequest>> parseNext(io::StreamPtr stream, std::shared_ptr<utils::IoBuffer> buffer)
 {
     HttpParser<HttpRequest> parser;
     int lines = 0;
@@ -54,8 +54,9 @@ static Task<HttpParseResult<HttpRequest>> parseNext(io::StreamPtr stream, std::s
                 co_return { {}, HttpParseError::MalformedRequestLine, "Header line too long" };
             }
 
-            char * writePtr = buffer->prepareWrite(4096);
-            size_t n = co_await stream->read(writePtr, 4096);
+            iovec iov[2];
+            size_t count = buffer->prepareWritev(iov, 2, 4096);
+            size_t n = co_await stream->readv({ iov, count });
             if (n == 0)
             {
                 // TODO: should not use parser error
@@ -70,7 +71,7 @@ static Task<HttpParseResult<HttpRequest>> parseNext(io::StreamPtr stream, std::s
             // TODO: should not use parser error
             co_return { {}, HttpParseError::MalformedRequestLine, "Too many headers" };
         }
-        std::string_view line = buffer->view().substr(0, pos);
+        std::string_view line = buffer->pullup(pos);
         auto state = parser.parseLine(line);
         buffer->consume(pos + 2);
 
@@ -94,6 +95,26 @@ HttpServer::HttpServer(HttpServerConfig config, Scheduler * scheduler)
     , port_(config_.port)
     , router_(config_.router)
     , server_(std::make_unique<net::TcpServer>(port_, scheduler_))
+{
+    init();
+}
+
+HttpServer::HttpServer(uint16_t port, SchedulerGroup & group, Scheduler * scheduler)
+    : HttpServer(HttpServerConfig(port), group, scheduler)
+{
+}
+
+HttpServer::HttpServer(HttpServerConfig config, SchedulerGroup & group, Scheduler * scheduler)
+    : config_(std::move(config))
+    , scheduler_(scheduler ? scheduler : group.at(0))
+    , port_(config_.port)
+    , router_(config_.router)
+    , server_(std::make_unique<net::TcpServer>(port_, group, scheduler_))
+{
+    init();
+}
+
+void HttpServer::init()
 {
     if (!config_.router)
     {
@@ -166,15 +187,34 @@ Task<> HttpServer::handleConnection(net::TcpConnectionPtr conn)
         stream = std::make_shared<io::Stream>(conn);
     }
 
-    auto buffer = std::make_shared<utils::StringBuffer>();
+    auto buffer = std::make_shared<utils::IoBuffer>();
     std::optional<Future<>> prevFuture;
     while (true)
     {
+        if (!buffer->hasRemaining())
+        {
+            // The next request may already be here: read it into the block still
+            // held. Only a connection with nothing pending gives its blocks back.
+            std::optional<size_t> got;
+            if (buffer->blockCount() > 0)
+            {
+                iovec iov[2];
+                size_t count = buffer->prepareWritev(iov, 2, 4096);
+                got = stream->tryReadv({ iov, count });
+                if (got && *got > 0)
+                    buffer->commitWrite(*got);
+            }
+            if (!got)
+            {
+                buffer->shrink();
+                co_await stream->waitReadable();
+            }
+        }
         auto parsed = co_await parseNext(stream, buffer);
         if (parsed.error())
         {
             NITRO_DEBUG("Bad request: %s", parsed.errorMessage.c_str());
-            Promise<> p(scheduler_);
+            Promise<> p(Scheduler::current());
             HttpOutgoingStream<HttpResponse> errResp(stream, std::move(p), std::move(prevFuture), false, config_.send_date_header);
             errResp.setStatus(StatusCode::k400BadRequest);
             errResp.setCloseConnection(true);
@@ -191,7 +231,7 @@ Task<> HttpServer::handleConnection(net::TcpConnectionPtr conn)
         auto request = HttpIncomingStream<HttpRequest>(std::move(parsed.message), bodyReader);
 
         auto method = request.method();
-        Promise<> finishedPromise(scheduler_);
+        Promise<> finishedPromise(Scheduler::current());
         auto finishedFuture = finishedPromise.get_future();
         bool ignoreBody = (method == methods::Head);
         HttpOutgoingStream<HttpResponse> response(stream, std::move(finishedPromise), std::move(prevFuture), ignoreBody, config_.send_date_header);
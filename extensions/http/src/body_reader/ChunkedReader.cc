@@ -3,7 +3,7 @@
  * @brief Implementation of ChunkedReader
  */
 #include "ChunkedReader.h"
-#include <cstring>
+#include <algorithm>
 
 namespace nitrocoro::http
 {
@@ -31,7 +31,7 @@ Task<bool> ChunkedReader::parseChunkSize()
         if (pos > MAX_CHUNK_SIZE_LINE)
             throw std::runtime_error("Invalid chunked encoding: chunk size line too long");
 
-        std::string_view line = buffer_->view().substr(0, pos);
+        std::string_view line = buffer_->pullup(pos);
         currentChunkSize_ = std::stoul(std::string(line), nullptr, 16);
         buffer_->consume(pos + 2);
         currentChunkRead_ = 0;
@@ -110,8 +110,7 @@ Task<size_t> ChunkedReader::readImpl(char * buf, size_t len)
     if (available > 0)
     {
         size_t toRead = std::min({ available, remaining, len });
-        std::memcpy(buf, buffer_->view().data(), toRead);
-        buffer_->consume(toRead);
+        buffer_->read(buf, toRead);
         currentChunkRead_ += toRead;
 
         if (currentChunkRead_ >= currentChunkSize_)
@@ -12,7 +12,7 @@ namespace nitrocoro::http
 class ChunkedReader : public BodyReader
 {
 public:
-    ChunkedReader(io::StreamPtr stream, std::shared_ptr<utils::StringBuffer> buffer)
+    ChunkedReader(io::StreamPtr stream, std::shared_ptr<utils::IoBuffer> buffer)
         : stream_(std::move(stream)), buffer_(std::move(buffer)) {}
 
     Task<size_t> readImpl(char * buf, size_t len) override;
@@ -27,7 +27,7 @@ private:
     };
 
     io::StreamPtr stream_;
-    std::shared_ptr<utils::StringBuffer> buffer_;
+    std::shared_ptr<utils::IoBuffer> buffer_;
     State state_ = State::ReadSize;
     size_t currentChunkSize_ = 0;
     size_t currentChunkRead_ = 0;
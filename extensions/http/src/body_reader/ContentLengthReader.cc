@@ -3,7 +3,7 @@
  * @brief Implementation of ContentLengthReader
  */
 #include "ContentLengthReader.h"
-#include <cstring>
+#include <algorithm>
 
 namespace nitrocoro::http
 {
@@ -17,8 +17,7 @@ Task<size_t> ContentLengthReader::readImpl(char * buf, size_t len)
     if (available > 0)
     {
         size_t toRead = std::min({ len, available, contentLength_ - bytesRead_ });
-        std::memcpy(buf, buffer_->view().data(), toRead);
-        buffer_->consume(toRead);
+        buffer_->read(buf, toRead);
         bytesRead_ += toRead;
         co_return toRead;
     }
@@ -12,7 +12,7 @@ namespace nitrocoro::http
 class ContentLengthReader : public BodyReader
 {
 public:
-    ContentLengthReader(io::StreamPtr stream, std::shared_ptr<utils::StringBuffer> buffer, size_t contentLength)
+    ContentLengthReader(io::StreamPtr stream, std::shared_ptr<utils::IoBuffer> buffer, size_t contentLength)
         : stream_(std::move(stream)), buffer_(std::move(buffer)), contentLength_(contentLength) {}
 
     Task<size_t> readImpl(char * buf, size_t len) override;
@@ -20,7 +20,7 @@ public:
 
 private:
     io::StreamPtr stream_;
-    std::shared_ptr<utils::StringBuffer> buffer_;
+    std::shared_ptr<utils::IoBuffer> buffer_;
     const size_t contentLength_;
     size_t bytesRead_ = 0;
 };
@@ -3,7 +3,7 @@
  * @brief Implementation of UntilCloseReader
  */
 #include "UntilCloseReader.h"
-#include <cstring>
+#include <algorithm>
 
 namespace nitrocoro::http
 {
@@ -17,8 +17,7 @@ Task<size_t> UntilCloseReader::readImpl(char * buf, size_t len)
     if (available > 0)
     {
         size_t toRead = std::min(len, available);
-        std::memcpy(buf, buffer_->view().data(), toRead);
-        buffer_->consume(toRead);
+        buffer_->read(buf, toRead);
         co_return toRead;
     }
 
@@ -12,7 +12,7 @@ namespace nitrocoro::http
 class UntilCloseReader : public BodyReader
 {
 public:
-    UntilCloseReader(io::StreamPtr stream, std::shared_ptr<utils::StringBuffer> buffer)
+    UntilCloseReader(io::StreamPtr stream, std::shared_ptr<utils::IoBuffer> buffer)
         : stream_(std::move(stream)), buffer_(std::move(buffer)) {}
 
     Task<size_t> readImpl(char * buf, size_t len) override;
@@ -20,7 +20,7 @@ public:
 
 private:
     io::StreamPtr stream_;
-    std::shared_ptr<utils::StringBuffer> buffer_;
+    std::shared_ptr<utils::IoBuffer> buffer_;
     bool complete_ = false;
 };
 
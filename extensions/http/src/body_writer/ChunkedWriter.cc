@@ -8,18 +8,40 @@
 namespace nitrocoro::http
 {
 
-Task<> ChunkedWriter::write(std::string_view data)
+// Chunk framing goes in its own iovecs, so the payload is never copied.
+Task<> ChunkedWriter::write(std::string_view data, std::string_view head)
 {
     if (data.empty())
+    {
+        if (!head.empty())
+            co_await stream_->write(head.data(), head.size());
         co_return;
+    }
 
     char sizeBuf[16];
     int sizeLen = std::snprintf(sizeBuf, sizeof(sizeBuf), "%zx\r\n", data.size());
 
-    std::string chunk;
-    chunk.reserve(sizeLen + data.size() + 2);
-    chunk.append(sizeBuf, sizeLen).append(data).append("\r\n", 2);
-    co_await stream_->write(chunk.c_str(), chunk.size());
+    iovec iov[] = { buffer(head), buffer({ sizeBuf, static_cast<size_t>(sizeLen) }), buffer(data), buffer("\r\n") };
+    co_await stream_->writev(iov);
+}
+
+// The whole file is one chunk, so the payload still goes out without a copy.
+Task<> ChunkedWriter::sendFile(int fd, off_t offset, size_t len, std::string_view head)
+{
+    if (len == 0)
+    {
+        if (!head.empty())
+            co_await stream_->write(head.data(), head.size());
+        co_return;
+    }
+
+    char sizeBuf[16];
+    int sizeLen = std::snprintf(sizeBuf, sizeof(sizeBuf), "%zx\r\n", len);
+
+    iovec iov[] = { buffer(head), buffer({ sizeBuf, static_cast<size_t>(sizeLen) }) };
+    co_await stream_->writev(iov);
+    co_await stream_->sendFile(fd, offset, len);
+    co_await stream_->write("\r\n", 2);
 }
 
 Task<> ChunkedWriter::end()
@@ -27,4 +49,20 @@ Task<> ChunkedWriter::end()
     co_await stream_->write("0\r\n\r\n", 5);
 }
 
+Task<> ChunkedWriter::end(std::string_view data, std::string_view head)
+{
+    if (data.empty())
+    {
+        iovec iov[] = { buffer(head), buffer("0\r\n\r\n") };
+        co_await stream_->writev(iov);
+        co_return;
+    }
+
+    char sizeBuf[16];
+    int sizeLen = std::snprintf(sizeBuf, sizeof(sizeBuf), "%zx\r\n", data.size());
+
+    iovec iov[] = { buffer(head), buffer({ sizeBuf, static_cast<size_t>(sizeLen) }), buffer(data), buffer("\r\n0\r\n\r\n") };
+    co_await stream_->writev(iov);
+}
+
 } // namespace nitrocoro::http
@@ -7,15 +7,36 @@
 namespace nitrocoro::http
 {
 
-Task<> ContentLengthWriter::write(std::string_view data)
+Task<> ContentLengthWriter::write(std::string_view data, std::string_view head)
 {
-    co_await stream_->write(data.data(), data.size());
+    if (head.empty())
+    {
+        co_await stream_->write(data.data(), data.size());
+    }
+    else
+    {
+        iovec iov[] = { buffer(head), buffer(data) };
+        co_await stream_->writev(iov);
+    }
     bytesWritten_ += data.size();
 }
 
+Task<> ContentLengthWriter::sendFile(int fd, off_t offset, size_t len, std::string_view head)
+{
+    if (!head.empty())
+        co_await stream_->write(head.data(), head.size());
+    co_await stream_->sendFile(fd, offset, len);
+    bytesWritten_ += len;
+}
+
 Task<> ContentLengthWriter::end()
 {
     co_return;
 }
 
+Task<> ContentLengthWriter::end(std::string_view data, std::string_view head)
+{
+    co_await write(data, head);
+}
+
 } // namespace nitrocoro::http
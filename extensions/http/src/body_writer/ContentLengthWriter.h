@@ -15,8 +15,10 @@ public:
     ContentLengthWriter(io::StreamPtr stream, size_t contentLength)
         : stream_(std::move(stream)), contentLength_(contentLength) {}
 
-    Task<> write(std::string_view data) override;
+    Task<> write(std::string_view data, std::string_view head) override;
     Task<> end() override;
+    Task<> end(std::string_view data, std::string_view head) override;
+    Task<> sendFile(int fd, off_t offset, size_t len, std::string_view head) override;
 
 private:
     io::StreamPtr stream_;
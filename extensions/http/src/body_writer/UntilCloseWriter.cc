@@ -7,9 +7,24 @@
 namespace nitrocoro::http
 {
 
-Task<> UntilCloseWriter::write(std::string_view data)
+Task<> UntilCloseWriter::write(std::string_view data, std::string_view head)
 {
-    co_await stream_->write(data.data(), data.size());
+    if (head.empty())
+    {
+        co_await stream_->write(data.data(), data.size());
+    }
+    else
+    {
+        iovec iov[] = { buffer(head), buffer(data) };
+        co_await stream_->writev(iov);
+    }
+}
+
+Task<> UntilCloseWriter::sendFile(int fd, off_t offset, size_t len, std::string_view head)
+{
+    if (!head.empty())
+        co_await stream_->write(head.data(), head.size());
+    co_await stream_->sendFile(fd, offset, len);
 }
 
 Task<> UntilCloseWriter::end()
@@ -17,4 +32,9 @@ Task<> UntilCloseWriter::end()
     co_return;
 }
 
+Task<> UntilCloseWriter::end(std::string_view data, std::string_view head)
+{
+    co_await write(data, head);
+}
+
 } // namespace nitrocoro::http
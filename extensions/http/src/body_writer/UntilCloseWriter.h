@@ -15,8 +15,10 @@ public:
     explicit UntilCloseWriter(io::StreamPtr stream)
         : stream_(std::move(stream)) {}
 
-    Task<> write(std::string_view data) override;
+    Task<> write(std::string_view data, std::string_view head) override;
     Task<> end() override;
+    Task<> end(std::string_view data, std::string_view head) override;
+    Task<> sendFile(int fd, off_t offset, size_t len, std::string_view head) override;
 
 private:
     io::StreamPtr stream_;
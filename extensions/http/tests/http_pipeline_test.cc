@@ -6,9 +6,11 @@
 #include <nitrocoro/net/InetAddress.h>
 #include <nitrocoro/net/TcpConnection.h>
 #include <nitrocoro/testing/Test.h>
+#include <nitrocoro/utils/BufferPool.h>
 
 using namespace nitrocoro;
 using namespace nitrocoro::http;
+using namespace std::chrono_literals;
 
 static SharedFuture<> start_server(HttpServer & server)
 {
@@ -198,6 +200,48 @@ NITRO_TEST(http_pipeline_chunked_with_trailer)
     co_await server.stop();
 }
 
+/** Requests spanning several buffer blocks; an idle keep-alive connection then holds none. */
+NITRO_TEST(http_pipeline_idle_releases_buffer)
+{
+    HttpServer server(0);
+    server.route("/echo", { "GET" }, [](auto && req, auto && resp) -> Task<> {
+        co_await resp.end(req.getQuery("v"));
+    });
+    co_await start_server(server);
+    co_await sleep(10ms); // let connections from earlier tests wind down
+    int64_t baseline = utils::bufferPoolStats().inUse;
+
+    auto conn = co_await net::TcpConnection::connect(
+        net::InetAddress("127.0.0.1", server.listeningPort()));
+
+    // ~40KB of pipelined requests, so lines straddle pooled blocks
+    constexpr int N = 100;
+    std::string padding(300, 'p');
+    std::string reqs;
+    for (int i = 0; i < N; ++i)
+        reqs += "GET /echo?v=" + std::to_string(i) + " HTTP/1.1\r\nHost: 127.0.0.1\r\nX-Pad: " + padding + "\r\n\r\n";
+    co_await conn->write(reqs.data(), reqs.size());
+
+    std::string buf;
+    for (int i = 0; i < N; ++i)
+    {
+        auto [h, b] = co_await readResponse(conn, buf);
+        NITRO_CHECK(h.find("200 OK") != std::string::npos);
+        NITRO_CHECK_EQ(b, std::to_string(i));
+    }
+
+    co_await sleep(10ms);
+    NITRO_CHECK_EQ(utils::bufferPoolStats().inUse, baseline);
+
+    // The connection picks up again after idling
+    std::string again = "GET /echo?v=again HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+    co_await conn->write(again.data(), again.size());
+    auto [h, b] = co_await readResponse(conn, buf);
+    NITRO_CHECK_EQ(b, "again");
+
+    co_await server.stop();
+}
+
 int main(int argc, char ** argv)
 {
     return nitrocoro::test::run_all(argc, argv);
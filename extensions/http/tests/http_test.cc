@@ -9,6 +9,7 @@
 #include <nitrocoro/net/TcpConnection.h>
 #include <nitrocoro/testing/Test.h>
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
@@ -43,6 +44,34 @@ NITRO_TEST(http_get_hello)
     co_await server.stop();
 }
 
+/** A response body above the connection's zero-copy threshold arrives intact. */
+NITRO_TEST(http_zero_copy_body)
+{
+    std::string body(2 * 1024 * 1024 + 3, '\0');
+    for (size_t i = 0; i < body.size(); ++i)
+        body[i] = static_cast<char>('a' + i % 26);
+
+    bool zeroCopy = false;
+    HttpServer server(0);
+    server.setStreamUpgrader([&zeroCopy](net::TcpConnectionPtr conn) -> Task<io::StreamPtr> {
+        zeroCopy = conn->setZeroCopyThreshold(64 * 1024);
+        co_return std::make_shared<io::Stream>(conn);
+    });
+    server.route("/big", { "GET" }, [&body](auto && req, auto && resp) -> Task<> {
+        co_await resp.end(body);
+    });
+    co_await start_server(server);
+
+    HttpClient client;
+    auto resp = co_await client.get("http://127.0.0.1:" + std::to_string(server.listeningPort()) + "/big");
+    if (!zeroCopy)
+        NITRO_INFO("SO_ZEROCOPY unsupported here, body was copied");
+    NITRO_CHECK_EQ(resp.statusCode(), StatusCode::k200OK);
+    NITRO_CHECK(resp.body() == body);
+
+    co_await server.stop();
+}
+
 /** POST route reads request body and echoes it back. */
 NITRO_TEST(http_post_echo)
 {
@@ -62,6 +91,43 @@ NITRO_TEST(http_post_echo)
     co_await server.stop();
 }
 
+/** A large request body is consumed chunk by chunk through one bounded buffer. */
+NITRO_TEST(http_body_chunks)
+{
+    HttpServer server(0);
+    server.route("/count", { "POST" }, [](auto && req, auto && resp) -> Task<> {
+        size_t total = 0;
+        size_t largest = 0;
+        unsigned checksum = 0;
+        auto body = req.chunks(4096);
+        while (auto chunk = co_await body.next())
+        {
+            total += chunk->size();
+            largest = std::max(largest, chunk->size());
+            for (char c : *chunk)
+                checksum = checksum * 31 + static_cast<unsigned char>(c);
+        }
+        co_await resp.end(std::to_string(total) + " " + std::to_string(largest) + " " + std::to_string(checksum));
+    });
+    co_await start_server(server);
+
+    std::string payload(1 << 20, '\0');
+    unsigned checksum = 0;
+    for (size_t i = 0; i < payload.size(); ++i)
+    {
+        payload[i] = static_cast<char>('a' + i % 26);
+        checksum = checksum * 31 + static_cast<unsigned char>(payload[i]);
+    }
+
+    HttpClient client;
+    auto resp = co_await client.post(
+        "http://127.0.0.1:" + std::to_string(server.listeningPort()) + "/count", payload);
+    NITRO_CHECK_EQ(resp.statusCode(), StatusCode::k200OK);
+    NITRO_CHECK_EQ(resp.body(), std::to_string(payload.size()) + " 4096 " + std::to_string(checksum));
+
+    co_await server.stop();
+}
+
 /** Unregistered route returns 404. */
 NITRO_TEST(http_404)
 {
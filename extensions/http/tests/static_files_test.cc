@@ -562,6 +562,29 @@ NITRO_TEST(static_files_cache_disabled)
     co_await server.stop();
 }
 
+/** Files beyond the cache limit go out via sendFile(); the body arrives intact. */
+NITRO_TEST(static_files_large_file)
+{
+    TempDir dir;
+    std::string content(3 * 1024 * 1024 + 17, '\0');
+    for (size_t i = 0; i < content.size(); ++i)
+        content[i] = static_cast<char>('a' + i % 26);
+    dir.write("big.bin", content);
+
+    HttpServer server(0);
+    server.route("/*path", { "GET" }, staticFiles(dir.path.string()));
+    co_await start_server(server);
+
+    HttpClient client;
+    auto resp = co_await client.get(
+        "http://127.0.0.1:" + std::to_string(server.listeningPort()) + "/big.bin");
+    NITRO_CHECK_EQ(resp.statusCode(), StatusCode::k200OK);
+    NITRO_CHECK_EQ(resp.body().size(), content.size());
+    NITRO_CHECK(resp.body() == content);
+
+    co_await server.stop();
+}
+
 int main(int argc, char ** argv)
 {
     return nitrocoro::test::run_all(argc, argv);
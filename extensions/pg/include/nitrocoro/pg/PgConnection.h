@@ -4,6 +4,7 @@
  */
 #pragma once
 
+#include <nitrocoro/core/AsyncGenerator.h>
 #include <nitrocoro/core/CancelToken.h>
 #include <nitrocoro/core/Scheduler.h>
 #include <nitrocoro/core/Task.h>
@@ -43,10 +44,17 @@ public:
     virtual Task<PgResult> query(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken) = 0;
     virtual Task<> execute(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken) = 0;
 
+    // Streams the rows of a query one at a time (libpq single-row mode) instead of
+    // materializing the whole result, for results too large to hold in memory.
+    // The connection is busy until the generator finishes; destroying it early,
+    // or cancelling, discards the connection.
+    virtual AsyncGenerator<PgRow> queryRows(std::string sql, std::vector<PgValue> params, CancelToken cancelToken) = 0;
+
     Task<PgResult> query(std::string_view sql, std::vector<PgValue> params);
     Task<PgResult> query(std::string_view sql, CancelToken cancelToken = CancelToken());
     Task<> execute(std::string_view sql, std::vector<PgValue> params);
     Task<> execute(std::string_view sql, CancelToken cancelToken = CancelToken());
+    AsyncGenerator<PgRow> queryRows(std::string sql, CancelToken cancelToken = CancelToken());
 
 protected:
     PgConnection() = default;
@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -35,4 +36,21 @@ private:
     size_t cols_ = 0;
 };
 
+/** One row of a streamed result, see PgConnection::queryRows(). */
+class PgRow
+{
+public:
+    PgRow() = default;
+    explicit PgRow(PgResult result)
+        : result_(std::move(result)) {}
+
+    size_t colCount() const { return result_.colCount(); }
+    const char * colName(size_t col) const { return result_.colName(col); }
+
+    PgValue get(size_t col) const { return result_.get(0, col); }
+
+private:
+    PgResult result_;
+};
+
 } // namespace nitrocoro::pg
@@ -31,10 +31,12 @@ public:
 
     Task<PgResult> query(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken) override;
     Task<> execute(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken) override;
+    AsyncGenerator<PgRow> queryRows(std::string sql, std::vector<PgValue> params, CancelToken cancelToken) override;
 
     // bypass name hiding
     using PgConnection::execute;
     using PgConnection::query;
+    using PgConnection::queryRows;
 
     Task<> commit();
     Task<> rollback();
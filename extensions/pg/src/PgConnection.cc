@@ -39,4 +39,9 @@ Task<> PgConnection::execute(std::string_view sql, CancelToken cancelToken)
     co_await execute(sql, std::vector<PgValue>(), cancelToken);
 }
 
+AsyncGenerator<PgRow> PgConnection::queryRows(std::string sql, CancelToken cancelToken)
+{
+    return queryRows(std::move(sql), std::vector<PgValue>(), std::move(cancelToken));
+}
+
 } // namespace nitrocoro::pg
@@ -6,6 +6,7 @@
 
 #include "PgResultWrapper.h"
 #include <nitrocoro/core/CancelToken.h>
+#include <nitrocoro/core/Event.h>
 #include <nitrocoro/pg/PgConfig.h>
 #include <nitrocoro/pg/PgException.h>
 #include <nitrocoro/utils/Debug.h>
@@ -25,6 +26,10 @@ struct PgConnectionImpl::ConnectionContext
     std::unique_ptr<io::Channel> channel;
     bool broken{ false };
     std::weak_ptr<ResultPromise> weakPromise;
+    // Set while queryRows() pulls results itself; readLoop then only consumes
+    // input and signals inputReady.
+    bool streaming{ false };
+    Event inputReady;
     std::function<void(std::string, std::string, int)> notifyHandler;
     std::function<void()> brokenHandler;
 
@@ -35,6 +40,7 @@ struct PgConnectionImpl::ConnectionContext
         broken = true;
         channel->cancelAll();
         channel->disableAll();
+        inputReady.set();
         if (brokenHandler)
             brokenHandler();
     }
@@ -217,10 +223,10 @@ Task<std::unique_ptr<PgConnectionImpl>> PgConnectionImpl::connect(std::string co
     NITRO_TRACE("PgConnection: connected (fd=%d)", PQsocket(pgConn->raw));
     if (PQsetnonblocking(pgConn->raw, 1) != 0)
         throw PgConnectionError("PQsetnonblocking: " + std::string(PQerrorMessage(pgConn->raw)));
-    co_return std::make_unique<PgConnectionImpl>(std::make_shared<ConnectionContext>(ConnectionContext{
-        .pgConn = std::move(pgConn),
-        .channel = std::move(channel),
-    }));
+    auto ctx = std::make_shared<ConnectionContext>();
+    ctx->pgConn = std::move(pgConn);
+    ctx->channel = std::move(channel);
+    co_return std::make_unique<PgConnectionImpl>(std::move(ctx));
 }
 
 struct PGnotifyDeleter
@@ -242,6 +248,14 @@ Task<> PgConnectionImpl::readLoop(std::shared_ptr<ConnectionContext> ctx)
                     ctx->notifyHandler({ n->relname }, { n->extra }, n->be_pid);
             }
 
+            if (ctx->streaming)
+            {
+                ctx->inputReady.set();
+                if (PQstatus(ctx->pgConn->raw) != CONNECTION_OK)
+                    return Channel::IoStatus::Error;
+                return Channel::IoStatus::NeedRead;
+            }
+
             if (PQisBusy(ctx->pgConn->raw))
                 return Channel::IoStatus::NeedRead;
 
@@ -348,6 +362,43 @@ Task<PgResult> PgConnectionImpl::sendAndReceive(std::string_view sql, std::vecto
         ch->cancelAll();
     });
 
+    auto resultPromise = std::make_shared<ConnectionContext::ResultPromise>();
+    ctx_->weakPromise = resultPromise;
+
+    co_await sendQuery(sql, params, false);
+
+    if (cancelToken.isCancelled())
+    {
+        ctx_->handleBroken();
+        throw PgCancelledError("PgConnection: query canceled (read)");
+    }
+
+    auto res = co_await resultPromise->get_future().get();
+    reg.unregister(); // prevent cancel
+    resultPromise.reset();
+
+    if (!res)
+    {
+        ctx_->handleBroken();
+        throw PgConnectionError("PgConnection: no result returned");
+    }
+
+    ExecStatusType status = PQresultStatus(res->raw);
+    if (status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK)
+    {
+        std::string err = PQresultErrorMessage(res->raw);
+        const char * sqlstate = PQresultErrorField(res->raw, PG_DIAG_SQLSTATE);
+        NITRO_TRACE("PGresult sqlstate=%s, err: %s", sqlstate ? sqlstate : "N/A", err.c_str());
+        throw PgQueryError("PgConnection query error: " + err, sqlstate ? sqlstate : "");
+    }
+
+    co_return PgResult(std::move(res));
+}
+
+// Sends the query and flushes it to the server; results are read by readLoop,
+// or by queryRows() when @p singleRowMode is set.
+Task<> PgConnectionImpl::sendQuery(std::string_view sql, const std::vector<PgValue> & params, bool singleRowMode)
+{
     std::vector<std::string> strBuffers;
     std::vector<const char *> paramValues;
     std::vector<int> paramLengths;
@@ -404,9 +455,6 @@ Task<PgResult> PgConnectionImpl::sendAndReceive(std::string_view sql, std::vecto
             v);
     }
 
-    auto resultPromise = std::make_shared<ConnectionContext::ResultPromise>();
-    ctx_->weakPromise = resultPromise;
-
     std::string sqlStr(sql);
     int ok = PQsendQueryParams(ctx_->pgConn->raw,
                                sqlStr.c_str(),
@@ -421,6 +469,11 @@ Task<PgResult> PgConnectionImpl::sendAndReceive(std::string_view sql, std::vecto
         ctx_->handleBroken();
         throw PgConnectionError(std::string("PQsendQueryParams: ") + PQerrorMessage(ctx_->pgConn->raw));
     }
+    if (singleRowMode && !PQsetSingleRowMode(ctx_->pgConn->raw))
+    {
+        ctx_->handleBroken();
+        throw PgConnectionError("PQsetSingleRowMode failed");
+    }
 
     auto flushResult = co_await ctx_->channel->performWrite([&](int, Channel * c) -> Channel::IoStatus {
         int r = PQflush(ctx_->pgConn->raw);
@@ -446,43 +499,81 @@ Task<PgResult> PgConnectionImpl::sendAndReceive(std::string_view sql, std::vecto
         ctx_->handleBroken();
         throw PgCancelledError("PgConnection: query canceled (flush)");
     }
+}
+
+Task<PgResult> PgConnectionImpl::query(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken)
+{
+    co_return co_await sendAndReceive(sql, std::move(params), cancelToken);
+}
 
+Task<> PgConnectionImpl::execute(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken)
+{
+    co_await sendAndReceive(sql, std::move(params), cancelToken);
+}
+
+AsyncGenerator<PgRow> PgConnectionImpl::queryRows(std::string sql, std::vector<PgValue> params, CancelToken cancelToken)
+{
+    if (!ctx_->pgConn)
+        throw PgConnectionError("PgConnection: operation on empty connection");
+
+    co_await ctx_->channel->scheduler()->switch_to();
     if (cancelToken.isCancelled())
+        throw PgCancelledError("PgConnection: query cancelled");
+    auto reg = cancelToken.onCancel([ch = ctx_->channel.get()] {
+        ch->cancelAll();
+    });
+
+    // Rows left unread when the consumer stops early cannot be skipped cheaply,
+    // so a stream that does not run to completion takes the connection with it.
+    struct StreamGuard
     {
-        ctx_->handleBroken();
-        throw PgCancelledError("PgConnection: query canceled (read)");
-    }
+        std::shared_ptr<ConnectionContext> ctx;
+        bool finished{ false };
+        ~StreamGuard()
+        {
+            ctx->streaming = false;
+            if (!finished)
+                ctx->handleBroken();
+        }
+    } guard{ ctx_ };
 
-    auto res = co_await resultPromise->get_future().get();
-    reg.unregister(); // prevent cancel
-    resultPromise.reset();
+    ctx_->streaming = true;
+    co_await sendQuery(sql, params, true);
 
-    if (!res)
+    std::shared_ptr<PgResultWrapper> error;
+    while (true)
     {
-        ctx_->handleBroken();
-        throw PgConnectionError("PgConnection: no result returned");
+        ctx_->inputReady.reset();
+        if (cancelToken.isCancelled())
+            throw PgCancelledError("PgConnection: query canceled (read)");
+        if (ctx_->broken)
+            throw PgConnectionError("PQconsumeInput: " + std::string(PQerrorMessage(ctx_->pgConn->raw)));
+        if (PQisBusy(ctx_->pgConn->raw))
+        {
+            co_await ctx_->inputReady.wait();
+            continue;
+        }
+
+        PGresult * raw = PQgetResult(ctx_->pgConn->raw);
+        if (!raw)
+            break;
+        auto res = std::make_shared<PgResultWrapper>(raw);
+        ExecStatusType status = PQresultStatus(raw);
+        if (status == PGRES_SINGLE_TUPLE && !error)
+            co_yield PgRow(PgResult(std::move(res)));
+        else if (status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK && !error)
+            error = std::move(res); // keep draining until libpq is idle again
     }
+    reg.unregister();
+    guard.finished = true;
 
-    ExecStatusType status = PQresultStatus(res->raw);
-    if (status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK)
+    if (error)
     {
-        std::string err = PQresultErrorMessage(res->raw);
-        const char * sqlstate = PQresultErrorField(res->raw, PG_DIAG_SQLSTATE);
+        std::string err = PQresultErrorMessage(error->raw);
+        const char * sqlstate = PQresultErrorField(error->raw, PG_DIAG_SQLSTATE);
         NITRO_TRACE("PGresult sqlstate=%s, err: %s", sqlstate ? sqlstate : "N/A", err.c_str());
         throw PgQueryError("PgConnection query error: " + err, sqlstate ? sqlstate : "");
     }
-
-    co_return PgResult(std::move(res));
-}
-
-Task<PgResult> PgConnectionImpl::query(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken)
-{
-    co_return co_await sendAndReceive(sql, std::move(params), cancelToken);
-}
-
-Task<> PgConnectionImpl::execute(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken)
-{
-    co_await sendAndReceive(sql, std::move(params), cancelToken);
 }
 
 } // namespace nitrocoro::pg
@@ -43,12 +43,14 @@ public:
 
     Task<PgResult> query(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken) override;
     Task<> execute(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken) override;
+    AsyncGenerator<PgRow> queryRows(std::string sql, std::vector<PgValue> params, CancelToken cancelToken) override;
 
     // void setNotifyHandler(std::function<void(std::string, std::string, int)> h) { ctx_->notifyHandler = std::move(h); }
     void setBrokenHandler(std::function<void()>);
 
 private:
     Task<PgResult> sendAndReceive(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken);
+    Task<> sendQuery(std::string_view sql, const std::vector<PgValue> & params, bool singleRowMode);
     static Task<> readLoop(std::shared_ptr<ConnectionContext> ctx);
 
     std::shared_ptr<ConnectionContext> ctx_;
@@ -67,6 +67,15 @@ Task<> PgTransaction::execute(std::string_view sql, std::vector<PgValue> params,
     co_await conn_->execute(sql, std::move(params), cancelToken);
 }
 
+AsyncGenerator<PgRow> PgTransaction::queryRows(std::string sql, std::vector<PgValue> params, CancelToken cancelToken)
+{
+    if (done_)
+        throw PgTransactionError("Transaction already finished");
+    auto rows = conn_->queryRows(std::move(sql), std::move(params), std::move(cancelToken));
+    while (auto row = co_await rows.next())
+        co_yield std::move(*row);
+}
+
 Task<> PgTransaction::commit()
 {
     if (done_)
@@ -44,4 +44,9 @@ Task<> PooledConnection::execute(std::string_view sql, std::vector<PgValue> para
     return impl_->execute(sql, std::move(params), cancelToken);
 }
 
+AsyncGenerator<PgRow> PooledConnection::queryRows(std::string sql, std::vector<PgValue> params, CancelToken cancelToken)
+{
+    return impl_->queryRows(std::move(sql), std::move(params), std::move(cancelToken));
+}
+
 } // namespace nitrocoro::pg
@@ -30,6 +30,7 @@ public:
     bool isAlive() const override;
     Task<PgResult> query(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken) override;
     Task<> execute(std::string_view sql, std::vector<PgValue> params, CancelToken cancelToken) override;
+    AsyncGenerator<PgRow> queryRows(std::string sql, std::vector<PgValue> params, CancelToken cancelToken) override;
 
 private:
     std::unique_ptr<PgConnectionImpl> impl_;
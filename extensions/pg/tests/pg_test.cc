@@ -102,6 +102,39 @@ NITRO_TEST(multiple_rows)
     NITRO_CHECK_EQ(std::get<int64_t>(result.get(2, 0)), 3);
 }
 
+NITRO_TEST(query_rows_stream)
+{
+    auto conn = co_await PgConnection::connect(connStr());
+    auto rows = conn->queryRows("SELECT n, 'row' || n AS label FROM generate_series(1, $1::int8) AS n", { int64_t(1000) }, {});
+    int64_t count = 0;
+    while (auto row = co_await rows.next())
+    {
+        ++count;
+        NITRO_CHECK_EQ(row->colCount(), 2);
+        NITRO_CHECK_EQ(std::get<int64_t>(row->get(0)), count);
+        NITRO_CHECK_EQ(std::get<std::string>(row->get(1)), "row" + std::to_string(count));
+    }
+    NITRO_CHECK_EQ(count, 1000);
+
+    // the connection is reusable once the stream has finished
+    auto result = co_await conn->query("SELECT 1");
+    NITRO_CHECK_EQ(std::get<int64_t>(result.get(0, 0)), 1);
+}
+
+NITRO_TEST(query_rows_error)
+{
+    auto conn = co_await PgConnection::connect(connStr());
+    auto rows = conn->queryRows("SELECT * FORM pg_class");
+    NITRO_CHECK_THROWS_AS(co_await rows.next(), PgQueryError);
+    NITRO_CHECK(conn->isAlive());
+
+    // abandoning a stream half-way discards the connection
+    auto partial = conn->queryRows("SELECT generate_series(1, 100000)");
+    NITRO_CHECK((co_await partial.next()).has_value());
+    partial = {};
+    NITRO_CHECK(!conn->isAlive());
+}
+
 NITRO_TEST(result_copy)
 {
     auto conn = co_await PgConnection::connect(connStr());
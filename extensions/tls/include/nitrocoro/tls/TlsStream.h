@@ -9,7 +9,9 @@
 #include <nitrocoro/net/TcpConnection.h>
 #include <nitrocoro/tls/TlsContext.h>
 
+#include <span>
 #include <string>
+#include <sys/uio.h>
 #include <vector>
 
 namespace nitrocoro::tls
@@ -36,6 +38,9 @@ public:
 
     Task<size_t> read(void * buf, size_t len);
     Task<size_t> write(const void * buf, size_t len);
+    // Encrypts every buffer before flushing, so the records leave in one TCP write.
+    // Small buffers are packed together into full-size records.
+    Task<size_t> writev(std::span<const iovec> iov);
     Task<> shutdown();
 
     std::string sniName() const;
@@ -50,11 +55,15 @@ private:
     /** Flush encryptedOutBuf_ to TCP. Returns false if peer closed. */
     Task<bool> flushEncrypted();
 
+    /** Encrypt all of data into encryptedOutBuf_. Throws on provider errors. */
+    void encryptPlain(const char * data, size_t len);
+
     net::TcpConnectionPtr conn_;
     std::unique_ptr<TlsProvider> provider_;
 
     std::vector<char> plainBuf_;      // leftover decrypted data
     std::vector<char> encryptedOutBuf_; // pending ciphertext to send
+    std::vector<char> stagingBuf_;      // small writev() buffers packed into one record
     bool eof_{ false };
 
     Mutex writeMutex_;
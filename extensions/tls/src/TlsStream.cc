@@ -4,6 +4,7 @@
  */
 #include <nitrocoro/tls/TlsStream.h>
 
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 
@@ -146,6 +147,77 @@ Task<size_t> TlsStream::write(const void * buf, size_t len)
     co_return sent;
 }
 
+Task<size_t> TlsStream::writev(std::span<const iovec> iov)
+{
+    // Largest plaintext one TLS record carries. Smaller buffers are packed up
+    // to this before SSL_write, so e.g. a chunk header, its payload and the
+    // trailing CRLF share one record instead of paying framing and AEAD for
+    // each; buffers of a full record or more go to SSL_write directly.
+    constexpr size_t kMaxRecordPlaintext = 16 * 1024;
+    // Bounds the ciphertext buffered between flushes for very large gathers.
+    constexpr size_t kMaxBufferedCiphertext = 256 * 1024;
+
+    [[maybe_unused]] auto lock = co_await writeMutex_.scoped_lock();
+
+    size_t sent = 0;
+    size_t flushed = 0;
+    stagingBuf_.clear();
+    for (const auto & v : iov)
+    {
+        auto * data = static_cast<const char *>(v.iov_base);
+        if (v.iov_len < kMaxRecordPlaintext)
+        {
+            size_t take = std::min(v.iov_len, kMaxRecordPlaintext - stagingBuf_.size());
+            stagingBuf_.insert(stagingBuf_.end(), data, data + take);
+            if (stagingBuf_.size() < kMaxRecordPlaintext)
+                continue;
+            encryptPlain(stagingBuf_.data(), stagingBuf_.size());
+            sent += stagingBuf_.size();
+            stagingBuf_.assign(data + take, data + v.iov_len);
+        }
+        else
+        {
+            if (!stagingBuf_.empty())
+            {
+                encryptPlain(stagingBuf_.data(), stagingBuf_.size());
+                sent += stagingBuf_.size();
+                stagingBuf_.clear();
+            }
+            encryptPlain(data, v.iov_len);
+            sent += v.iov_len;
+        }
+        if (encryptedOutBuf_.size() >= kMaxBufferedCiphertext)
+        {
+            if (!co_await flushEncrypted())
+                co_return flushed; // peer closed
+            flushed = sent;
+        }
+    }
+    if (!stagingBuf_.empty())
+    {
+        encryptPlain(stagingBuf_.data(), stagingBuf_.size());
+        sent += stagingBuf_.size();
+        stagingBuf_.clear();
+    }
+    if (!co_await flushEncrypted())
+        co_return flushed;
+    co_return sent;
+}
+
+void TlsStream::encryptPlain(const char * data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = provider_->sendPlain(data, len, encryptedOutBuf_);
+        if (n < 0)
+            throw std::runtime_error(provider_->lastError());
+        if (n == 0)
+            throw std::runtime_error("TLS write returned 0 unexpectedly");
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+}
+
 // ---------------------------------------------------------------------------
 // shutdown
 // ---------------------------------------------------------------------------
@@ -11,6 +11,7 @@
 #include <nitrocoro/tls/TlsPolicy.h>
 #include <nitrocoro/tls/TlsStream.h>
 
+#include <algorithm>
 #include <cstring>
 #include <openssl/evp.h>
 #include <openssl/pem.h>
@@ -98,6 +99,40 @@ static std::pair<TlsContextPtr, TlsContextPtr> makeContexts(const std::string &
     return { serverCtx, clientCtx };
 }
 
+/** Copy from -> to until EOF; if records is set, count the TLS records passing by their 5-byte headers. */
+static Task<> relayRecords(TcpConnectionPtr from, TcpConnectionPtr to, size_t * records)
+{
+    unsigned char header[5];
+    size_t headerLen = 0;
+    size_t bodyLeft = 0;
+    char buf[16384];
+    while (true)
+    {
+        size_t n = co_await from->read(buf, sizeof(buf));
+        if (n == 0)
+            break;
+        for (size_t i = 0; records && i < n;)
+        {
+            if (bodyLeft > 0)
+            {
+                size_t skip = std::min(bodyLeft, n - i);
+                i += skip;
+                bodyLeft -= skip;
+                continue;
+            }
+            header[headerLen++] = static_cast<unsigned char>(buf[i++]);
+            if (headerLen == sizeof(header))
+            {
+                ++*records;
+                bodyLeft = (size_t{ header[3] } << 8) | header[4];
+                headerLen = 0;
+            }
+        }
+        co_await to->write(buf, n);
+    }
+    co_await to->shutdown();
+}
+
 // ---------------------------------------------------------------------------
 // Tests
 // ---------------------------------------------------------------------------
@@ -380,6 +415,80 @@ NITRO_TEST(tls_multi_sni)
     NITRO_CHECK(hasB);
 }
 
+/** writev() packs small buffers into shared records instead of one record per buffer. */
+NITRO_TEST(tls_writev_packs_small_buffers)
+{
+    auto [serverCtx, clientCtx] = makeContexts();
+
+    // Eight ~1KB chunks framed like ChunkedWriter output, then one large buffer.
+    std::vector<std::string> pieces;
+    for (int i = 0; i < 8; ++i)
+    {
+        pieces.push_back("3e8\r\n");
+        pieces.push_back(std::string(1000, static_cast<char>('a' + i)));
+        pieces.push_back("\r\n");
+    }
+    pieces.push_back(std::string(20000, 'z'));
+    std::vector<iovec> iov;
+    std::string expected = "x";
+    for (auto & piece : pieces)
+    {
+        iov.push_back({ piece.data(), piece.size() });
+        expected += piece;
+    }
+
+    std::string received;
+    size_t clientRecords = 0;
+    TcpServer server(0);
+    TcpServer relay(0);
+
+    Scheduler::current()->spawn([&]() -> Task<> {
+        co_await server.start([&](TcpConnectionPtr conn) -> Task<> {
+            auto tls = co_await TlsStream::accept(conn, serverCtx);
+            char buf[16384];
+            while (true)
+            {
+                size_t n = co_await tls->read(buf, sizeof(buf));
+                if (n == 0)
+                    break;
+                received.append(buf, n);
+                if (received.size() == 1 || received.size() == expected.size())
+                    co_await tls->write("k", 1);
+            }
+            co_await tls->shutdown();
+            co_await server.stop();
+        });
+    });
+    Scheduler::current()->spawn([&]() -> Task<> {
+        co_await relay.start([&](TcpConnectionPtr conn) -> Task<> {
+            auto upstream = co_await TcpConnection::connect({ "127.0.0.1", server.port() });
+            Scheduler::current()->spawn([conn, upstream]() { return relayRecords(upstream, conn, nullptr); });
+            co_await relayRecords(conn, upstream, &clientRecords);
+            co_await relay.stop();
+        });
+    });
+
+    co_await Scheduler::current()->sleep_for(0.01);
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", relay.port() });
+    auto tls = co_await TlsStream::connect(conn, clientCtx);
+    char ack;
+    co_await tls->write("x", 1);
+    co_await tls->read(&ack, 1); // handshake and the first record are past the relay
+    size_t before = clientRecords;
+
+    size_t sent = co_await tls->writev(iov);
+    NITRO_CHECK_EQ(sent, expected.size() - 1);
+    co_await tls->read(&ack, 1);
+    NITRO_CHECK(received == expected);
+    // All 24 small buffers share one record; the 20000-byte one needs two.
+    NITRO_CHECK_EQ(clientRecords - before, 3u);
+
+    co_await tls->shutdown();
+    co_await server.wait();
+    co_await relay.wait();
+}
+
 int main(int argc, char ** argv)
 {
     return nitrocoro::test::run_all(argc, argv);
@@ -4,11 +4,15 @@
  */
 #pragma once
 
+#include <nitrocoro/core/AsyncGenerator.h>
 #include <nitrocoro/core/Task.h>
+#include <nitrocoro/io/BufferedStream.h>
 #include <nitrocoro/io/Stream.h>
 #include <nitrocoro/websocket/WsTypes.h>
 
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace nitrocoro::websocket
 {
@@ -19,23 +23,47 @@ struct WsMessage
     std::string payload;
 };
 
+/** A piece of a message's payload, as produced by WsConnection::stream(). */
+struct WsChunk
+{
+    WsMessageType type;
+    std::string_view data; // valid until the next chunk is requested
+    bool last;             // final chunk of the current message
+};
+
 class WsConnection
 {
 public:
+    // Frames are read and written through a BufferedStream: a frame header
+    // costs no extra recv(), and sends in the same loop iteration are coalesced.
     explicit WsConnection(io::StreamPtr stream)
-        : stream_(std::move(stream)) {}
+        : stream_(std::make_shared<io::BufferedStream>(std::move(stream))) {}
 
-    /** Read one complete (possibly fragmented) message. Returns nullopt on close. */
+    /**
+     * Read one complete (possibly fragmented) message. Returns nullopt on close.
+     * A control frame that is fragmented or over 125 bytes is answered with
+     * Close(ProtocolError) and throws, as does stream().
+     */
     Task<std::optional<WsMessage>> receive();
 
+    /**
+     * Streams incoming messages as chunks of at most maxChunk bytes instead of
+     * assembling each message in memory; ends when the peer sends Close.
+     * Pings are answered as they arrive. Do not mix with receive(). The
+     * connection must outlive the generator.
+     */
+    AsyncGenerator<WsChunk> stream(size_t maxChunk = 16 * 1024);
+
     Task<> send(std::string_view data, WsMessageType type = WsMessageType::Text);
     Task<> shutdown(CloseCode code = CloseCode::NormalClosure, std::string_view reason = "");
     Task<> forceClose();
 
 private:
     Task<> sendFrame(uint8_t opcode, const void * data, size_t len, bool mask = false);
+    // Sends Close(ProtocolError), then throws.
+    Task<> failProtocol(const char * reason);
 
-    io::StreamPtr stream_;
+    io::BufferedStreamPtr stream_;
 };
 
 } // namespace nitrocoro::websocket
@@ -4,8 +4,10 @@
  */
 #include <nitrocoro/websocket/WsConnection.h>
 
+#include <algorithm>
 #include <stdexcept>
-#include <vector>
+#include <string>
+#include <sys/uio.h>
 
 namespace
 {
@@ -18,6 +20,13 @@ enum class Opcode : uint8_t
     Ping = 0x9,
     Pong = 0xA,
 };
+// Control frames carry at most 125 bytes and are never fragmented (RFC 6455 5.5).
+constexpr uint64_t kMaxControlPayload = 125;
+
+bool isControl(Opcode op)
+{
+    return (static_cast<uint8_t>(op) & 0x08) != 0;
+}
 } // namespace
 
 namespace nitrocoro::websocket
@@ -25,7 +34,7 @@ namespace nitrocoro::websocket
 
 // ── helpers ──────────────────────────────────────────────────────────────────
 
-static Task<size_t> readExact(io::Stream & s, void * buf, size_t len)
+static Task<size_t> readExact(io::BufferedStream & s, void * buf, size_t len)
 {
     size_t total = 0;
     while (total < len)
@@ -38,8 +47,69 @@ static Task<size_t> readExact(io::Stream & s, void * buf, size_t len)
     co_return total;
 }
 
+struct FrameHeader
+{
+    bool fin;
+    Opcode opcode;
+    bool masked;
+    uint64_t payloadLen;
+    uint8_t maskKey[4];
+};
+
+static Task<FrameHeader> readFrameHeader(io::BufferedStream & s)
+{
+    uint8_t header[2];
+    co_await readExact(s, header, 2);
+
+    FrameHeader h{};
+    h.fin = (header[0] & 0x80) != 0;
+    h.opcode = static_cast<Opcode>(header[0] & 0x0F);
+    h.masked = (header[1] & 0x80) != 0;
+    h.payloadLen = header[1] & 0x7F;
+
+    if (h.payloadLen == 126)
+    {
+        uint8_t ext[2];
+        co_await readExact(s, ext, 2);
+        h.payloadLen = (uint64_t(ext[0]) << 8) | ext[1];
+    }
+    else if (h.payloadLen == 127)
+    {
+        uint8_t ext[8];
+        co_await readExact(s, ext, 8);
+        h.payloadLen = 0;
+        for (int i = 0; i < 8; ++i)
+            h.payloadLen = (h.payloadLen << 8) | ext[i];
+    }
+
+    if (h.masked)
+        co_await readExact(s, h.maskKey, 4);
+    co_return h;
+}
+
+// maskOffset is the position of data[0] within the frame payload.
+static void unmask(char * data, size_t len, const uint8_t (&maskKey)[4], uint64_t maskOffset)
+{
+    for (size_t i = 0; i < len; ++i)
+        data[i] ^= maskKey[(maskOffset + i) % 4];
+}
+
 // ── receive ──────────────────────────────────────────────────────────────────
 
+Task<> WsConnection::failProtocol(const char * reason)
+{
+    // Best effort: the peer may already be gone.
+    try
+    {
+        co_await shutdown(CloseCode::ProtocolError, reason);
+        co_await stream_->flush();
+    }
+    catch (...)
+    {
+    }
+    throw std::runtime_error(std::string("WsConnection: ") + reason);
+}
+
 Task<std::optional<WsMessage>> WsConnection::receive()
 {
     std::string payload;
@@ -47,56 +117,31 @@ Task<std::optional<WsMessage>> WsConnection::receive()
 
     while (true)
     {
-        // Read 2-byte frame header
-        uint8_t header[2];
-        co_await readExact(*stream_, header, 2);
-
-        bool fin = (header[0] & 0x80) != 0;
-        Opcode opcode = static_cast<Opcode>(header[0] & 0x0F);
-        bool masked = (header[1] & 0x80) != 0;
-        uint64_t payloadLen = header[1] & 0x7F;
-
-        if (payloadLen == 126)
-        {
-            uint8_t ext[2];
-            co_await readExact(*stream_, ext, 2);
-            payloadLen = (uint64_t(ext[0]) << 8) | ext[1];
-        }
-        else if (payloadLen == 127)
-        {
-            uint8_t ext[8];
-            co_await readExact(*stream_, ext, 8);
-            payloadLen = 0;
-            for (int i = 0; i < 8; ++i)
-                payloadLen = (payloadLen << 8) | ext[i];
-        }
-
-        uint8_t maskKey[4] = {};
-        if (masked)
-            co_await readExact(*stream_, maskKey, 4);
+        FrameHeader h = co_await readFrameHeader(*stream_);
+        if (isControl(h.opcode) && (!h.fin || h.payloadLen > kMaxControlPayload))
+            co_await failProtocol("malformed control frame");
 
         size_t offset = payload.size();
-        payload.resize(offset + payloadLen);
-        co_await readExact(*stream_, payload.data() + offset, payloadLen);
+        payload.resize(offset + h.payloadLen);
+        co_await readExact(*stream_, payload.data() + offset, h.payloadLen);
 
-        if (masked)
-            for (size_t i = 0; i < payloadLen; ++i)
-                payload[offset + i] ^= maskKey[i % 4];
+        if (h.masked)
+            unmask(payload.data() + offset, h.payloadLen, h.maskKey, 0);
 
         // Control frames (ping/pong/close) are never fragmented
-        if (opcode == Opcode::Ping)
+        if (h.opcode == Opcode::Ping)
         {
-            co_await sendFrame(static_cast<uint8_t>(Opcode::Pong), payload.data() + offset, payloadLen);
+            co_await sendFrame(static_cast<uint8_t>(Opcode::Pong), payload.data() + offset, h.payloadLen);
             payload.resize(offset);
             continue;
         }
-        if (opcode == Opcode::Close)
+        if (h.opcode == Opcode::Close)
             co_return std::nullopt;
 
-        if (opcode != Opcode::Continuation)
-            finalOpcode = opcode;
+        if (h.opcode != Opcode::Continuation)
+            finalOpcode = h.opcode;
 
-        if (fin)
+        if (h.fin)
         {
             WsMessageType type = (finalOpcode == Opcode::Binary) ? WsMessageType::Binary : WsMessageType::Text;
             co_return WsMessage{ type, std::move(payload) };
@@ -104,37 +149,90 @@ Task<std::optional<WsMessage>> WsConnection::receive()
     }
 }
 
+AsyncGenerator<WsChunk> WsConnection::stream(size_t maxChunk)
+{
+    std::string buf(maxChunk, '\0');
+    WsMessageType type = WsMessageType::Text;
+
+    while (true)
+    {
+        FrameHeader h = co_await readFrameHeader(*stream_);
+
+        // Control frames may arrive between fragments. One that is too long
+        // cannot be skipped safely, so it ends the connection.
+        if (isControl(h.opcode))
+        {
+            if (!h.fin || h.payloadLen > kMaxControlPayload)
+                co_await failProtocol("malformed control frame");
+            char control[kMaxControlPayload];
+            size_t len = static_cast<size_t>(h.payloadLen);
+            co_await readExact(*stream_, control, len);
+            if (h.opcode == Opcode::Close)
+                co_return;
+            if (h.masked)
+                unmask(control, len, h.maskKey, 0);
+            if (h.opcode == Opcode::Ping)
+                co_await sendFrame(static_cast<uint8_t>(Opcode::Pong), control, len);
+            continue;
+        }
+
+        if (h.opcode != Opcode::Continuation)
+            type = (h.opcode == Opcode::Binary) ? WsMessageType::Binary : WsMessageType::Text;
+
+        if (h.payloadLen == 0)
+        {
+            if (h.fin)
+                co_yield WsChunk{ type, {}, true };
+            continue;
+        }
+
+        uint64_t offset = 0;
+        while (offset < h.payloadLen)
+        {
+            size_t n = static_cast<size_t>(std::min<uint64_t>(h.payloadLen - offset, buf.size()));
+            co_await readExact(*stream_, buf.data(), n);
+            if (h.masked)
+                unmask(buf.data(), n, h.maskKey, offset);
+            offset += n;
+            co_yield WsChunk{ type, std::string_view(buf.data(), n), h.fin && offset == h.payloadLen };
+        }
+    }
+}
+
 // ── send ─────────────────────────────────────────────────────────────────────
 
 Task<> WsConnection::sendFrame(uint8_t opcode, const void * data, size_t len, bool mask)
 {
-    std::vector<uint8_t> frame;
-    frame.reserve(10 + len);
+    uint8_t header[10];
+    size_t headerLen = 0;
 
-    frame.push_back(0x80 | opcode); // FIN + opcode
+    header[headerLen++] = 0x80 | opcode; // FIN + opcode
 
     uint8_t maskBit = mask ? 0x80 : 0x00;
     if (len < 126)
     {
-        frame.push_back(maskBit | static_cast<uint8_t>(len));
+        header[headerLen++] = maskBit | static_cast<uint8_t>(len);
     }
     else if (len < 65536)
     {
-        frame.push_back(maskBit | 126);
-        frame.push_back(static_cast<uint8_t>(len >> 8));
-        frame.push_back(static_cast<uint8_t>(len));
+        header[headerLen++] = maskBit | 126;
+        header[headerLen++] = static_cast<uint8_t>(len >> 8);
+        header[headerLen++] = static_cast<uint8_t>(len);
     }
     else
     {
-        frame.push_back(maskBit | 127);
+        header[headerLen++] = maskBit | 127;
         for (int i = 7; i >= 0; --i)
-            frame.push_back(static_cast<uint8_t>(len >> (i * 8)));
+            header[headerLen++] = static_cast<uint8_t>(len >> (i * 8));
     }
 
-    const auto * bytes = static_cast<const uint8_t *>(data);
-    frame.insert(frame.end(), bytes, bytes + len);
-
-    co_await stream_->write(frame.data(), frame.size());
+    // Small frames are coalesced in the write buffer; large payloads go out
+    // with their header in one writev() without being copied.
+    iovec iov[] = {
+        { header, headerLen },
+        { const_cast<void *>(data), len },
+    };
+    co_await stream_->writev(iov);
 }
 
 Task<> WsConnection::send(std::string_view data, WsMessageType type)
@@ -135,6 +135,103 @@ NITRO_TEST(ws_echo)
     co_await server.stop();
 }
 
+/** stream() delivers a large message in bounded chunks, unmasked across chunk boundaries. */
+NITRO_TEST(ws_stream_chunks)
+{
+    http::HttpServer server(0);
+    WsServer ws;
+    ws.route("/ws", [](WsConnection & conn) -> Task<> {
+        size_t bytes = 0;
+        size_t chunks = 0;
+        bool intact = true;
+        auto incoming = conn.stream(16);
+        while (auto chunk = co_await incoming.next())
+        {
+            for (char c : chunk->data)
+                intact = intact && c == static_cast<char>('a' + (bytes++ % 26));
+            ++chunks;
+            if (chunk->last)
+            {
+                co_await conn.send(std::to_string(bytes) + ":" + std::to_string(chunks) + (intact ? ":ok" : ":bad"));
+                bytes = chunks = 0;
+            }
+        }
+    });
+    ws.attachTo(server);
+    co_await startServer(server);
+
+    auto conn = co_await net::TcpConnection::connect({ "127.0.0.1", server.listeningPort() });
+    std::string req = "GET /ws HTTP/1.1\r\n"
+                      "Host: localhost\r\n"
+                      "Upgrade: websocket\r\n"
+                      "Connection: Upgrade\r\n"
+                      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                      "Sec-WebSocket-Version: 13\r\n"
+                      "\r\n";
+    co_await conn->write(req.data(), req.size());
+    auto resp = co_await readHttpResponse(*conn);
+    NITRO_CHECK(resp.find("101") != std::string::npos);
+
+    std::string big(1000, '\0');
+    for (size_t i = 0; i < big.size(); ++i)
+        big[i] = static_cast<char>('a' + i % 26);
+    co_await sendMaskedText(*conn, big);
+    NITRO_CHECK_EQ(co_await recvTextFrame(*conn), "1000:63:ok");
+
+    co_await sendMaskedText(*conn, "ab");
+    NITRO_CHECK_EQ(co_await recvTextFrame(*conn), "2:1:ok");
+
+    co_await server.stop();
+}
+
+/** An oversized control frame is rejected with Close(ProtocolError), not truncated. */
+NITRO_TEST(ws_rejects_oversized_control_frame)
+{
+    http::HttpServer server(0);
+    WsServer ws;
+    bool rejected = false;
+    ws.route("/ws", [&rejected](WsConnection & conn) -> Task<> {
+        try
+        {
+            auto incoming = conn.stream();
+            while (co_await incoming.next())
+            {
+            }
+        }
+        catch (const std::runtime_error &)
+        {
+            rejected = true;
+        }
+    });
+    ws.attachTo(server);
+    co_await startServer(server);
+
+    auto conn = co_await net::TcpConnection::connect({ "127.0.0.1", server.listeningPort() });
+    std::string req = "GET /ws HTTP/1.1\r\n"
+                      "Host: localhost\r\n"
+                      "Upgrade: websocket\r\n"
+                      "Connection: Upgrade\r\n"
+                      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                      "Sec-WebSocket-Version: 13\r\n"
+                      "\r\n";
+    co_await conn->write(req.data(), req.size());
+    auto resp = co_await readHttpResponse(*conn);
+    NITRO_CHECK(resp.find("101") != std::string::npos);
+
+    // Masked Ping with a 200-byte payload; its tail would look like a frame header
+    std::vector<uint8_t> frame = { 0x89, 0x80 | 126, 0, 200, 0, 0, 0, 0 };
+    frame.resize(frame.size() + 200, 0x81);
+    co_await conn->write(frame.data(), frame.size());
+
+    std::string close = co_await recvTextFrame(*conn);
+    NITRO_REQUIRE(close.size() >= 2);
+    NITRO_CHECK_EQ((uint8_t(close[0]) << 8) | uint8_t(close[1]), 1002);
+    co_await sleep(10ms);
+    NITRO_CHECK(rejected);
+
+    co_await server.stop();
+}
+
 /** Non-WebSocket requests on the same server still work normally. */
 NITRO_TEST(ws_http_coexist)
 {
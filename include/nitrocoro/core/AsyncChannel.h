@@ -0,0 +1,453 @@
+/**
+ * @file AsyncChannel.h
+ * @brief Bounded multi-producer multi-consumer channel for coroutines.
+ *
+ * co_await send(v) suspends while the channel is full and co_await receive()
+ * suspends while it is empty, so a pipeline built from channels holds at most
+ * the sum of their capacities no matter how far producers outrun consumers.
+ * Producers and consumers may live on different Schedulers.
+ *
+ * Items sit in a lock-free ring (Vyukov's per-cell sequence scheme, as in
+ * BoundedMpscQueue). Blocked senders and receivers park on two intrusive
+ * FIFOs guarded by a small lock, as in Semaphore. A successful operation
+ * wakes one waiter on the other side, which retries on its own Scheduler, so
+ * each item costs one wakeup however many coroutines are parked. Closing the
+ * channel closes both queues and wakes everyone; nothing can park afterwards.
+ */
+#pragma once
+
+#include <nitrocoro/core/Scheduler.h>
+
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace nitrocoro
+{
+
+namespace detail
+{
+
+struct ChannelWaiter
+{
+    ChannelWaiter * next = nullptr;
+    void (*retry)(ChannelWaiter *) = nullptr;
+    Scheduler * sched = nullptr;
+
+    void wake() noexcept
+    {
+        sched->schedule([this] { retry(this); });
+    }
+};
+
+// FIFO of parked ChannelWaiters. The lock covers only linking and unlinking;
+// the waiting count lets notifiers skip it while nobody is parked.
+class ChannelWaitQueue
+{
+public:
+    ChannelWaitQueue() = default;
+    ChannelWaitQueue(const ChannelWaitQueue &) = delete;
+    ChannelWaitQueue & operator=(const ChannelWaitQueue &) = delete;
+
+    ~ChannelWaitQueue() { assert(head_ == nullptr); }
+
+    bool closed() const noexcept { return closed_.load(std::memory_order_acquire); }
+
+    bool hasWaiters() const noexcept { return waiting_.load(std::memory_order_relaxed) != 0; }
+
+    // False, leaving @p waiter unlinked, once the queue is closed.
+    bool push(ChannelWaiter * waiter) noexcept
+    {
+        std::lock_guard lock(lock_);
+        if (closed_.load(std::memory_order_relaxed))
+            return false;
+        waiter->next = nullptr;
+        if (tail_)
+            tail_->next = waiter;
+        else
+            head_ = waiter;
+        tail_ = waiter;
+        waiting_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Wakes the longest-parked waiter, if any.
+    void wakeOne() noexcept
+    {
+        if (!hasWaiters())
+            return;
+        ChannelWaiter * waiter;
+        {
+            std::lock_guard lock(lock_);
+            waiter = head_;
+            if (!waiter)
+                return;
+            head_ = waiter->next;
+            if (!head_)
+                tail_ = nullptr;
+            waiting_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        waiter->wake();
+    }
+
+    // Idempotent; wakes every waiter and refuses later pushes.
+    void close() noexcept
+    {
+        ChannelWaiter * waiter;
+        {
+            std::lock_guard lock(lock_);
+            if (closed_.load(std::memory_order_relaxed))
+                return;
+            closed_.store(true, std::memory_order_release);
+            waiter = head_;
+            head_ = tail_ = nullptr;
+            waiting_.store(0, std::memory_order_relaxed);
+        }
+        while (waiter)
+        {
+            // Read next first: once woken the waiter may finish and go away.
+            auto * next = waiter->next;
+            waiter->wake();
+            waiter = next;
+        }
+    }
+
+private:
+    std::mutex lock_;
+    ChannelWaiter * head_{ nullptr };
+    ChannelWaiter * tail_{ nullptr };
+    std::atomic<size_t> waiting_{ 0 };
+    std::atomic<bool> closed_{ false };
+};
+
+} // namespace detail
+
+/**
+ * Bounded channel of T. The capacity is rounded up to a power of two, at least 2.
+ *
+ *   AsyncChannel<Job> jobs(64);
+ *   co_await jobs.send(job);              // false once the channel is closed
+ *   while (auto job = co_await jobs.receive())
+ *       handle(*job);                     // nullopt once closed and drained
+ *
+ * close() wakes every waiter: pending and later sends fail, receivers drain
+ * what is already buffered and then get std::nullopt. An item whose send()
+ * races with close() may be accepted after the last receiver has given up;
+ * it is destroyed with the channel. The channel must outlive its waiters.
+ */
+template <typename T>
+class AsyncChannel
+{
+    class SendAwaiter;
+    class ReceiveAwaiter;
+
+public:
+    explicit AsyncChannel(size_t capacity)
+    {
+        size_t size = 2; // the sequence scheme cannot tell full from empty with one cell
+        while (size < capacity)
+            size <<= 1;
+        mask_ = size - 1;
+        cells_ = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    AsyncChannel(const AsyncChannel &) = delete;
+    AsyncChannel & operator=(const AsyncChannel &) = delete;
+
+    ~AsyncChannel()
+    {
+        while (pop())
+        {
+        }
+    }
+
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+    /** Approximate number of buffered items; exact only when no one else is using the channel. */
+    size_t size() const noexcept
+    {
+        size_t tail = enqueuePos_.load(std::memory_order_acquire);
+        size_t head = dequeuePos_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool isClosed() const noexcept { return sendWaiters_.closed(); }
+
+    /** Suspends while the channel is full. Resumes with false, dropping @p value, if it is closed. */
+    [[nodiscard]] SendAwaiter send(T value) { return SendAwaiter(*this, std::move(value)); }
+
+    /** Suspends while the channel is empty. Resumes with std::nullopt once it is closed and drained. */
+    [[nodiscard]] ReceiveAwaiter receive() noexcept { return ReceiveAwaiter(*this); }
+
+    /** Never suspends. @p value is moved from only when this returns true. */
+    bool trySend(T && value) { return sendNow(std::move(value)); }
+    bool trySend(const T & value) { return sendNow(value); }
+
+    /** Never suspends; std::nullopt if the channel is empty. */
+    std::optional<T> tryReceive()
+    {
+        auto value = pop();
+        if (value)
+            notify(sendWaiters_, recvWaiters_, [this] { return maybeHasItem(); });
+        return value;
+    }
+
+    /** Idempotent; callable from any thread. */
+    void close() noexcept
+    {
+        sendWaiters_.close();
+        recvWaiters_.close();
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T * value() noexcept { return std::launder(reinterpret_cast<T *>(storage)); }
+    };
+
+    template <typename U>
+    bool sendNow(U && value)
+    {
+        if (isClosed() || !push(std::forward<U>(value)))
+            return false;
+        notify(recvWaiters_, sendWaiters_, [this] { return maybeHasSpace(); });
+        return true;
+    }
+
+    /**
+     * Wakes one waiter of @p peers for the item or slot just made available.
+     * The fence pairs with the one in park(): either this sees the parked
+     * waiter, or the waiter's recheck sees the new state.
+     *
+     * A woken waiter can still come up empty, e.g. when a slot ahead of the
+     * new item is claimed but not yet written; that wakeup is spent. So an
+     * operation that leaves @p more to do passes one wakeup on to its own
+     * side (@p same), and a backlog always has someone working on it.
+     */
+    template <typename More>
+    static void notify(detail::ChannelWaitQueue & peers, detail::ChannelWaitQueue & same, More && more) noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        peers.wakeOne();
+        if (same.hasWaiters() && more())
+            same.wakeOne();
+    }
+
+    // The value is only forwarded once a cell is claimed.
+    template <typename U>
+    bool push(U && value)
+    {
+        Cell * cell;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false; // full
+            }
+            else
+            {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        ::new (static_cast<void *>(cell->storage)) T(std::forward<U>(value));
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> pop()
+    {
+        Cell * cell;
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return std::nullopt; // empty
+            }
+            else
+            {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        std::optional<T> value(std::move(*cell->value()));
+        cell->value()->~T();
+        cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return value;
+    }
+
+    // Conservative rechecks after parking: a stale position only makes them
+    // answer "maybe", which costs a spurious retry, never a lost wakeup.
+    bool maybeHasSpace() const noexcept
+    {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        size_t seq = cells_[pos & mask_].seq.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) >= 0;
+    }
+
+    bool maybeHasItem() const noexcept
+    {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        size_t seq = cells_[pos & mask_].seq.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) >= 0;
+    }
+
+    /**
+     * Parks @p waiter on @p waiters. Returns false if the queue is closed.
+     * Otherwise the waiter now belongs to the queue: if @p ready reports that
+     * the state changed while it was being pushed, one waiter (not
+     * necessarily this one) is woken right away. @p ready must run after the
+     * push and the fence, never before, or a notify() in between finds no one
+     * to wake.
+     */
+    template <typename Ready>
+    static bool park(detail::ChannelWaitQueue & waiters, detail::ChannelWaiter * waiter, Ready && ready) noexcept
+    {
+        if (!waiters.push(waiter))
+            return false;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ready())
+            waiters.wakeOne();
+        return true;
+    }
+
+    class [[nodiscard]] SendAwaiter : detail::ChannelWaiter
+    {
+    public:
+        SendAwaiter(AsyncChannel & channel, T && value)
+            : channel_(channel), value_(std::move(value))
+        {
+        }
+
+        bool await_ready() { return attempt(); }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            handle_ = handle;
+            sched = Scheduler::current();
+            retry = &SendAwaiter::retryFromWake;
+            assert(sched && "AsyncChannel::send must be awaited on a Scheduler thread");
+            return suspend();
+        }
+
+        bool await_resume() const noexcept { return sent_; }
+
+    private:
+        // True once the operation is settled, either sent or closed.
+        bool attempt()
+        {
+            if (channel_.isClosed())
+                return true;
+            sent_ = channel_.sendNow(std::move(value_));
+            return sent_;
+        }
+
+        bool suspend()
+        {
+            return AsyncChannel::park(channel_.sendWaiters_, this, [this] { return channel_.maybeHasSpace(); });
+        }
+
+        static void retryFromWake(detail::ChannelWaiter * waiter)
+        {
+            auto * self = static_cast<SendAwaiter *>(waiter);
+            if (self->attempt() || !self->suspend())
+                self->handle_.resume();
+        }
+
+        AsyncChannel & channel_;
+        T value_;
+        bool sent_{ false };
+        std::coroutine_handle<> handle_;
+    };
+
+    class [[nodiscard]] ReceiveAwaiter : detail::ChannelWaiter
+    {
+    public:
+        explicit ReceiveAwaiter(AsyncChannel & channel) noexcept
+            : channel_(channel)
+        {
+        }
+
+        bool await_ready() { return attempt(); }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            handle_ = handle;
+            sched = Scheduler::current();
+            retry = &ReceiveAwaiter::retryFromWake;
+            assert(sched && "AsyncChannel::receive must be awaited on a Scheduler thread");
+            return suspend();
+        }
+
+        std::optional<T> await_resume() { return std::move(result_); }
+
+    private:
+        // True once the operation is settled, either received or closed and
+        // drained. Closure is read before the ring so that items sent before
+        // close() are still delivered.
+        bool attempt()
+        {
+            bool closed = channel_.isClosed();
+            result_ = channel_.tryReceive();
+            return result_.has_value() || closed;
+        }
+
+        // A closed queue means close() ran after attempt(); one more attempt
+        // then settles for certain.
+        bool suspend()
+        {
+            if (AsyncChannel::park(channel_.recvWaiters_, this, [this] { return channel_.maybeHasItem(); }))
+                return true;
+            attempt();
+            return false;
+        }
+
+        static void retryFromWake(detail::ChannelWaiter * waiter)
+        {
+            auto * self = static_cast<ReceiveAwaiter *>(waiter);
+            if (self->attempt() || !self->suspend())
+                self->handle_.resume();
+        }
+
+        AsyncChannel & channel_;
+        std::optional<T> result_;
+        std::coroutine_handle<> handle_;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_{ 0 };
+    alignas(64) std::atomic<size_t> enqueuePos_{ 0 };
+    alignas(64) std::atomic<size_t> dequeuePos_{ 0 };
+    alignas(64) detail::ChannelWaitQueue sendWaiters_;
+    detail::ChannelWaitQueue recvWaiters_;
+};
+
+} // namespace nitrocoro
@@ -0,0 +1,189 @@
+/**
+ * @file AsyncGenerator.h
+ * @brief Asynchronous generator: co_yield values from a coroutine that may also co_await
+ */
+#pragma once
+
+#include <nitrocoro/core/FramePool.h>
+#include <nitrocoro/core/ResumeSite.h>
+#include <nitrocoro/core/Task.h>
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <source_location>
+#include <type_traits>
+#include <utility>
+
+namespace nitrocoro
+{
+
+/**
+ * Lazy stream of T produced by a coroutine that can co_await between yields,
+ * for sources too large or too slow to materialize (body chunks, DB rows,
+ * WebSocket frames):
+ *
+ *   AsyncGenerator<std::string_view> lines(Reader & r)
+ *   {
+ *       while (auto line = co_await r.readLine())
+ *           co_yield *line;
+ *   }
+ *
+ *   auto gen = lines(reader);
+ *   while (auto line = co_await gen.next())
+ *       handle(*line);
+ *
+ * next() resumes the producer through symmetric transfer and the producer
+ * hands control straight back on co_yield, so a value that is ready costs two
+ * coroutine switches and no allocation: the yielded object stays in the
+ * producer's frame and next() moves it out. The frame itself comes from the
+ * FramePool, like Task's.
+ *
+ * Like Task, the consumer resumes on whichever thread the producer yields
+ * from. An exception thrown by the producer is rethrown by next(); after
+ * that, or once the producer returns, next() yields std::nullopt. Destroying
+ * the generator while it is suspended at a co_yield destroys the producer.
+ */
+template <typename T>
+class [[nodiscard]] AsyncGenerator
+{
+public:
+    struct promise_type;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    // Hands control back to whoever called next().
+    struct YieldAwaiter
+    {
+        bool await_ready() noexcept { return false; }
+        std::coroutine_handle<> await_suspend(handle_type h) noexcept { return h.promise().consumer_; }
+        void await_resume() noexcept {}
+    };
+
+    struct promise_type : detail::PooledFrame
+    {
+        using value_type = std::remove_reference_t<T>;
+
+        value_type * value_{ nullptr };
+        std::optional<value_type> copy_; // only for co_yield of a const lvalue
+        std::coroutine_handle<> consumer_;
+        std::exception_ptr exception_;
+
+        AsyncGenerator get_return_object() noexcept { return AsyncGenerator{ handle_type::from_promise(*this) }; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        YieldAwaiter final_suspend() noexcept { return {}; }
+
+        YieldAwaiter yield_value(value_type & value) noexcept
+        {
+            value_ = std::addressof(value);
+            return {};
+        }
+
+        YieldAwaiter yield_value(value_type && value) noexcept
+        {
+            value_ = std::addressof(value);
+            return {};
+        }
+
+        YieldAwaiter yield_value(const value_type & value)
+            requires(!std::is_const_v<value_type>)
+        {
+            copy_.emplace(value);
+            value_ = std::addressof(*copy_);
+            return {};
+        }
+
+#ifndef NITROCORO_DISABLE_RESUME_SITES
+        template <typename U>
+        auto await_transform(U && value, std::source_location site = std::source_location::current())
+        {
+            return detail::withResumeSite(std::forward<U>(value), site);
+        }
+#endif
+
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+    };
+
+    struct [[nodiscard]] NextAwaiter
+    {
+        handle_type handle_;
+
+        bool await_ready() noexcept { return !handle_ || handle_.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept
+        {
+            auto & promise = handle_.promise();
+            promise.consumer_ = consumer;
+            promise.value_ = nullptr;
+            return handle_;
+        }
+
+        std::optional<std::remove_cvref_t<T>> await_resume()
+        {
+            if (!handle_)
+                return std::nullopt;
+            auto & promise = handle_.promise();
+            if (handle_.done())
+            {
+                if (promise.exception_)
+                    std::rethrow_exception(std::exchange(promise.exception_, nullptr));
+                return std::nullopt;
+            }
+            return std::move(*promise.value_);
+        }
+    };
+
+    AsyncGenerator() noexcept = default;
+
+    explicit AsyncGenerator(handle_type handle) noexcept
+        : handle_(handle) {}
+
+    AsyncGenerator(AsyncGenerator && other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    AsyncGenerator & operator=(AsyncGenerator && other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    AsyncGenerator(const AsyncGenerator &) = delete;
+    AsyncGenerator & operator=(const AsyncGenerator &) = delete;
+
+    ~AsyncGenerator()
+    {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    /** Resumes the producer until its next co_yield; std::nullopt once it has finished. */
+    NextAwaiter next() noexcept { return NextAwaiter{ handle_ }; }
+
+private:
+    handle_type handle_;
+};
+
+/**
+ * The `for co_await` loop C++ does not have: calls @p fn with every value of
+ * @p gen in order. @p fn may return void or a Task<>, which is awaited before
+ * the next value is pulled.
+ */
+template <typename T, typename Fn>
+Task<> forEach(AsyncGenerator<T> & gen, Fn fn)
+{
+    while (auto value = co_await gen.next())
+    {
+        if constexpr (std::is_void_v<std::invoke_result_t<Fn &, std::remove_cvref_t<T> &&>>)
+            fn(std::move(*value));
+        else
+            co_await fn(std::move(*value));
+    }
+}
+
+} // namespace nitrocoro
@@ -0,0 +1,97 @@
+/**
+ * @file Barrier.h
+ * @brief Coroutine-aware reusable barrier
+ *
+ * Lock-free: each arrival pushes its awaiter onto a LockFreeListNode list and
+ * then bumps the arrival count. The arrival that completes the phase takes the
+ * whole list, resets the count and resumes everyone else on their own
+ * Scheduler, continuing inline itself.
+ */
+#pragma once
+
+#include <nitrocoro/core/LockFreeList.h>
+#include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/WaiterQueue.h>
+
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+
+namespace nitrocoro
+{
+
+/**
+ * Like std::barrier without a completion function: each phase completes once
+ * @p expected participants have called co_await arrive_and_wait(), and the
+ * barrier is immediately reusable for the next phase.
+ */
+class Barrier final
+{
+    class BarrierAwaiter;
+
+public:
+    explicit Barrier(std::ptrdiff_t expected) noexcept
+        : expected_(expected)
+    {
+        assert(expected > 0);
+    }
+
+    Barrier(const Barrier &) = delete;
+    Barrier & operator=(const Barrier &) = delete;
+
+    ~Barrier() { assert(waiters_.load(std::memory_order_relaxed) == nullptr); }
+
+    std::ptrdiff_t expected() const noexcept { return expected_; }
+
+    [[nodiscard]] BarrierAwaiter arrive_and_wait(Scheduler * sched = Scheduler::current()) noexcept
+    {
+        return BarrierAwaiter(*this, sched);
+    }
+
+private:
+    class BarrierAwaiter : detail::ListWaiter
+    {
+    public:
+        BarrierAwaiter(Barrier & barrier, Scheduler * sched) noexcept
+            : barrier_(barrier)
+        {
+            sched_ = sched;
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            handle_ = handle;
+            return barrier_.arrive(this);
+        }
+
+        void await_resume() noexcept {}
+
+    private:
+        Barrier & barrier_;
+    };
+
+    // Returns false for the arrival that completes the phase.
+    bool arrive(detail::ListWaiter * waiter)
+    {
+        // Pushing before counting guarantees the completing arrival, which
+        // synchronizes with every earlier one through arrived_, sees all nodes.
+        LockFreeListNode::push(waiters_, waiter);
+        if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 < expected_)
+            return true;
+
+        // Nobody can arrive for the next phase until someone is resumed below.
+        auto * list = waiters_.exchange(nullptr, std::memory_order_acq_rel);
+        arrived_.store(0, std::memory_order_relaxed);
+        detail::ListWaiter::resumeAll(list, waiter);
+        return false;
+    }
+
+    const std::ptrdiff_t expected_;
+    std::atomic<std::ptrdiff_t> arrived_{ 0 };
+    std::atomic<LockFreeListNode *> waiters_{ nullptr };
+};
+
+} // namespace nitrocoro
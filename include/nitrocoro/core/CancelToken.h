@@ -13,6 +13,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <vector>
 
 namespace nitrocoro
@@ -21,6 +22,13 @@ namespace nitrocoro
 class CancelToken;
 class CancelRegistration;
 
+// Thrown by operations that observed their CancelToken, e.g. TcpConnection::read().
+struct CancelledException : std::runtime_error
+{
+    CancelledException()
+        : std::runtime_error("operation cancelled") {}
+};
+
 namespace detail
 {
 
@@ -45,6 +53,22 @@ struct CancelState
     std::mutex cbMutex_;
     std::vector<Callback> callbacks_;
 
+    // Latest cancelAfter() timer; it only holds a weak_ptr, so leaving it armed is harmless
+    Scheduler * timerSched_{ nullptr };
+    TimerId timerId_{ kInvalidTimerId };
+
+    CancelState() = default;
+    CancelState(const CancelState &) = delete;
+    CancelState & operator=(const CancelState &) = delete;
+
+    ~CancelState()
+    {
+        // The last owner may be any thread, possibly after timerSched_ is gone:
+        // only touch the wheel from its own loop thread, where it is alive.
+        if (timerSched_ && timerSched_ == Scheduler::current())
+            timerSched_->cancel_timer(timerId_);
+    }
+
     bool isCancelled() const noexcept
     {
         return LockFreeListNode::closed(waiters_);
@@ -268,15 +292,21 @@ public:
 
     bool isCancelled() const noexcept { return state_->isCancelled(); }
 
+    // Re-arming from the Scheduler's thread replaces the previous deadline.
     void cancelAfter(std::chrono::steady_clock::duration dur)
     {
-        auto * sched = sched_;
         std::weak_ptr<detail::CancelState> weak = state_;
-        sched->spawn([weak, dur, sched]() -> Task<> {
-            co_await sched->sleep_for(dur);
+        TimerId id = sched_->run_after(dur, [weak]() {
             if (auto s = weak.lock())
                 s->cancel();
         });
+        if (id != kInvalidTimerId)
+        {
+            if (state_->timerSched_)
+                state_->timerSched_->cancel_timer(state_->timerId_);
+            state_->timerSched_ = sched_;
+            state_->timerId_ = id;
+        }
     }
 
 private:
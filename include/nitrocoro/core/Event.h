@@ -0,0 +1,96 @@
+/**
+ * @file Event.h
+ * @brief Coroutine-aware manual-reset event
+ *
+ * Lock-free: waiters push themselves onto a LockFreeListNode list and set()
+ * closes the list, so a set event is simply a closed list and reset() reopens
+ * it. Waiters are resumed on their own Scheduler.
+ */
+#pragma once
+
+#include <nitrocoro/core/LockFreeList.h>
+#include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/WaiterQueue.h>
+
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+
+namespace nitrocoro
+{
+
+/**
+ * Manual-reset event for startup gating and one-to-many signals:
+ *
+ *   Event ready;
+ *   co_await ready.wait();   // elsewhere: ready.set();
+ *
+ * set() and reset() may be called from any thread.
+ */
+class Event final
+{
+    class EventAwaiter;
+
+public:
+    explicit Event(bool initiallySet = false) noexcept
+        : waiters_(initiallySet ? LockFreeListNode::kClosed : nullptr)
+    {
+    }
+
+    Event(const Event &) = delete;
+    Event & operator=(const Event &) = delete;
+
+    ~Event()
+    {
+        [[maybe_unused]] auto * head = waiters_.load(std::memory_order_relaxed);
+        assert(head == nullptr || head == LockFreeListNode::kClosed);
+    }
+
+    bool isSet() const noexcept { return LockFreeListNode::closed(waiters_); }
+
+    /** Resumes every current waiter; later wait() calls complete immediately until reset(). */
+    void set()
+    {
+        detail::ListWaiter::resumeAll(LockFreeListNode::close(waiters_));
+    }
+
+    /** No effect unless the event is set. */
+    void reset() noexcept
+    {
+        LockFreeListNode * expected = LockFreeListNode::kClosed;
+        waiters_.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+    }
+
+    [[nodiscard]] EventAwaiter wait(Scheduler * sched = Scheduler::current()) noexcept
+    {
+        return EventAwaiter(*this, sched);
+    }
+
+private:
+    class EventAwaiter : detail::ListWaiter
+    {
+    public:
+        EventAwaiter(Event & event, Scheduler * sched) noexcept
+            : event_(event)
+        {
+            sched_ = sched;
+        }
+
+        bool await_ready() const noexcept { return event_.isSet(); }
+
+        bool await_suspend(std::coroutine_handle<> handle) noexcept
+        {
+            handle_ = handle;
+            return LockFreeListNode::push(event_.waiters_, this);
+        }
+
+        void await_resume() noexcept {}
+
+    private:
+        Event & event_;
+    };
+
+    std::atomic<LockFreeListNode *> waiters_;
+};
+
+} // namespace nitrocoro
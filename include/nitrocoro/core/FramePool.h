@@ -0,0 +1,67 @@
+/**
+ * @file FramePool.h
+ * @brief Per-thread size-class freelists for coroutine frames
+ *
+ * Promise types inherit detail::PooledFrame to route their frame allocation
+ * through the pool. Define NITROCORO_DISABLE_FRAME_POOL (CMake option
+ * NITROCORO_FRAME_POOL=OFF) to fall back to plain operator new/delete.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nitrocoro
+{
+
+// Counters for the calling thread's pool.
+struct FramePoolStats
+{
+    uint64_t hits{ 0 };   // served from a freelist
+    uint64_t misses{ 0 }; // fell through to operator new
+};
+
+namespace detail
+{
+
+/**
+ * @brief Frames up to kMaxPooledSize bytes are rounded to 64-byte size classes.
+ *
+ * Freed frames go to the freeing thread's list (frames may migrate between
+ * Schedulers), capped per class; beyond the cap, or above the largest class,
+ * memory goes straight back to operator delete.
+ */
+class FramePool
+{
+public:
+    static constexpr size_t kGranularity = 64;
+    static constexpr size_t kNumClasses = 32;
+    static constexpr size_t kMaxPooledSize = kGranularity * kNumClasses;
+    static constexpr uint32_t kMaxCachedPerClass = 256;
+
+    static void * allocate(size_t size);
+    static void deallocate(void * ptr, size_t size) noexcept;
+
+    static FramePoolStats stats() noexcept;
+};
+
+#ifndef NITROCORO_DISABLE_FRAME_POOL
+struct PooledFrame
+{
+    static void * operator new(size_t size) { return FramePool::allocate(size); }
+    static void operator delete(void * ptr, size_t size) noexcept { FramePool::deallocate(ptr, size); }
+};
+#else
+struct PooledFrame
+{
+};
+#endif
+
+} // namespace detail
+
+inline FramePoolStats framePoolStats() noexcept
+{
+    return detail::FramePool::stats();
+}
+
+} // namespace nitrocoro
@@ -0,0 +1,60 @@
+/**
+ * @file HandleQueue.h
+ * @brief Single-threaded FIFO of coroutine handles backed by a growable ring
+ */
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <vector>
+
+namespace nitrocoro
+{
+
+/**
+ * @brief Non-atomic FIFO used for same-thread resumes.
+ *
+ * Storage only grows (doubling), so push/pop never allocate once the queue
+ * has reached its steady-state depth.
+ */
+class HandleQueue
+{
+public:
+    void push(std::coroutine_handle<> handle)
+    {
+        if (size_ == buffer_.size())
+            grow();
+        buffer_[(head_ + size_) & (buffer_.size() - 1)] = handle;
+        ++size_;
+    }
+
+    // Returns a null handle when empty.
+    std::coroutine_handle<> pop() noexcept
+    {
+        if (size_ == 0)
+            return nullptr;
+        auto handle = buffer_[head_];
+        head_ = (head_ + 1) & (buffer_.size() - 1);
+        --size_;
+        return handle;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_t size() const noexcept { return size_; }
+
+private:
+    void grow()
+    {
+        std::vector<std::coroutine_handle<>> next(buffer_.empty() ? 256 : buffer_.size() * 2);
+        for (size_t i = 0; i < size_; ++i)
+            next[i] = buffer_[(head_ + i) & (buffer_.size() - 1)];
+        buffer_.swap(next);
+        head_ = 0;
+    }
+
+    std::vector<std::coroutine_handle<>> buffer_;
+    size_t head_{ 0 };
+    size_t size_{ 0 };
+};
+
+} // namespace nitrocoro
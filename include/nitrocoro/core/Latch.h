@@ -0,0 +1,62 @@
+/**
+ * @file Latch.h
+ * @brief Coroutine-aware single-use countdown latch
+ */
+#pragma once
+
+#include <nitrocoro/core/Event.h>
+#include <nitrocoro/core/Scheduler.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+
+namespace nitrocoro
+{
+
+/**
+ * Counts down to zero once, like std::latch, but wait() suspends the
+ * coroutine instead of blocking the thread:
+ *
+ *   Latch started(workers);
+ *   // each worker: started.count_down();
+ *   co_await started.wait();
+ *
+ * count_down() may be called from any thread; waiters are resumed on their
+ * own Scheduler.
+ */
+class Latch final
+{
+public:
+    explicit Latch(std::ptrdiff_t expected) noexcept
+        : count_(expected), done_(expected <= 0)
+    {
+    }
+
+    Latch(const Latch &) = delete;
+    Latch & operator=(const Latch &) = delete;
+
+    void count_down(std::ptrdiff_t n = 1)
+    {
+        auto prev = count_.fetch_sub(n, std::memory_order_acq_rel);
+        assert(prev >= n);
+        if (prev == n)
+            done_.set();
+    }
+
+    bool try_wait() const noexcept { return count_.load(std::memory_order_acquire) <= 0; }
+
+    [[nodiscard]] auto wait(Scheduler * sched = Scheduler::current()) noexcept { return done_.wait(sched); }
+
+    [[nodiscard]] auto arrive_and_wait(std::ptrdiff_t n = 1, Scheduler * sched = Scheduler::current())
+    {
+        count_down(n);
+        return done_.wait(sched);
+    }
+
+private:
+    std::atomic<std::ptrdiff_t> count_;
+    Event done_;
+};
+
+} // namespace nitrocoro
@@ -1,16 +1,30 @@
 /**
  * @file MpscQueue.h
- * @brief Lock-free Multiple Producer Single Consumer Queue (unbounded)
+ * @brief Lock-free Multiple Producer Single Consumer Queues (unbounded and bounded)
  */
 #pragma once
 
 #include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
 #include <optional>
 #include <utility>
 
 namespace nitrocoro
 {
 
+/**
+ * @brief Unbounded lock-free MPSC queue (Vyukov's intrusive node scheme).
+ *
+ * Popped nodes are recycled through a per-queue freelist instead of being
+ * freed, so once the queue has reached its working size push() and pop() do
+ * not touch the allocator. The freelist keeps the high-water mark of nodes
+ * until the queue is destroyed. Values live in raw node storage: T needs no
+ * default constructor and is destroyed as soon as it is popped.
+ */
 template <typename T>
 class MpscQueue
 {
@@ -19,21 +33,47 @@ public:
     {
         Node * stub = new Node();
         head_.store(stub, std::memory_order_relaxed);
-        tail_ = stub;
+        tail_.store(stub, std::memory_order_relaxed);
     }
 
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue & operator=(const MpscQueue &) = delete;
+
     ~MpscQueue()
     {
-        while (Node * node = head_.load(std::memory_order_relaxed))
+        Node * node = head_.load(std::memory_order_relaxed);
+        // The head is the stub; every node after it still holds a value.
+        Node * next = node->next.load(std::memory_order_relaxed);
+        delete node;
+        while ((node = next) != nullptr)
         {
-            head_.store(node->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            next = node->next.load(std::memory_order_relaxed);
+            node->value()->~T();
             delete node;
         }
+        for (Node * list : { spare_, unpack(freeList_.load(std::memory_order_relaxed)) })
+        {
+            while ((node = list) != nullptr)
+            {
+                list = node->next.load(std::memory_order_relaxed);
+                delete node;
+            }
+        }
     }
 
     void push(T value)
     {
-        Node * node = new Node(std::move(value));
+        Node * node = acquireNode();
+        try
+        {
+            ::new (static_cast<void *>(node->storage)) T(std::move(value));
+        }
+        catch (...)
+        {
+            releaseNodes(node, node);
+            throw;
+        }
+        node->next.store(nullptr, std::memory_order_relaxed);
         Node * prev = tail_.exchange(node, std::memory_order_acq_rel);
         prev->next.store(node, std::memory_order_release);
     }
@@ -48,9 +88,11 @@ public:
             return std::nullopt;
         }
 
-        T value = std::move(next->value);
+        // next becomes the stub, so its value is moved out and destroyed here.
+        std::optional<T> value(std::move(*next->value()));
+        next->value()->~T();
         head_.store(next, std::memory_order_release);
-        delete head;
+        recycleNode(head);
         return value;
     }
 
@@ -63,21 +105,162 @@ public:
 private:
     struct Node
     {
-        T value;
-        std::atomic<Node *> next;
+        std::atomic<Node *> next{ nullptr };
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T * value() noexcept { return std::launder(reinterpret_cast<T *>(storage)); }
+    };
+
+    // The freelist is a Treiber stack popped by every producer, so its head
+    // carries a 16-bit version in the pointer's unused top bits against ABA.
+    // Nodes are only deleted by the destructor, so reading next of a node
+    // another thread has just taken is safe; the versioned CAS then fails.
+    static_assert(sizeof(void *) == 8, "MpscQueue packs a version into 64-bit pointers");
+    static constexpr int kPointerBits = 48;
+    static constexpr std::uint64_t kPointerMask = (std::uint64_t{ 1 } << kPointerBits) - 1;
+
+    static Node * unpack(std::uint64_t word) noexcept
+    {
+        return reinterpret_cast<Node *>(word & kPointerMask);
+    }
+
+    static std::uint64_t pack(Node * node, std::uint64_t prevWord) noexcept
+    {
+        auto bits = reinterpret_cast<std::uint64_t>(node);
+        assert((bits & ~kPointerMask) == 0);
+        return bits | ((prevWord & ~kPointerMask) + (kPointerMask + 1));
+    }
 
-        Node()
-            : value{}, next(nullptr)
+    Node * acquireNode()
+    {
+        std::uint64_t word = freeList_.load(std::memory_order_acquire);
+        while (Node * node = unpack(word))
         {
+            Node * next = node->next.load(std::memory_order_relaxed);
+            if (freeList_.compare_exchange_weak(word, pack(next, word), std::memory_order_acquire))
+                return node;
         }
-        explicit Node(T val)
-            : value(std::move(val)), next(nullptr)
+        return new Node();
+    }
+
+    // Consumer only: collects nodes privately and hands them to the producers
+    // kRecycleBatch at a time, so the consumer does one CAS per batch
+    // rather than one per pop.
+    void recycleNode(Node * node) noexcept
+    {
+        node->next.store(spare_, std::memory_order_relaxed);
+        if (!spare_)
+            spareTail_ = node;
+        spare_ = node;
+        if (++spareCount_ == kRecycleBatch)
         {
+            releaseNodes(spare_, spareTail_);
+            spare_ = spareTail_ = nullptr;
+            spareCount_ = 0;
         }
+    }
+
+    // Pushes the chain first..last onto the freelist; safe from any thread.
+    void releaseNodes(Node * first, Node * last) noexcept
+    {
+        std::uint64_t word = freeList_.load(std::memory_order_relaxed);
+        do
+        {
+            last->next.store(unpack(word), std::memory_order_relaxed);
+        } while (!freeList_.compare_exchange_weak(word, pack(first, word), std::memory_order_release));
+    }
+
+    static constexpr int kRecycleBatch = 32;
+
+    // Consumer, producers and the freelist each get their own cache line.
+    alignas(64) std::atomic<Node *> head_;
+    Node * spare_{ nullptr };
+    Node * spareTail_{ nullptr };
+    int spareCount_{ 0 };
+    alignas(64) std::atomic<Node *> tail_;
+    alignas(64) std::atomic<std::uint64_t> freeList_{ 0 };
+};
+
+/**
+ * @brief Bounded lock-free MPSC ring buffer (Vyukov's per-cell sequence scheme).
+ *
+ * Never allocates after construction. try_push() fails instead of blocking
+ * when the ring is full, so callers can fall back to another path.
+ * T must be default constructible.
+ */
+template <typename T>
+class BoundedMpscQueue
+{
+public:
+    explicit BoundedMpscQueue(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        mask_ = size - 1;
+        cells_ = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedMpscQueue(const BoundedMpscQueue &) = delete;
+    BoundedMpscQueue & operator=(const BoundedMpscQueue &) = delete;
+
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+    bool try_push(T value)
+    {
+        Cell * cell;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false; // full
+            }
+            else
+            {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Single consumer only.
+    std::optional<T> pop()
+    {
+        Cell & cell = cells_[dequeuePos_ & mask_];
+        size_t seq = cell.seq.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(dequeuePos_ + 1) < 0)
+            return std::nullopt;
+
+        T value = std::move(cell.value);
+        cell.seq.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+        ++dequeuePos_;
+        return value;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        T value{};
     };
 
-    /* alignas(64) */ std::atomic<Node *> head_;
-    /* alignas(64) */ std::atomic<Node *> tail_;
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_{ 0 };
+    alignas(64) std::atomic<size_t> enqueuePos_{ 0 };
+    alignas(64) size_t dequeuePos_{ 0 };
 };
 
 } // namespace nitrocoro
@@ -0,0 +1,76 @@
+/**
+ * @file ResumeSite.h
+ * @brief Per-thread record of the co_await site the running coroutine came from
+ *
+ * Task promises wrap every co_await in SiteAwaiter, which publishes the source
+ * location of the co_await expression when the awaiting coroutine hands
+ * control to an awaited Task and when it resumes. StallWatchdog reads the
+ * value of a stalled loop thread to name the code that is holding it.
+ *
+ * Tracking is compiled out when NITROCORO_DISABLE_RESUME_SITES is defined
+ * (CMake option NITROCORO_RESUME_SITES=OFF); promises then declare no
+ * await_transform, so co_await sees the awaitable unchanged, and
+ * StallReport::site stays empty.
+ */
+#pragma once
+
+#include <nitrocoro/core/CoroTraits.h>
+
+#include <atomic>
+#include <coroutine>
+#include <source_location>
+#include <utility>
+
+namespace nitrocoro::detail
+{
+
+// Written by the owning thread, read by StallWatchdog; source_location is a
+// single pointer to static data, so the atomic is lock-free and never dangles.
+inline thread_local std::atomic<std::source_location> tlsResumeSite{};
+
+#ifndef NITROCORO_DISABLE_RESUME_SITES
+
+inline void publishResumeSite(const std::source_location & site) noexcept
+{
+    tlsResumeSite.store(site, std::memory_order_relaxed);
+}
+
+template <typename Awaiter>
+struct SiteAwaiter
+{
+    Awaiter awaiter_;
+    std::source_location site_;
+
+    decltype(auto) await_ready() { return awaiter_.await_ready(); }
+
+    template <typename Promise>
+    decltype(auto) await_suspend(std::coroutine_handle<Promise> h)
+    {
+        // An awaited Task starts running inside this call; attribute it to us.
+        publishResumeSite(site_);
+        return awaiter_.await_suspend(h);
+    }
+
+    decltype(auto) await_resume()
+    {
+        publishResumeSite(site_);
+        return awaiter_.await_resume();
+    }
+};
+
+// Used as promise_type::await_transform; the default argument is evaluated at
+// the co_await expression, which is exactly the suspension site.
+template <typename T>
+auto withResumeSite(T && value, const std::source_location & site)
+{
+    using Awaiter = decltype(getAwaiter(std::forward<T>(value)));
+    return SiteAwaiter<Awaiter>{ getAwaiter(std::forward<T>(value)), site };
+}
+
+#else
+
+inline void publishResumeSite(const std::source_location &) noexcept {}
+
+#endif
+
+} // namespace nitrocoro::detail
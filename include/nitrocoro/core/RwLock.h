@@ -0,0 +1,235 @@
+/**
+ * @file RwLock.h
+ * @brief Coroutine-aware reader-writer lock
+ *
+ * Uncontended lock, lock_shared and their unlocks are single atomic
+ * operations on one state word. Coroutines that have to wait park on
+ * intrusive reader and writer FIFOs guarded by a small lock and are resumed on
+ * their own Scheduler.
+ *
+ * Queued writers block new readers, so a steady stream of readers cannot
+ * starve a writer; when a writer unlocks, all queued readers are admitted
+ * before the next writer, so writers cannot starve readers either.
+ */
+#pragma once
+
+#include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/WaiterQueue.h>
+
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+
+namespace nitrocoro
+{
+
+class RwLock final
+{
+    class WriteAwaiter;
+    class ScopedWriteAwaiter;
+    class ReadAwaiter;
+    class ScopedReadAwaiter;
+
+public:
+    RwLock() noexcept = default;
+
+    RwLock(const RwLock &) = delete;
+    RwLock & operator=(const RwLock &) = delete;
+
+    ~RwLock()
+    {
+        assert(state_.load(std::memory_order_relaxed) == 0);
+        assert(readers_.empty() && writers_.empty());
+    }
+
+    bool try_lock() noexcept
+    {
+        std::int64_t expected = 0;
+        return state_.compare_exchange_strong(expected, kWriter, std::memory_order_seq_cst);
+    }
+
+    /** Fails while writers are queued, so readers cannot starve them. */
+    bool try_lock_shared() noexcept
+    {
+        return waiting_.load(std::memory_order_seq_cst) == 0 && tryAddReader();
+    }
+
+    [[nodiscard]] WriteAwaiter lock(Scheduler * sched = Scheduler::current()) noexcept
+    {
+        return WriteAwaiter(*this, sched);
+    }
+
+    [[nodiscard]] ScopedWriteAwaiter scoped_lock(Scheduler * sched = Scheduler::current()) noexcept
+    {
+        return ScopedWriteAwaiter(*this, sched);
+    }
+
+    [[nodiscard]] ReadAwaiter lock_shared(Scheduler * sched = Scheduler::current()) noexcept
+    {
+        return ReadAwaiter(*this, sched);
+    }
+
+    [[nodiscard]] ScopedReadAwaiter scoped_lock_shared(Scheduler * sched = Scheduler::current()) noexcept
+    {
+        return ScopedReadAwaiter(*this, sched);
+    }
+
+    void unlock()
+    {
+        assert(state_.load(std::memory_order_relaxed) == kWriter);
+        state_.store(0, std::memory_order_seq_cst);
+        if (waiting_.load(std::memory_order_seq_cst) > 0)
+            grant(true);
+    }
+
+    void unlock_shared()
+    {
+        [[maybe_unused]] auto prev = state_.fetch_sub(1, std::memory_order_seq_cst);
+        assert(prev > 0);
+        if (waiting_.load(std::memory_order_seq_cst) > 0)
+            grant(false);
+    }
+
+private:
+    static constexpr std::int64_t kWriter = -1;
+
+    class WriteAwaiter : protected detail::SyncWaiter
+    {
+    public:
+        WriteAwaiter(RwLock & lock, Scheduler * sched) noexcept
+            : lock_(lock)
+        {
+            sched_ = sched;
+        }
+
+        bool await_ready() noexcept { return lock_.try_lock(); }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            handle_ = handle;
+            return lock_.lockSlow(this);
+        }
+
+        void await_resume() noexcept {}
+
+    protected:
+        RwLock & lock_;
+    };
+
+    class ScopedWriteAwaiter : public WriteAwaiter
+    {
+    public:
+        using WriteAwaiter::WriteAwaiter;
+
+        [[nodiscard]] auto await_resume() noexcept { return std::unique_lock<RwLock>{ lock_, std::adopt_lock }; }
+    };
+
+    class ReadAwaiter : protected detail::SyncWaiter
+    {
+    public:
+        ReadAwaiter(RwLock & lock, Scheduler * sched) noexcept
+            : lock_(lock)
+        {
+            sched_ = sched;
+        }
+
+        bool await_ready() noexcept { return lock_.try_lock_shared(); }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            handle_ = handle;
+            return lock_.lockSharedSlow(this);
+        }
+
+        void await_resume() noexcept {}
+
+    protected:
+        RwLock & lock_;
+    };
+
+    class ScopedReadAwaiter : public ReadAwaiter
+    {
+    public:
+        using ReadAwaiter::ReadAwaiter;
+
+        [[nodiscard]] auto await_resume() noexcept { return std::shared_lock<RwLock>{ lock_, std::adopt_lock }; }
+    };
+
+    bool tryAddReader() noexcept
+    {
+        std::int64_t state = state_.load(std::memory_order_seq_cst);
+        while (state >= 0)
+        {
+            if (state_.compare_exchange_weak(state, state + 1, std::memory_order_seq_cst))
+                return true;
+        }
+        return false;
+    }
+
+    // The slow paths count themselves in waiting_ before rechecking state_,
+    // while unlocks change state_ before checking waiting_: with both sides
+    // seq_cst, either the unlock sees the waiter or the recheck sees the unlock.
+    bool lockSlow(detail::SyncWaiter * waiter)
+    {
+        std::lock_guard guard(mutex_);
+        waiting_.fetch_add(1, std::memory_order_seq_cst);
+        if (try_lock())
+        {
+            waiting_.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+        writers_.push(waiter);
+        return true;
+    }
+
+    bool lockSharedSlow(detail::SyncWaiter * waiter)
+    {
+        std::lock_guard guard(mutex_);
+        waiting_.fetch_add(1, std::memory_order_seq_cst);
+        if (writers_.empty() && tryAddReader())
+        {
+            waiting_.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+        readers_.push(waiter);
+        return true;
+    }
+
+    void grant(bool writerReleased)
+    {
+        detail::WaiterQueue ready;
+        {
+            std::lock_guard guard(mutex_);
+            bool preferReaders = writerReleased && !readers_.empty();
+            if (!writers_.empty() && !preferReaders)
+            {
+                if (try_lock())
+                {
+                    ready.push(writers_.pop());
+                    waiting_.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+            else
+            {
+                while (!readers_.empty() && tryAddReader())
+                {
+                    ready.push(readers_.pop());
+                    waiting_.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        detail::WaiterQueue::resumeAll(ready.release());
+    }
+
+    // kWriter while write-locked, otherwise the number of readers.
+    std::atomic<std::int64_t> state_{ 0 };
+    std::atomic<std::int64_t> waiting_{ 0 };
+    std::mutex mutex_;
+    detail::WaiterQueue readers_;
+    detail::WaiterQueue writers_;
+};
+
+} // namespace nitrocoro
@@ -5,7 +5,11 @@
 #pragma once
 
 #include <nitrocoro/core/CoroTraits.h>
+#include <nitrocoro/core/FramePool.h>
+#include <nitrocoro/core/HandleQueue.h>
 #include <nitrocoro/core/MpscQueue.h>
+#include <nitrocoro/core/ResumeSite.h>
+#include <nitrocoro/core/SchedulerStats.h>
 #include <nitrocoro/core/Types.h>
 
 #include <atomic>
@@ -13,9 +17,10 @@
 #include <coroutine>
 #include <functional>
 #include <memory>
-#include <queue>
+#include <source_location>
+#include <span>
 #include <thread>
-#include <unordered_map>
+#include <vector>
 
 namespace nitrocoro
 {
@@ -26,9 +31,16 @@ class Channel;
 }
 
 class Scheduler;
+class StallWatchdog;
+class Poller;
+class TimerWheel;
 
 using TimePoint = std::chrono::steady_clock::time_point;
 
+// Handle for cancelling a timer via Scheduler::cancel_timer(); 0 is never a valid id.
+using TimerId = uint64_t;
+inline constexpr TimerId kInvalidTimerId = 0;
+
 struct [[nodiscard]] TimerAwaiter
 {
     TimerAwaiter(Scheduler * sched, TimePoint when)
@@ -52,20 +64,39 @@ struct [[nodiscard]] SchedulerAwaiter
     void await_resume() noexcept {}
 };
 
+// Ready-queue lane: Background work runs only after the Normal lane is empty.
+enum class Lane
+{
+    Normal,
+    Background
+};
+
+struct [[nodiscard]] YieldAwaiter
+{
+    Scheduler * scheduler_;
+    Lane lane_;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h);
+    void await_resume() noexcept {}
+};
+
 class Scheduler
 {
 public:
-    using IoEventHandler = std::function<void(int, uint32_t)>;
+    // Plain function + context pointer, so dispatching an event costs one indirect call.
+    using IoEventHandler = void (*)(void * context, int fd, uint32_t events);
 
+    // Slot of the fd-indexed table; id 0 marks an unused slot (io ids start at 1).
     struct IoContext
     {
-        int fd;
-        uint64_t id;
-        IoEventHandler handler;
-        bool addedToEpoll = false;
+        uint64_t id{ 0 };
+        IoEventHandler handler{ nullptr };
+        void * context{ nullptr };
+        bool addedToPoller = false;
     };
 
-    Scheduler();
+    explicit Scheduler(PollerType pollerType = PollerType::Epoll);
     ~Scheduler();
 
     Scheduler(const Scheduler &) = delete;
@@ -84,17 +115,94 @@ public:
         uint64_t id{ ++seq };
         return id;
     }
-    void setIoHandler(int fd, uint64_t id, Scheduler::IoEventHandler handler);
+    // @p context must stay valid until removeIo(fd, id) has run.
+    void setIoHandler(int fd, uint64_t id, IoEventHandler handler, void * context);
     void updateIo(int fd, uint64_t id, uint32_t events, TriggerMode mode);
     void removeIo(int fd, uint64_t id);
 
+    /**
+     * Completion-based I/O, offered by PollerType::IoUring: the poller performs
+     * @p op itself and a later poll calls op->onComplete, so a read or write
+     * costs no readiness round trip and no syscall of its own. Returns false,
+     * doing nothing, when the poller cannot take it; wait for readiness then.
+     * Loop thread only.
+     */
+    bool submitIo(IoOperation * op);
+    // Asks the kernel to stop @p op early; onComplete still runs, with
+    // -ECANCELED unless the operation finished first. Loop thread only.
+    void cancelIo(IoOperation * op);
+    bool canSubmitIo() const noexcept { return submitsIo_; }
+
+    /**
+     * Loop time: steady_clock::now() sampled when the loop computes its poll
+     * timeout and again when poll() returns, then reused for the rest of the
+     * iteration. sleep_for()/run_after() measure from it on the loop thread, so
+     * a delay may end early by however long the current iteration has run.
+     * Called from another thread it returns the real clock.
+     */
+    TimePoint now() const noexcept;
+
     TimerAwaiter sleep_for(double seconds);
     TimerAwaiter sleep_for(std::chrono::steady_clock::duration dur);
     TimerAwaiter sleep_until(TimePoint when);
     SchedulerAwaiter switch_to() noexcept;
 
+    // Allocation-free: same-thread handles go to a plain FIFO, cross-thread
+    // ones to a bounded lock-free ring (the generic queue only if it is full).
     void schedule(std::coroutine_handle<> handle);
-    void schedule_at(TimePoint when, std::coroutine_handle<> handle);
+    // Background lane; from another thread this hops through the function queue.
+    void schedule(std::coroutine_handle<> handle, Lane lane);
+    // Queues many continuations with a single wakeup; for producers
+    // completing work in bulk (thread pools, resolvers).
+    void scheduleBatch(std::span<const std::coroutine_handle<>> handles);
+
+    /**
+     * co_await yield() moves the caller to the back of @p lane. It runs again
+     * in the next loop iteration, after I/O and timers have been polled, so a
+     * CPU-heavy loop that yields regularly cannot starve the Scheduler.
+     */
+    YieldAwaiter yield(Lane lane = Lane::Normal) noexcept { return YieldAwaiter{ this, lane }; }
+
+    /**
+     * Per-iteration budget for the ready queues: once @p maxTasks resumes or
+     * @p maxTime have been spent, the rest waits until after the next poll.
+     * Zero means unlimited (the default). Call before run() or on the loop thread.
+     */
+    void setReadyBudget(size_t maxTasks, std::chrono::microseconds maxTime = std::chrono::microseconds::zero());
+
+    /**
+     * Busy-poll: when the loop runs out of work it polls without blocking for
+     * up to @p spin before sleeping in the poller, so an event that arrives
+     * shortly after it goes idle costs no sleep/wakeup round trip. The thread
+     * spins at 100% CPU meanwhile; pair with pinToCpu(). TcpServer listeners
+     * and TcpConnection::connect() on this Scheduler also request SO_BUSY_POLL
+     * with the same budget. Zero disables (the default). Call before run() or
+     * on the loop thread.
+     */
+    void setBusyPoll(std::chrono::microseconds spin);
+    std::chrono::microseconds busyPoll() const noexcept { return busyPoll_; }
+
+    /**
+     * Pins the calling thread, which must be the loop thread, to @p cpu.
+     * Throws std::runtime_error if the CPU is not available to the process.
+     */
+    static void pinToCpu(int cpu);
+
+    /**
+     * Timers: schedule_at() resumes @p handle at @p when, run_at()/run_after()
+     * invoke @p func on this Scheduler's thread (func must not throw).
+     * Called from the Scheduler's own thread they return a TimerId for
+     * cancel_timer(); from other threads they return kInvalidTimerId.
+     */
+    TimerId schedule_at(TimePoint when, std::coroutine_handle<> handle);
+    TimerId run_at(TimePoint when, std::function<void()> func);
+    TimerId run_after(std::chrono::steady_clock::duration delay, std::function<void()> func);
+    // Thread-safe; no-op if the timer already fired or was cancelled.
+    void cancel_timer(TimerId id);
+
+    // Thread-safe snapshot of loop counters; all zero unless built with NITROCORO_SCHEDULER_STATS.
+    SchedulerStats statsSnapshot() const noexcept { return stats_.snapshot(); }
+
     template <typename Func>
     void schedule(Func && func)
     {
@@ -119,8 +227,9 @@ public:
         }
     }
 
+    // @p where is reported by StallWatchdog until the spawned coroutine first resumes from a co_await.
     template <typename Func>
-    void spawn(Func && func)
+    void spawn(Func && func, std::source_location where = std::source_location::current())
     {
         static_assert(is_awaitable_v<std::decay_t<decltype(func())>>);
 
@@ -138,10 +247,18 @@ public:
             FireAndForget & operator=(const FireAndForget &) = delete;
             FireAndForget & operator=(FireAndForget &&) = delete;
 
-            struct promise_type
+            struct StartAwaiter : std::suspend_always
             {
+                promise_type * promise;
+                void await_resume() const noexcept { detail::publishResumeSite(promise->where); }
+            };
+
+            struct promise_type : detail::PooledFrame
+            {
+                std::source_location where;
+
                 FireAndForget get_return_object() noexcept { return handle_type::from_promise(*this); }
-                std::suspend_always initial_suspend() noexcept { return {}; }
+                StartAwaiter initial_suspend() noexcept { return { {}, this }; }
                 void unhandled_exception() { std::terminate(); }
                 void return_void() noexcept {}
                 // do not suspend at final, auto destroy
@@ -153,23 +270,28 @@ public:
             co_await func();
             co_return;
         }(std::forward<Func>(func));
+        task.handle_.promise().where = where;
         schedule(task.handle_);
     }
 
 private:
+    friend class StallWatchdog;
+    friend struct YieldAwaiter;
+
+    // Timer submitted from another thread, moved into the wheel by the loop
     struct Timer
     {
         TimePoint when;
         std::coroutine_handle<> handle;
-
-        bool operator>(const Timer & other) const
-        {
-            return when > other.when;
-        }
+        std::function<void()> func;
     };
 
+    TimerId add_timer(TimePoint when, std::coroutine_handle<> handle, std::function<void()> func);
+
     int64_t get_next_timeout();
     void process_ready_queue();
+    bool drain_normal_lanes(size_t & ran, TimePoint start);
+    bool ready_budget_exhausted(size_t ran, TimePoint start) const;
     void process_timers();
     void process_io_events(int timeout_ms);
     void wakeup();
@@ -177,15 +299,36 @@ private:
     inline static thread_local Scheduler * current_{ nullptr };
 
     std::thread::id threadId_;
-    int epollFd_{ -1 };
+    std::unique_ptr<Poller> poller_;
+    bool submitsIo_{ false };
     int wakeupFd_{ -1 };
     std::atomic<bool> running_{ false };
     std::unique_ptr<io::Channel> wakeupChannel_;
+    std::atomic<bool> wakeupPending_{ false }; // eventfd written and not yet consumed
+
+    static constexpr size_t kRemoteReadyCapacity = 4096;
+
+    IoContext * findIo(int fd, uint64_t id);
 
-    std::unordered_map<int, IoContext> ioContexts_;
+    std::vector<IoContext> ioContexts_; // indexed by fd
+    HandleQueue localReady_;
+    HandleQueue backgroundReady_;
+    HandleQueue yielded_[2]; // per Lane, joined to the lanes at the next drain
+    size_t budgetTasks_{ 0 };
+    std::chrono::microseconds budgetTime_{ 0 };
+    bool readyPending_{ false }; // last drain stopped on the budget
+    std::chrono::microseconds busyPoll_{ 0 };
+    BoundedMpscQueue<std::coroutine_handle<>> remoteReady_{ kRemoteReadyCapacity };
     MpscQueue<std::function<void()>> readyQueue_;
     MpscQueue<Timer> pendingTimers_;
-    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;
+    std::unique_ptr<TimerWheel> timerWheel_;
+    TimePoint loopTime_{};
+    detail::SchedulerStatsRecorder stats_;
+
+    // Stall probe, read by StallWatchdog from its own thread
+    std::atomic<int> watchdogs_{ 0 };
+    std::atomic<int64_t> busySinceNs_{ 0 }; // steady_clock ns when poll() returned, 0 while polling
+    std::atomic<const std::atomic<std::source_location> *> resumeSite_{ nullptr };
 };
 
 // Convenience sleep function for std::chrono::duration
@@ -194,4 +337,10 @@ inline auto sleep(std::chrono::steady_clock::duration dur)
     return Scheduler::current()->sleep_for(dur);
 }
 
+// Convenience yield on the current Scheduler
+inline auto yield(Lane lane = Lane::Normal)
+{
+    return Scheduler::current()->yield(lane);
+}
+
 } // namespace nitrocoro
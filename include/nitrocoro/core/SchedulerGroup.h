@@ -0,0 +1,86 @@
+/**
+ * @file SchedulerGroup.h
+ * @brief A fixed set of Scheduler threads, one event loop per thread
+ */
+#pragma once
+
+#include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/Types.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nitrocoro
+{
+
+/**
+ * @brief Owns N threads, each running its own Scheduler.
+ *
+ * Usage:
+ *   SchedulerGroup group(4);
+ *   group.setCpuAffinity();         // optional: one core per loop
+ *   group.start();                  // blocks until every loop is running
+ *   group.next()->spawn(...);       // round-robin placement
+ *   ...
+ *   group.stop();                   // callable from any thread, any number of times
+ *   group.wait();                   // joins all loop threads
+ *
+ * start() rethrows the first error from setting up a loop (CPU pinning, or a
+ * poller the kernel refuses) after stopping the loops that did start. Only the
+ * first stop() reaches the loops; stop the group rather than its Schedulers.
+ *
+ * Objects bound to a group's Schedulers (TcpServer, Channel, ...) must be
+ * destroyed before stop(), since their destructors post cleanup to the loops.
+ */
+class SchedulerGroup
+{
+public:
+    explicit SchedulerGroup(size_t numThreads = 0, PollerType pollerType = PollerType::Epoll);
+    ~SchedulerGroup();
+
+    SchedulerGroup(const SchedulerGroup &) = delete;
+    SchedulerGroup & operator=(const SchedulerGroup &) = delete;
+
+    /**
+     * Pins loop i to cpus[i % cpus.size()]; with an empty list, to the i-th
+     * CPU the process may run on. Each thread is pinned before its Scheduler
+     * is built, so with Linux's first-touch policy the loop's poller, timer
+     * wheel, frame pool and the buffers it allocates land on that CPU's NUMA
+     * node. Call before start().
+     */
+    void setCpuAffinity(std::vector<int> cpus = {});
+    // Scheduler::setBusyPoll() for every loop; call before start().
+    void setBusyPoll(std::chrono::microseconds spin);
+
+    void start();
+    void stop();
+    // Joins the loop threads; at() and next() must not be used afterwards.
+    void wait();
+
+    size_t size() const noexcept { return numThreads_; }
+    Scheduler * at(size_t index) const { return schedulers_.at(index); }
+    const std::vector<Scheduler *> & schedulers() const noexcept { return schedulers_; }
+
+    // Round-robin over the group's Schedulers; safe to call from any thread
+    // once start() has returned, nullptr before.
+    Scheduler * next() noexcept;
+
+private:
+    size_t numThreads_;
+    PollerType pollerType_;
+    bool pinned_{ false };
+    std::vector<int> cpus_;
+    std::chrono::microseconds busyPoll_{ 0 };
+    std::vector<std::thread> threads_;
+    std::vector<Scheduler *> schedulers_;
+    std::atomic<size_t> nextIndex_{ 0 };
+    bool started_{ false };
+    std::mutex mutex_; // guards stopped_ and the schedulers_ that stop() walks
+    bool stopped_{ false };
+};
+
+} // namespace nitrocoro
@@ -0,0 +1,191 @@
+/**
+ * @file SchedulerStats.h
+ * @brief Per-Scheduler loop counters and latency histograms
+ *
+ * Recording is compiled out when NITROCORO_DISABLE_SCHEDULER_STATS is defined
+ * (CMake option NITROCORO_SCHEDULER_STATS=OFF); snapshots then stay zeroed
+ * with enabled == false.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace nitrocoro
+{
+
+/**
+ * @brief Log2 histogram of microsecond samples.
+ *
+ * Bucket 0 counts samples below 1us, bucket i counts [2^(i-1), 2^i) us; the
+ * last bucket also absorbs everything larger.
+ */
+struct LatencyHistogram
+{
+    static constexpr size_t kBuckets = 32;
+
+    std::array<uint64_t, kBuckets> buckets{};
+    uint64_t count{ 0 };
+    uint64_t totalUs{ 0 };
+    uint64_t maxUs{ 0 };
+
+    double meanUs() const noexcept { return count ? static_cast<double>(totalUs) / count : 0.0; }
+    // Upper edge of the bucket holding the p-quantile (0 <= p <= 1), in microseconds.
+    uint64_t percentileUs(double p) const noexcept;
+};
+
+struct SchedulerStats
+{
+    bool enabled{ false };
+
+    uint64_t iterations{ 0 };
+    uint64_t pollWaitNs{ 0 }; // time blocked in Poller::poll()
+    uint64_t busyNs{ 0 };     // time spent on events, timers and ready coroutines
+
+    uint64_t ioEvents{ 0 };
+    uint64_t maxEventsPerPoll{ 0 };
+
+    uint64_t tasksRun{ 0 };      // coroutine resumes and queued functions executed
+    uint64_t readyDepth{ 0 };    // same-thread ready queue depth at the last drain
+    uint64_t maxReadyDepth{ 0 }; // deepest ready queue seen at the start of a drain
+
+    uint64_t timersPending{ 0 };
+    uint64_t timersFired{ 0 };
+
+    uint64_t wakeups{ 0 }; // cross-thread wakeups written to the eventfd
+
+    LatencyHistogram loopBusy;      // busy time per iteration
+    LatencyHistogram timerLateness; // fire time minus deadline
+};
+
+namespace detail
+{
+
+#ifndef NITROCORO_DISABLE_SCHEDULER_STATS
+
+/**
+ * @brief Recorder owned by a Scheduler.
+ *
+ * Everything except wakeup() is written by the loop thread only, so updates
+ * are plain relaxed load/store pairs; snapshot() may run on any thread and
+ * sees each counter individually consistent.
+ */
+class SchedulerStatsRecorder
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // @p now is the Scheduler's loop time, sampled right before/after poll().
+    void beforePoll(Clock::time_point now) noexcept
+    {
+        if (pollEnd_ != Clock::time_point{})
+        {
+            auto busy = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - pollEnd_).count());
+            bump(busyNs_, busy);
+            loopBusy_.record(busy / 1000);
+        }
+        bump(iterations_);
+        pollStart_ = now;
+    }
+
+    void afterPoll(int events, Clock::time_point now) noexcept
+    {
+        pollEnd_ = now;
+        bump(pollWaitNs_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(pollEnd_ - pollStart_).count()));
+        if (events > 0)
+        {
+            bump(ioEvents_, static_cast<uint64_t>(events));
+            raise(maxEventsPerPoll_, static_cast<uint64_t>(events));
+        }
+    }
+
+    void timerFired(Clock::time_point deadline, Clock::time_point now) noexcept
+    {
+        bump(timersFired_);
+        auto late = now > deadline ? std::chrono::duration_cast<std::chrono::microseconds>(now - deadline).count() : 0;
+        timerLateness_.record(static_cast<uint64_t>(late));
+    }
+
+    void timersPending(size_t count) noexcept { timersPending_.store(count, std::memory_order_relaxed); }
+
+    void readyDepth(size_t depth) noexcept
+    {
+        readyDepth_.store(depth, std::memory_order_relaxed);
+        raise(maxReadyDepth_, depth);
+    }
+
+    void taskRun() noexcept { bump(tasksRun_); }
+
+    // Any thread.
+    void wakeup() noexcept { wakeups_.fetch_add(1, std::memory_order_relaxed); }
+
+    SchedulerStats snapshot() const noexcept;
+
+private:
+    using Counter = std::atomic<uint64_t>;
+
+    static void bump(Counter & c, uint64_t v = 1) noexcept
+    {
+        c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+    static void raise(Counter & c, uint64_t v) noexcept
+    {
+        if (v > c.load(std::memory_order_relaxed))
+            c.store(v, std::memory_order_relaxed);
+    }
+
+    struct Histogram
+    {
+        std::array<Counter, LatencyHistogram::kBuckets> buckets{};
+        Counter count{ 0 };
+        Counter totalUs{ 0 };
+        Counter maxUs{ 0 };
+
+        void record(uint64_t us) noexcept;
+        void load(LatencyHistogram & out) const noexcept;
+    };
+
+    Clock::time_point pollStart_{};
+    Clock::time_point pollEnd_{};
+
+    Counter iterations_{ 0 };
+    Counter pollWaitNs_{ 0 };
+    Counter busyNs_{ 0 };
+    Counter ioEvents_{ 0 };
+    Counter maxEventsPerPoll_{ 0 };
+    Counter tasksRun_{ 0 };
+    Counter readyDepth_{ 0 };
+    Counter maxReadyDepth_{ 0 };
+    Counter timersPending_{ 0 };
+    Counter timersFired_{ 0 };
+    alignas(64) Counter wakeups_{ 0 }; // the only counter written by other threads
+    Histogram loopBusy_;
+    Histogram timerLateness_;
+};
+
+#else
+
+class SchedulerStatsRecorder
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void beforePoll(Clock::time_point) noexcept {}
+    void afterPoll(int, Clock::time_point) noexcept {}
+    void timerFired(Clock::time_point, Clock::time_point) noexcept {}
+    void timersPending(size_t) noexcept {}
+    void readyDepth(size_t) noexcept {}
+    void taskRun() noexcept {}
+    void wakeup() noexcept {}
+
+    SchedulerStats snapshot() const noexcept { return {}; }
+};
+
+#endif
+
+} // namespace detail
+
+} // namespace nitrocoro
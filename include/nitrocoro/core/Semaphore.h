@@ -0,0 +1,190 @@
+/**
+ * @file Semaphore.h
+ * @brief Coroutine-aware counting semaphore
+ *
+ * Acquiring a free permit is a single CAS and releasing with nobody queued is
+ * a single fetch_add. Coroutines that find no permit park on an intrusive FIFO
+ * of awaiters guarded by a small lock, and are resumed on their own Scheduler
+ * as permits come back, so acquire and release may happen on different
+ * threads.
+ */
+#pragma once
+
+#include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/WaiterQueue.h>
+
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+namespace nitrocoro
+{
+
+class Semaphore;
+
+/** A held permit; released when destroyed. */
+class [[nodiscard]] SemaphoreGuard
+{
+public:
+    SemaphoreGuard() noexcept = default;
+    explicit SemaphoreGuard(Semaphore & sem) noexcept
+        : sem_(&sem)
+    {
+    }
+    SemaphoreGuard(SemaphoreGuard && other) noexcept
+        : sem_(std::exchange(other.sem_, nullptr))
+    {
+    }
+    SemaphoreGuard & operator=(SemaphoreGuard && other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            sem_ = std::exchange(other.sem_, nullptr);
+        }
+        return *this;
+    }
+    ~SemaphoreGuard() { reset(); }
+
+    inline void reset() noexcept;
+
+private:
+    Semaphore * sem_{ nullptr };
+};
+
+/**
+ * Counting semaphore for bounding concurrency, e.g. in-flight requests to a
+ * backend:
+ *
+ *   Semaphore slots(16);
+ *   auto permit = co_await slots.scoped_acquire();
+ *
+ * Permits are not strictly FIFO: an acquirer that finds a permit free takes
+ * it even if others are queued; queued waiters are served in arrival order.
+ */
+class Semaphore final
+{
+    class SemaphoreAwaiter;
+    class ScopedSemaphoreAwaiter;
+
+public:
+    explicit Semaphore(std::ptrdiff_t initial) noexcept
+        : count_(initial)
+    {
+    }
+
+    Semaphore(const Semaphore &) = delete;
+    Semaphore & operator=(const Semaphore &) = delete;
+
+    ~Semaphore() { assert(waiters_.empty()); }
+
+    bool try_acquire() noexcept
+    {
+        // seq_cst load: pairs with release() through waiting_, see acquireSlow().
+        std::ptrdiff_t count = count_.load(std::memory_order_seq_cst);
+        while (count > 0)
+        {
+            if (count_.compare_exchange_weak(count, count - 1, std::memory_order_seq_cst))
+                return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] SemaphoreAwaiter acquire(Scheduler * sched = Scheduler::current()) noexcept
+    {
+        return SemaphoreAwaiter(*this, sched);
+    }
+
+    [[nodiscard]] ScopedSemaphoreAwaiter scoped_acquire(Scheduler * sched = Scheduler::current()) noexcept
+    {
+        return ScopedSemaphoreAwaiter(*this, sched);
+    }
+
+    void release(std::ptrdiff_t n = 1)
+    {
+        count_.fetch_add(n, std::memory_order_seq_cst);
+        if (waiting_.load(std::memory_order_seq_cst) > 0)
+            wakeWaiters();
+    }
+
+    /** Free permits at this instant; may be stale by the time it is read. */
+    std::ptrdiff_t available() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+private:
+    class SemaphoreAwaiter : protected detail::SyncWaiter
+    {
+    public:
+        SemaphoreAwaiter(Semaphore & sem, Scheduler * sched) noexcept
+            : sem_(sem)
+        {
+            sched_ = sched;
+        }
+
+        bool await_ready() noexcept { return sem_.try_acquire(); }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            handle_ = handle;
+            return sem_.acquireSlow(this);
+        }
+
+        void await_resume() noexcept {}
+
+    protected:
+        Semaphore & sem_;
+    };
+
+    class ScopedSemaphoreAwaiter : public SemaphoreAwaiter
+    {
+    public:
+        using SemaphoreAwaiter::SemaphoreAwaiter;
+
+        SemaphoreGuard await_resume() noexcept { return SemaphoreGuard(sem_); }
+    };
+
+    // Registers as waiting before rechecking the count, while release()
+    // bumps the count before checking for waiters: with both sides seq_cst,
+    // at least one of them sees the other.
+    bool acquireSlow(detail::SyncWaiter * waiter)
+    {
+        std::lock_guard lock(lock_);
+        waiting_.fetch_add(1, std::memory_order_seq_cst);
+        if (try_acquire())
+        {
+            waiting_.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+        waiters_.push(waiter);
+        return true;
+    }
+
+    void wakeWaiters()
+    {
+        detail::WaiterQueue ready;
+        {
+            std::lock_guard lock(lock_);
+            while (!waiters_.empty() && try_acquire())
+            {
+                ready.push(waiters_.pop());
+                waiting_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        detail::WaiterQueue::resumeAll(ready.release());
+    }
+
+    std::atomic<std::ptrdiff_t> count_;
+    std::atomic<std::ptrdiff_t> waiting_{ 0 };
+    std::mutex lock_;
+    detail::WaiterQueue waiters_;
+};
+
+inline void SemaphoreGuard::reset() noexcept
+{
+    if (sem_)
+        std::exchange(sem_, nullptr)->release();
+}
+
+} // namespace nitrocoro
@@ -0,0 +1,78 @@
+/**
+ * @file StallWatchdog.h
+ * @brief Background thread that reports Schedulers stuck outside poll()
+ */
+#pragma once
+
+#include <nitrocoro/core/Scheduler.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <source_location>
+#include <thread>
+#include <vector>
+
+namespace nitrocoro
+{
+
+class SchedulerGroup;
+
+struct StallReport
+{
+    Scheduler * scheduler;
+    // Time since the loop last returned from poll()
+    std::chrono::steady_clock::duration duration;
+    // co_await the running coroutine last resumed from, or its spawn() call;
+    // empty when built with NITROCORO_RESUME_SITES=OFF
+    std::source_location site;
+};
+
+/**
+ * @brief Detects loop iterations that run longer than a threshold.
+ *
+ * Usage:
+ *   StallWatchdog watchdog(group, std::chrono::milliseconds(100));
+ *
+ * A stall is reported once when it crosses the threshold, then again each
+ * time its duration doubles. The default handler logs via NITRO_ERROR; a
+ * custom handler runs on the watchdog thread and must not block for long.
+ * Watched Schedulers must be running and must outlive the watchdog.
+ */
+class StallWatchdog
+{
+public:
+    using Handler = std::function<void(const StallReport &)>;
+
+    StallWatchdog(std::vector<Scheduler *> schedulers, std::chrono::milliseconds threshold, Handler handler = {});
+    StallWatchdog(const SchedulerGroup & group, std::chrono::milliseconds threshold, Handler handler = {});
+    ~StallWatchdog();
+
+    StallWatchdog(const StallWatchdog &) = delete;
+    StallWatchdog & operator=(const StallWatchdog &) = delete;
+
+    void stop();
+
+private:
+    struct Watched
+    {
+        Scheduler * scheduler;
+        int64_t stallStartNs{ 0 };  // busySince of the stall being tracked
+        int64_t nextReportNs{ 0 };  // duration at which to report it again
+    };
+
+    void run();
+    void check(Watched & watched, int64_t nowNs);
+
+    std::vector<Watched> watched_;
+    std::chrono::milliseconds threshold_;
+    Handler handler_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_{ false };
+    std::thread thread_;
+};
+
+} // namespace nitrocoro
@@ -4,9 +4,13 @@
  */
 #pragma once
 
+#include <nitrocoro/core/FramePool.h>
+#include <nitrocoro/core/ResumeSite.h>
+
 #include <coroutine>
 #include <exception>
 #include <optional>
+#include <source_location>
 
 namespace nitrocoro
 {
@@ -64,7 +68,7 @@ struct [[nodiscard]] Task
     struct promise_type;
     using handle_type = std::coroutine_handle<promise_type>;
 
-    struct promise_type
+    struct promise_type : detail::PooledFrame
     {
         std::coroutine_handle<> continuation_;
         std::optional<T> value_;
@@ -73,6 +77,13 @@ struct [[nodiscard]] Task
         Task get_return_object() { return Task{ handle_type::from_promise(*this) }; }
         std::suspend_always initial_suspend() { return {}; }
         TaskFinalAwaiter<promise_type> final_suspend() noexcept { return {}; }
+#ifndef NITROCORO_DISABLE_RESUME_SITES
+        template <typename U>
+        auto await_transform(U && value, std::source_location site = std::source_location::current())
+        {
+            return detail::withResumeSite(std::forward<U>(value), site);
+        }
+#endif
         void return_value(const T & value) { value_ = value; }
         void return_value(T && value) { value_ = std::move(value); }
         void unhandled_exception() { exception_ = std::current_exception(); }
@@ -128,7 +139,7 @@ struct [[nodiscard]] Task<void>
     struct promise_type;
     using handle_type = std::coroutine_handle<promise_type>;
 
-    struct promise_type
+    struct promise_type : detail::PooledFrame
     {
         std::coroutine_handle<> continuation_;
         std::exception_ptr exception_;
@@ -136,6 +147,13 @@ struct [[nodiscard]] Task<void>
         Task get_return_object() { return Task{ handle_type::from_promise(*this) }; }
         std::suspend_always initial_suspend() { return {}; }
         TaskFinalAwaiter<promise_type> final_suspend() noexcept { return {}; }
+#ifndef NITROCORO_DISABLE_RESUME_SITES
+        template <typename U>
+        auto await_transform(U && value, std::source_location site = std::source_location::current())
+        {
+            return detail::withResumeSite(std::forward<U>(value), site);
+        }
+#endif
         void return_void() {}
         void unhandled_exception() { exception_ = std::current_exception(); }
         void result() const
@@ -0,0 +1,477 @@
+/**
+ * @file TaskGroup.h
+ * @brief Structured concurrency: whenAll, whenAny and TaskGroup
+ */
+#pragma once
+
+#include <nitrocoro/core/CancelToken.h>
+#include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/Task.h>
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace nitrocoro
+{
+
+// Result slot for a Task<T>; void becomes std::monostate so it fits a tuple.
+template <typename T>
+using TaskValue = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+template <typename T>
+struct WhenAnyResult
+{
+    size_t index; // position of the winning task
+    T value;
+};
+
+template <>
+struct WhenAnyResult<void>
+{
+    size_t index;
+};
+
+namespace detail
+{
+
+// Started by hand, destroys itself on completion. Drives one child per group.
+struct [[nodiscard]] DetachedTask
+{
+    struct promise_type : PooledFrame
+    {
+        DetachedTask get_return_object() noexcept { return { std::coroutine_handle<promise_type>::from_promise(*this) }; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * Countdown shared by a parent and its children. The parent holds one count
+ * itself until every child has been started, so children that finish
+ * synchronously never resume it from inside await_suspend().
+ */
+struct JoinLatch
+{
+    std::atomic<size_t> count{ 1 };
+    std::atomic<bool> failed{ false };
+    std::exception_ptr error;
+    std::coroutine_handle<> parent;
+    Scheduler * scheduler{ nullptr };
+
+    // First failure wins; returns true for it.
+    bool fail(std::exception_ptr e) noexcept
+    {
+        if (failed.exchange(true, std::memory_order_relaxed))
+            return false;
+        error = std::move(e);
+        return true;
+    }
+
+    void arrive()
+    {
+        if (count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        if (scheduler)
+            scheduler->schedule(parent);
+        else
+            parent.resume();
+    }
+
+    // Drops the parent's own count; false means everything already finished.
+    bool suspendParent(std::coroutine_handle<> h)
+    {
+        parent = h;
+        scheduler = Scheduler::current();
+        return count.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+};
+
+template <typename T>
+DetachedTask whenAllChild(Task<T> & task, std::optional<TaskValue<T>> & slot, JoinLatch & latch)
+{
+    try
+    {
+        if constexpr (std::is_void_v<T>)
+        {
+            co_await task;
+            slot.emplace();
+        }
+        else
+        {
+            slot.emplace(co_await task);
+        }
+    }
+    catch (...)
+    {
+        latch.fail(std::current_exception());
+    }
+    latch.arrive();
+}
+
+template <typename... Ts>
+class [[nodiscard]] WhenAllAwaiter
+{
+public:
+    explicit WhenAllAwaiter(Task<Ts> &&... tasks)
+        : tasks_(std::move(tasks)...)
+    {
+    }
+
+    bool await_ready() const noexcept { return sizeof...(Ts) == 0; }
+
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+        latch_.count.fetch_add(sizeof...(Ts), std::memory_order_relaxed);
+        startAll(std::index_sequence_for<Ts...>{});
+        return latch_.suspendParent(h);
+    }
+
+    std::tuple<TaskValue<Ts>...> await_resume()
+    {
+        if (latch_.error)
+            std::rethrow_exception(latch_.error);
+        return collect(std::index_sequence_for<Ts...>{});
+    }
+
+private:
+    template <size_t... I>
+    void startAll(std::index_sequence<I...>)
+    {
+        (whenAllChild(std::get<I>(tasks_), std::get<I>(results_), latch_).handle.resume(), ...);
+    }
+
+    template <size_t... I>
+    std::tuple<TaskValue<Ts>...> collect(std::index_sequence<I...>)
+    {
+        return { std::move(*std::get<I>(results_))... };
+    }
+
+    std::tuple<Task<Ts>...> tasks_;
+    std::tuple<std::optional<TaskValue<Ts>>...> results_;
+    JoinLatch latch_;
+};
+
+template <typename T>
+class [[nodiscard]] WhenAllRangeAwaiter
+{
+public:
+    explicit WhenAllRangeAwaiter(std::vector<Task<T>> tasks)
+        : tasks_(std::move(tasks)), results_(tasks_.size())
+    {
+    }
+
+    bool await_ready() const noexcept { return tasks_.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+        latch_.count.fetch_add(tasks_.size(), std::memory_order_relaxed);
+        for (size_t i = 0; i < tasks_.size(); ++i)
+            whenAllChild(tasks_[i], results_[i], latch_).handle.resume();
+        return latch_.suspendParent(h);
+    }
+
+    auto await_resume()
+    {
+        if (latch_.error)
+            std::rethrow_exception(latch_.error);
+        if constexpr (!std::is_void_v<T>)
+        {
+            std::vector<T> values;
+            values.reserve(results_.size());
+            for (auto & slot : results_)
+                values.push_back(std::move(*slot));
+            return values;
+        }
+    }
+
+private:
+    std::vector<Task<T>> tasks_;
+    std::vector<std::optional<TaskValue<T>>> results_;
+    JoinLatch latch_;
+};
+
+// Heap state of a whenAny; losers keep it alive after the winner resumes the parent.
+template <typename T>
+struct WhenAnyState
+{
+    std::atomic<size_t> refs{ 1 };
+    std::atomic<bool> decided{ false };
+    size_t index{ 0 };
+    std::optional<TaskValue<T>> value;
+    std::exception_ptr error;
+    std::coroutine_handle<> parent;
+    Scheduler * scheduler{ nullptr };
+    std::optional<CancelSource> losers;
+    std::vector<Task<T>> tasks;
+
+    void release()
+    {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+};
+
+template <typename T>
+DetachedTask whenAnyChild(WhenAnyState<T> * state, size_t index)
+{
+    std::optional<TaskValue<T>> value;
+    std::exception_ptr error;
+    try
+    {
+        if constexpr (std::is_void_v<T>)
+        {
+            co_await state->tasks[index];
+            value.emplace();
+        }
+        else
+        {
+            value.emplace(co_await state->tasks[index]);
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    if (!state->decided.exchange(true, std::memory_order_acq_rel))
+    {
+        state->index = index;
+        state->value = std::move(value);
+        state->error = std::move(error);
+        if (state->losers)
+            state->losers->cancel();
+        state->scheduler->schedule(state->parent);
+    }
+    state->release();
+}
+
+template <typename T>
+class [[nodiscard]] WhenAnyAwaiter
+{
+public:
+    WhenAnyAwaiter(std::vector<Task<T>> tasks, std::optional<CancelSource> losers)
+        : state_(new WhenAnyState<T>())
+    {
+        state_->tasks = std::move(tasks);
+        state_->losers = std::move(losers);
+    }
+
+    WhenAnyAwaiter(WhenAnyAwaiter && other) noexcept
+        : state_(std::exchange(other.state_, nullptr))
+    {
+    }
+
+    WhenAnyAwaiter(const WhenAnyAwaiter &) = delete;
+    WhenAnyAwaiter & operator=(const WhenAnyAwaiter &) = delete;
+    WhenAnyAwaiter & operator=(WhenAnyAwaiter &&) = delete;
+
+    ~WhenAnyAwaiter()
+    {
+        if (state_)
+            state_->release();
+    }
+
+    bool await_ready() const
+    {
+        if (state_->tasks.empty())
+            throw std::invalid_argument("whenAny: no tasks");
+        return false;
+    }
+
+    // Children run inline until they first suspend; the winner always resumes
+    // the parent through its Scheduler, never from inside this call.
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        state_->parent = h;
+        state_->scheduler = Scheduler::current();
+        size_t n = state_->tasks.size();
+        state_->refs.fetch_add(n, std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i)
+            whenAnyChild(state_, i).handle.resume();
+    }
+
+    WhenAnyResult<T> await_resume()
+    {
+        if (state_->error)
+            std::rethrow_exception(state_->error);
+        if constexpr (std::is_void_v<T>)
+            return { state_->index };
+        else
+            return { state_->index, std::move(*state_->value) };
+    }
+
+private:
+    WhenAnyState<T> * state_;
+};
+
+// One allocation per TaskGroup: children share it with the group object.
+struct TaskGroupState
+{
+    JoinLatch latch;
+    CancelSource source;
+
+    explicit TaskGroupState(Scheduler * scheduler)
+        : source(scheduler)
+    {
+    }
+
+    void fail(std::exception_ptr e)
+    {
+        if (latch.fail(std::move(e)))
+            source.cancel();
+    }
+};
+
+template <typename Fn>
+DetachedTask taskGroupChild(std::shared_ptr<TaskGroupState> state, Fn fn)
+{
+    try
+    {
+        if constexpr (std::is_invocable_v<Fn &, CancelToken>)
+            co_await fn(state->source.token());
+        else
+            co_await fn();
+    }
+    catch (...)
+    {
+        state->fail(std::current_exception());
+    }
+    state->latch.arrive();
+}
+
+} // namespace detail
+
+/**
+ * co_await whenAll(a(), b(), c()) runs the tasks concurrently on the current
+ * Scheduler and yields a tuple of their results (std::monostate for void).
+ * It always waits for every task; the first exception is rethrown afterwards.
+ * The shared state lives in the awaiter, so the only allocations are the
+ * per-child driver frames, which come from the frame pool.
+ */
+template <typename... Ts>
+auto whenAll(Task<Ts>... tasks)
+{
+    return detail::WhenAllAwaiter<Ts...>(std::move(tasks)...);
+}
+
+// Yields std::vector<T>, or nothing for Task<void>.
+template <typename T>
+auto whenAll(std::vector<Task<T>> tasks)
+{
+    return detail::WhenAllRangeAwaiter<T>(std::move(tasks));
+}
+
+/**
+ * Resumes as soon as the first task completes, with its index and result
+ * (its exception is rethrown). The other tasks keep running detached and
+ * their results are dropped; pass a CancelSource whose tokens they observe to
+ * have it cancelled the moment a winner is known.
+ */
+template <typename T>
+auto whenAny(std::vector<Task<T>> tasks)
+{
+    return detail::WhenAnyAwaiter<T>(std::move(tasks), std::nullopt);
+}
+
+template <typename T>
+auto whenAny(CancelSource losers, std::vector<Task<T>> tasks)
+{
+    return detail::WhenAnyAwaiter<T>(std::move(tasks), std::move(losers));
+}
+
+template <typename T, typename... Rest>
+auto whenAny(Task<T> first, Task<Rest>... rest)
+{
+    static_assert((std::is_same_v<T, Rest> && ...), "whenAny: all tasks must have the same result type");
+    std::vector<Task<T>> tasks;
+    tasks.reserve(1 + sizeof...(Rest));
+    tasks.push_back(std::move(first));
+    (tasks.push_back(std::move(rest)), ...);
+    return whenAny(std::move(tasks));
+}
+
+/**
+ * @brief Nursery for a dynamic set of child coroutines.
+ *
+ * Usage:
+ *   TaskGroup group;
+ *   for (auto & shard : shards)
+ *       group.spawn([&](CancelToken token) -> Task<> { co_await query(shard, token); }, loops.next());
+ *   co_await group.join();
+ *
+ * spawn() accepts a callable returning an awaitable, invoked with the group's
+ * CancelToken when it takes one. Children start on @p where (default: the
+ * calling Scheduler), so a fan-out can spread over a SchedulerGroup. The first
+ * child to throw cancels the token; join() waits for every child and rethrows
+ * that exception. Destroying a group without joining cancels the token and
+ * lets the children finish on their own.
+ */
+class TaskGroup
+{
+public:
+    explicit TaskGroup(Scheduler * scheduler = Scheduler::current())
+        : state_(std::make_shared<detail::TaskGroupState>(scheduler))
+    {
+    }
+
+    ~TaskGroup()
+    {
+        if (state_ && state_->latch.count.load(std::memory_order_acquire) > 1)
+            state_->source.cancel();
+    }
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup & operator=(const TaskGroup &) = delete;
+
+    template <typename Fn>
+    void spawn(Fn && fn, Scheduler * where = nullptr)
+    {
+        if (!where)
+            where = Scheduler::current();
+        state_->latch.count.fetch_add(1, std::memory_order_relaxed);
+        auto child = detail::taskGroupChild(state_, std::forward<Fn>(fn));
+        where->schedule(child.handle);
+    }
+
+    CancelToken token() const { return state_->source.token(); }
+    void cancel() { state_->source.cancel(); }
+    bool isCancelled() const noexcept { return state_->source.isCancelled(); }
+
+    struct [[nodiscard]] JoinAwaiter
+    {
+        detail::TaskGroupState * state_;
+
+        bool await_ready() const noexcept { return state_->latch.count.load(std::memory_order_acquire) == 1; }
+        bool await_suspend(std::coroutine_handle<> h) { return state_->latch.suspendParent(h); }
+        void await_resume()
+        {
+            // Re-arm so the group can be reused; a cancelled token stays cancelled.
+            state_->latch.count.store(1, std::memory_order_relaxed);
+            state_->latch.failed.store(false, std::memory_order_relaxed);
+            if (state_->latch.error)
+                std::rethrow_exception(std::exchange(state_->latch.error, nullptr));
+        }
+    };
+
+    // Waits for all children spawned so far. Only one join() at a time.
+    JoinAwaiter join() { return JoinAwaiter{ state_.get() }; }
+
+private:
+    std::shared_ptr<detail::TaskGroupState> state_;
+};
+
+} // namespace nitrocoro
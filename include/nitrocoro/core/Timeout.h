@@ -5,15 +5,17 @@
 #pragma once
 
 #include <nitrocoro/core/CoroTraits.h>
+#include <nitrocoro/core/FramePool.h>
 #include <nitrocoro/core/Scheduler.h>
 #include <nitrocoro/core/Task.h>
 
 #include <atomic>
 #include <chrono>
 #include <coroutine>
-#include <memory>
+#include <exception>
 #include <optional>
 #include <stdexcept>
+#include <utility>
 
 namespace nitrocoro
 {
@@ -27,109 +29,159 @@ struct TimeoutException : std::runtime_error
 namespace detail
 {
 
-// Shared state between the inner task and the timer.
-template <typename T>
-struct TimeoutState
+/**
+ * Race between the awaited operation and a Scheduler timer. The state lives
+ * in the promise of the single driver coroutine (a pooled frame), shared by
+ * the driver and the caller's awaiter through a two-count reference.
+ */
+struct TimeoutRaceBase
 {
+    std::atomic<int> refs_{ 2 };       // driver + awaiter
     std::atomic<bool> done_{ false }; // first to win sets this
+    bool timedOut_{ false };
     std::coroutine_handle<> caller_;
-    std::optional<T> value_;
+    Scheduler * sched_{ nullptr };
+    TimerId timerId_{ kInvalidTimerId };
     std::exception_ptr exception_;
-    bool timed_out_{ false };
-};
 
-template <>
-struct TimeoutState<void>
-{
-    std::atomic<bool> done_{ false };
-    std::coroutine_handle<> caller_;
-    std::exception_ptr exception_;
-    bool timed_out_{ false };
-};
+    // Timer callback, on the caller's Scheduler.
+    void expire()
+    {
+        if (done_.exchange(true, std::memory_order_acq_rel))
+            return;
+        timedOut_ = true;
+        sched_->schedule(caller_);
+    }
 
-// Timer coroutine: fires after deadline, resumes caller if it wins the race.
-template <typename T>
-Task<> timeoutTimer(std::shared_ptr<TimeoutState<T>> state, TimePoint deadline)
-{
-    co_await Scheduler::current()->sleep_until(deadline);
-    bool expected = false;
-    if (state->done_.compare_exchange_strong(expected, true))
+    // The operation finished; resumes the caller if it beat the timer.
+    void finish()
     {
-        state->timed_out_ = true;
-        Scheduler::current()->schedule(state->caller_);
+        if (!done_.exchange(true, std::memory_order_acq_rel))
+            sched_->schedule(caller_);
     }
-}
 
-// Inner task: co_awaits the original awaitable, resumes caller if it wins.
-template <typename Awaitable, typename T>
-Task<> timeoutInner(std::shared_ptr<TimeoutState<T>> state, Awaitable awaitable)
+    bool release() noexcept { return refs_.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+};
+
+template <typename T>
+struct TimeoutDriver
 {
-    try
+    struct promise_type;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    struct FinalAwaiter
     {
-        if constexpr (std::is_void_v<T>)
-        {
-            co_await std::move(awaitable);
-        }
-        else
+        bool await_ready() noexcept { return false; }
+        void await_suspend(handle_type h) noexcept
         {
-            state->value_ = co_await std::move(awaitable);
+            auto & race = h.promise();
+            race.finish();
+            if (race.release())
+                h.destroy();
         }
-    }
-    catch (...)
+        void await_resume() noexcept {}
+    };
+
+    struct PromiseBase : PooledFrame, TimeoutRaceBase
     {
-        state->exception_ = std::current_exception();
-    }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+    };
 
-    bool expected = false;
-    if (state->done_.compare_exchange_strong(expected, true))
+    struct promise_type : PromiseBase
     {
-        Scheduler::current()->schedule(state->caller_);
-    }
+        std::optional<T> value_;
+
+        TimeoutDriver get_return_object() noexcept { return { handle_type::from_promise(*this) }; }
+        template <typename U>
+        void return_value(U && value) { value_.emplace(std::forward<U>(value)); }
+    };
+
+    handle_type handle_;
+};
+
+template <>
+struct TimeoutDriver<void>::promise_type : TimeoutDriver<void>::PromiseBase
+{
+    TimeoutDriver get_return_object() noexcept { return { handle_type::from_promise(*this) }; }
+    void return_void() noexcept {}
+};
+
+template <typename T, typename Awaitable>
+TimeoutDriver<T> runWithTimeout(Awaitable awaitable)
+{
+    if constexpr (std::is_void_v<T>)
+        co_await std::move(awaitable);
+    else
+        co_return co_await std::move(awaitable);
 }
 
 template <typename Awaitable>
 struct [[nodiscard]] TimeoutAwaiter
 {
     using T = await_result_t<Awaitable>;
+    using Driver = TimeoutDriver<T>;
 
-    Awaitable awaitable_;
+    typename Driver::handle_type driver_;
     TimePoint deadline_;
-    std::shared_ptr<TimeoutState<T>> state_;
+    bool started_{ false };
 
     TimeoutAwaiter(Awaitable && a, TimePoint deadline)
-        : awaitable_(std::forward<Awaitable>(a))
+        : driver_(runWithTimeout<T, Awaitable>(std::forward<Awaitable>(a)).handle_)
         , deadline_(deadline)
-        , state_(std::make_shared<TimeoutState<T>>())
     {
     }
 
+    TimeoutAwaiter(const TimeoutAwaiter &) = delete;
+    TimeoutAwaiter & operator=(const TimeoutAwaiter &) = delete;
+
+    ~TimeoutAwaiter()
+    {
+        if (!driver_)
+            return;
+        if (!started_ || driver_.promise().release())
+            driver_.destroy();
+    }
+
     bool await_ready() const noexcept { return false; }
 
-    void await_suspend(std::coroutine_handle<> h)
+    // The operation starts inline through symmetric transfer; whichever of it
+    // and the timer finishes first schedules the caller.
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> h)
     {
-        state_->caller_ = h;
-        auto * sched = Scheduler::current();
-        sched->spawn([state = state_, awaitable = std::move(awaitable_)]() mutable -> Task<> {
-            co_await timeoutInner<Awaitable, T>(state, std::move(awaitable));
-        });
-        sched->spawn([state = state_, deadline = deadline_]() mutable -> Task<> {
-            co_await timeoutTimer<T>(state, deadline);
-        });
+        auto & race = driver_.promise();
+        race.caller_ = h;
+        race.sched_ = Scheduler::current();
+        race.timerId_ = race.sched_->run_at(deadline_, [&race]() { race.expire(); });
+        started_ = true;
+        return driver_;
     }
 
     auto await_resume()
     {
-        if (state_->timed_out_)
+        auto & promise = driver_.promise();
+        // Back on the timer's thread: once cancelled it can no longer touch the promise.
+        promise.sched_->cancel_timer(promise.timerId_);
+        if (promise.timedOut_)
             throw TimeoutException{};
-        if (state_->exception_)
-            std::rethrow_exception(state_->exception_);
+        if (promise.exception_)
+            std::rethrow_exception(promise.exception_);
         if constexpr (!std::is_void_v<T>)
-            return std::move(*state_->value_);
+            return std::move(*promise.value_);
     }
 };
 
 } // namespace detail
 
+/**
+ * co_await withTimeout(op, 0.5) throws TimeoutException if @p a has not
+ * completed by then. On expiry the operation is abandoned, not cancelled: it
+ * keeps running and its result is discarded. Costs one pooled coroutine frame
+ * and one Scheduler timer, which is cancelled when the operation wins. For
+ * socket reads and writes prefer the deadline overloads on TcpConnection,
+ * which cancel the pending wait itself.
+ */
 template <typename Awaitable>
 auto withTimeout(Awaitable && a, double seconds)
 {
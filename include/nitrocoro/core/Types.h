@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 namespace nitrocoro
 {
 
@@ -9,4 +12,33 @@ enum class TriggerMode
     LevelTriggered
 };
 
+// I/O backend used by a Scheduler
+enum class PollerType
+{
+    Epoll,
+    IoUring // io_uring: batched POLL_ADD readiness plus submitted reads/writes, Linux 5.13+
+};
+
+/**
+ * A read or write carried out by the poller itself instead of on readiness
+ * (see Scheduler::submitIo()). It must stay valid until onComplete runs on
+ * the loop thread with the syscall's result: bytes transferred, or -errno.
+ */
+struct IoOperation
+{
+    enum class Kind : uint8_t
+    {
+        Read,
+        Write,
+        Readv, // buf is an iovec array, len its count
+        Writev
+    };
+
+    Kind kind{ Kind::Read };
+    int fd{ -1 };
+    void * buf{ nullptr };
+    size_t len{ 0 };
+    void (*onComplete)(IoOperation * op, int result){ nullptr };
+};
+
 };
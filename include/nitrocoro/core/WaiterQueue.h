@@ -0,0 +1,105 @@
+/**
+ * @file WaiterQueue.h
+ * @brief Intrusive awaiter nodes shared by the coroutine synchronization primitives.
+ *
+ * SyncWaiter is embedded in each awaiter object (which lives in the awaiting
+ * coroutine's frame), so waiting never allocates. WaiterQueue is a plain FIFO
+ * of such nodes for primitives that guard their slow path with a lock;
+ * the lock-free ones (Event, Latch, Barrier) use ListWaiter with a
+ * LockFreeListNode list instead.
+ */
+#pragma once
+
+#include <nitrocoro/core/LockFreeList.h>
+#include <nitrocoro/core/Scheduler.h>
+
+#include <coroutine>
+
+namespace nitrocoro::detail
+{
+
+inline void resumeOn(Scheduler * sched, std::coroutine_handle<> handle)
+{
+    if (sched)
+        sched->schedule(handle);
+    else
+        handle.resume();
+}
+
+struct SyncWaiter
+{
+    std::coroutine_handle<> handle_;
+    Scheduler * sched_{ nullptr };
+    SyncWaiter * next_{ nullptr };
+};
+
+class WaiterQueue
+{
+public:
+    bool empty() const noexcept { return head_ == nullptr; }
+
+    void push(SyncWaiter * waiter) noexcept
+    {
+        waiter->next_ = nullptr;
+        if (tail_)
+            tail_->next_ = waiter;
+        else
+            head_ = waiter;
+        tail_ = waiter;
+    }
+
+    SyncWaiter * pop() noexcept
+    {
+        SyncWaiter * waiter = head_;
+        if (waiter)
+        {
+            head_ = waiter->next_;
+            if (!head_)
+                tail_ = nullptr;
+        }
+        return waiter;
+    }
+
+    // Resumes a chain built with push(); call with no lock held.
+    static void resumeAll(SyncWaiter * head)
+    {
+        while (head)
+        {
+            SyncWaiter * next = head->next_;
+            resumeOn(head->sched_, head->handle_);
+            head = next;
+        }
+    }
+
+    SyncWaiter * release() noexcept
+    {
+        SyncWaiter * head = head_;
+        head_ = tail_ = nullptr;
+        return head;
+    }
+
+private:
+    SyncWaiter * head_{ nullptr };
+    SyncWaiter * tail_{ nullptr };
+};
+
+struct ListWaiter : LockFreeListNode
+{
+    std::coroutine_handle<> handle_;
+    Scheduler * sched_{ nullptr };
+
+    // Resumes every node of a list taken with exchange()/close(), skipping @p except.
+    static void resumeAll(LockFreeListNode * node, const ListWaiter * except = nullptr)
+    {
+        while (node != nullptr && node != kClosed)
+        {
+            auto * next = node->next_;
+            auto * waiter = static_cast<ListWaiter *>(node);
+            if (waiter != except)
+                resumeOn(waiter->sched_, waiter->handle_);
+            node = next;
+        }
+    }
+};
+
+} // namespace nitrocoro::detail
@@ -0,0 +1,340 @@
+/**
+ * @file WorkStealingExecutor.h
+ * @brief Work-stealing CPU executor with a coroutine bridge and parallel algorithms
+ */
+#pragma once
+
+#include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/Task.h>
+#include <nitrocoro/utils/TaskQueue.h>
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nitrocoro
+{
+
+class WorkStealingExecutor;
+
+namespace detail
+{
+
+// Intrusive unit of work. The executor only stores pointers; whoever submits
+// a job owns its storage until execute() has been called.
+struct ExecutorJob
+{
+    void (*execute)(ExecutorJob *) = nullptr;
+};
+
+// Completion of a set of jobs awaited by one coroutine.
+struct ExecutorJobGroup
+{
+    std::atomic<size_t> remaining{ 0 };
+    std::atomic<bool> failed{ false };
+    std::exception_ptr error;
+    Scheduler * scheduler{ nullptr };
+    std::coroutine_handle<> waiter;
+
+    void fail(std::exception_ptr e) noexcept
+    {
+        if (!failed.exchange(true, std::memory_order_relaxed))
+            error = std::move(e);
+    }
+
+    // The last job to finish resumes the waiter on its Scheduler.
+    void finishOne()
+    {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        if (scheduler)
+            scheduler->schedule(waiter);
+        else
+            waiter.resume();
+    }
+};
+
+// Chunk [begin, end) of a parallel algorithm; slot is the chunk index.
+template <typename Body>
+struct RangeJob : ExecutorJob
+{
+    Body * body;
+    ExecutorJobGroup * group;
+    size_t begin;
+    size_t end;
+    size_t slot;
+
+    static void run(ExecutorJob * job)
+    {
+        auto * self = static_cast<RangeJob *>(job);
+        ExecutorJobGroup * group = self->group;
+        try
+        {
+            if (!group->failed.load(std::memory_order_relaxed))
+                (*self->body)(self->begin, self->end, self->slot);
+        }
+        catch (...)
+        {
+            group->fail(std::current_exception());
+        }
+        group->finishOne();
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Pool of CPU worker threads that balance load by stealing.
+ *
+ * Each worker owns a Chase-Lev deque: work spawned on a worker is pushed to
+ * and popped from its own end without synchronisation beyond a fence, and
+ * idle workers steal from the other end. Submissions from other threads (an
+ * I/O loop, DnsResolver) go through a lock-free injection ring. Idle workers
+ * spin briefly, then park on an atomic wait.
+ *
+ * Usage from a coroutine on a Scheduler:
+ *   WorkStealingExecutor cpu;
+ *   auto thumb = co_await cpu.run([&] { return resize(image); });
+ *   co_await cpu.parallel_for(0, rows.size(), [&](size_t i) { process(rows[i]); });
+ *
+ * The awaiting coroutine resumes on the Scheduler it suspended on; exceptions
+ * thrown by the work are rethrown there. Awaited from a thread without a
+ * Scheduler, it resumes on the worker that finished the work.
+ *
+ * Also a TaskQueue, so it can replace ThreadPool via defaultTaskQueueProvider().
+ * Work still queued at destruction is dropped; callers must not destroy the
+ * executor while coroutines are awaiting it.
+ */
+class WorkStealingExecutor final : public TaskQueue
+{
+public:
+    explicit WorkStealingExecutor(size_t threadNum = 0);
+    ~WorkStealingExecutor() override;
+
+    void post(std::function<void()> task) override;
+
+    size_t size() const noexcept { return workers_.size(); }
+
+    /**
+     * Runs @p fn on a worker; co_await yields its result on the calling
+     * Scheduler. The job lives in the awaiter, so offloading does not allocate.
+     */
+    template <typename Fn>
+    auto run(Fn && fn);
+
+    /** Calls fn(i) for every i in [begin, end). @p grain is the minimum chunk size. */
+    template <typename Fn>
+    Task<> parallel_for(size_t begin, size_t end, Fn fn, size_t grain = 0);
+
+    /** out[i] = fn(in[i]); @p out must be at least as large as @p in. */
+    template <typename In, typename Out, typename Fn>
+    Task<> parallel_transform(std::span<In> in, std::span<Out> out, Fn fn, size_t grain = 0);
+
+    /**
+     * Folds map(i) for i in [begin, end) into @p init with @p reduce, which
+     * must be associative; chunks are combined in index order.
+     */
+    template <typename T, typename Map, typename Reduce>
+    Task<T> parallel_reduce(size_t begin, size_t end, T init, Map map, Reduce reduce, size_t grain = 0);
+
+    // Any thread. On a worker of this executor the job goes to its own deque.
+    void submit(detail::ExecutorJob * job);
+    void submit(std::span<detail::ExecutorJob * const> jobs);
+
+private:
+    struct Worker;
+    struct Injector;
+
+    template <typename Fn>
+    class RunAwaiter;
+
+    template <typename Body>
+    class RangeAwaiter;
+
+    template <typename Body>
+    RangeAwaiter<Body> forRange(size_t begin, size_t end, size_t grain, Body & body);
+
+    size_t chunkCount(size_t n, size_t grain) const noexcept;
+
+    void workerLoop(size_t index);
+    detail::ExecutorJob * findJob(Worker & self);
+    void wake(size_t jobs);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::unique_ptr<Injector> injector_;
+    std::atomic<bool> stop_{ false };
+    alignas(64) std::atomic<uint32_t> epoch_{ 0 };
+    std::atomic<uint32_t> sleepers_{ 0 };
+};
+
+template <typename Fn>
+class [[nodiscard]] WorkStealingExecutor::RunAwaiter : private detail::ExecutorJob
+{
+    using Result = std::remove_cvref_t<std::invoke_result_t<Fn &>>;
+    using Storage = std::conditional_t<std::is_void_v<Result>, bool, std::optional<Result>>;
+
+public:
+    RunAwaiter(WorkStealingExecutor & executor, Fn fn)
+        : executor_(executor), fn_(std::move(fn))
+    {
+        execute = &RunAwaiter::run;
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        waiter_ = h;
+        scheduler_ = Scheduler::current();
+        executor_.submit(this);
+    }
+
+    Result await_resume()
+    {
+        if (error_)
+            std::rethrow_exception(error_);
+        if constexpr (!std::is_void_v<Result>)
+            return std::move(*storage_);
+    }
+
+private:
+    static void run(detail::ExecutorJob * job)
+    {
+        auto * self = static_cast<RunAwaiter *>(job);
+        try
+        {
+            if constexpr (std::is_void_v<Result>)
+                self->fn_();
+            else
+                self->storage_.emplace(self->fn_());
+        }
+        catch (...)
+        {
+            self->error_ = std::current_exception();
+        }
+        // The awaiter may be destroyed as soon as the waiter resumes.
+        if (Scheduler * scheduler = self->scheduler_)
+            scheduler->schedule(self->waiter_);
+        else
+            self->waiter_.resume();
+    }
+
+    WorkStealingExecutor & executor_;
+    Fn fn_;
+    Storage storage_{};
+    std::exception_ptr error_;
+    Scheduler * scheduler_{ nullptr };
+    std::coroutine_handle<> waiter_;
+};
+
+template <typename Body>
+class [[nodiscard]] WorkStealingExecutor::RangeAwaiter
+{
+public:
+    RangeAwaiter(WorkStealingExecutor & executor, size_t begin, size_t end, size_t chunks, Body & body)
+        : executor_(executor)
+    {
+        jobs_.resize(chunks);
+        group_.remaining.store(chunks, std::memory_order_relaxed);
+        size_t n = end - begin;
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            auto & job = jobs_[i];
+            job.execute = &detail::RangeJob<Body>::run;
+            job.body = &body;
+            job.group = &group_;
+            job.begin = begin + n * i / chunks;
+            job.end = begin + n * (i + 1) / chunks;
+            job.slot = i;
+        }
+    }
+
+    bool await_ready() const noexcept { return jobs_.empty(); }
+
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        group_.waiter = h;
+        group_.scheduler = Scheduler::current();
+        std::vector<detail::ExecutorJob *> ptrs;
+        ptrs.reserve(jobs_.size());
+        for (auto & job : jobs_)
+            ptrs.push_back(&job);
+        executor_.submit(ptrs);
+    }
+
+    void await_resume()
+    {
+        if (group_.error)
+            std::rethrow_exception(group_.error);
+    }
+
+private:
+    WorkStealingExecutor & executor_;
+    std::vector<detail::RangeJob<Body>> jobs_;
+    detail::ExecutorJobGroup group_;
+};
+
+template <typename Fn>
+auto WorkStealingExecutor::run(Fn && fn)
+{
+    return RunAwaiter<std::decay_t<Fn>>(*this, std::forward<Fn>(fn));
+}
+
+template <typename Body>
+WorkStealingExecutor::RangeAwaiter<Body> WorkStealingExecutor::forRange(size_t begin, size_t end, size_t grain, Body & body)
+{
+    size_t chunks = end > begin ? chunkCount(end - begin, grain) : 0;
+    return RangeAwaiter<Body>(*this, begin, end, chunks, body);
+}
+
+template <typename Fn>
+Task<> WorkStealingExecutor::parallel_for(size_t begin, size_t end, Fn fn, size_t grain)
+{
+    auto body = [&fn](size_t first, size_t last, size_t) {
+        for (size_t i = first; i < last; ++i)
+            fn(i);
+    };
+    co_await forRange(begin, end, grain, body);
+}
+
+template <typename In, typename Out, typename Fn>
+Task<> WorkStealingExecutor::parallel_transform(std::span<In> in, std::span<Out> out, Fn fn, size_t grain)
+{
+    if (out.size() < in.size())
+        throw std::invalid_argument("parallel_transform: output span is smaller than input");
+    auto body = [&](size_t first, size_t last, size_t) {
+        for (size_t i = first; i < last; ++i)
+            out[i] = fn(in[i]);
+    };
+    co_await forRange(0, in.size(), grain, body);
+}
+
+template <typename T, typename Map, typename Reduce>
+Task<T> WorkStealingExecutor::parallel_reduce(size_t begin, size_t end, T init, Map map, Reduce reduce, size_t grain)
+{
+    std::vector<std::optional<T>> partials(end > begin ? chunkCount(end - begin, grain) : 0);
+    auto body = [&](size_t first, size_t last, size_t slot) {
+        T acc = map(first);
+        for (size_t i = first + 1; i < last; ++i)
+            acc = reduce(std::move(acc), map(i));
+        partials[slot].emplace(std::move(acc));
+    };
+    co_await forRange(begin, end, grain, body);
+
+    T result = std::move(init);
+    for (auto & partial : partials)
+        result = reduce(std::move(result), std::move(*partial));
+    co_return result;
+}
+
+} // namespace nitrocoro
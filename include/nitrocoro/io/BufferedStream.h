@@ -0,0 +1,110 @@
+/**
+ * @file BufferedStream.h
+ * @brief Stream adapter with read-ahead and write coalescing
+ */
+#pragma once
+
+#include <nitrocoro/core/Mutex.h>
+#include <nitrocoro/core/Task.h>
+#include <nitrocoro/io/Stream.h>
+#include <nitrocoro/utils/BufferPool.h>
+#include <nitrocoro/utils/IoBuffer.h>
+
+#include <exception>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace nitrocoro
+{
+class Scheduler;
+}
+
+namespace nitrocoro::io
+{
+
+class BufferedStream;
+using BufferedStreamPtr = std::shared_ptr<BufferedStream>;
+
+/**
+ * @brief Buffers an io::Stream in both directions; itself a StreamConcept.
+ *
+ * Reads: a read smaller than kReadAhead pulls up to kReadAhead bytes into a
+ * pooled IoBuffer, so a parser reading 2, 2 and 4 bytes costs one recv().
+ * peek()/consume() let it inspect bytes before taking them.
+ *
+ * Writes: small writes are copied into a write buffer and yield len at once.
+ * The buffer is sent when it reaches kWriteBufferSize, on flush(), before
+ * shutdown(), and - with auto-cork, the default - once the Scheduler has run
+ * everything else that is ready, so writes issued in the same loop iteration
+ * leave in one syscall. Writes of kWriteBufferSize or more go out directly,
+ * together with anything already buffered. Because buffered writes complete
+ * early, a peer that has gone away shows up as 0 from a later write() or
+ * flush(), and an I/O error from a background flush is rethrown there.
+ *
+ * Must be owned by a shared_ptr and used on the thread of the Scheduler that
+ * created it. One reader and any number of writers may be active at a time.
+ */
+class BufferedStream : public std::enable_shared_from_this<BufferedStream>
+{
+public:
+    static constexpr size_t kReadAhead = utils::BufferPool::kBlockSize;
+    static constexpr size_t kWriteBufferSize = 16 * 1024;
+
+    explicit BufferedStream(StreamPtr inner);
+    ~BufferedStream() = default;
+
+    BufferedStream(const BufferedStream &) = delete;
+    BufferedStream & operator=(const BufferedStream &) = delete;
+    BufferedStream(BufferedStream &&) = delete;
+    BufferedStream & operator=(BufferedStream &&) = delete;
+
+    Task<size_t> read(void * buf, size_t len);
+    Task<size_t> readv(std::span<const iovec> iov);
+    // Returns at once if bytes are buffered; otherwise releases the read buffer while waiting.
+    Task<> waitReadable();
+
+    /**
+     * Buffers at least @p n bytes, reading as needed, and returns them
+     * without consuming; the view holds fewer bytes only if the stream ended
+     * first. It stays valid until the next read, peek() or consume().
+     */
+    Task<std::string_view> peek(size_t n);
+    // Drops @p n bytes that peek() returned.
+    void consume(size_t n);
+    // Bytes read ahead and not yet consumed.
+    size_t buffered() const { return readBuf_.remainSize(); }
+
+    Task<size_t> write(const void * buf, size_t len);
+    Task<size_t> writev(std::span<const iovec> iov);
+    // Sends buffered writes first, then the file through the inner stream.
+    Task<size_t> sendFile(int fd, off_t offset, size_t len);
+    // Sends everything buffered; false once the peer has gone.
+    Task<bool> flush();
+    Task<> shutdown();
+
+    // Turns the end-of-iteration flush on or off; without it, call flush().
+    void setAutoCork(bool enabled) { autoCork_ = enabled; }
+
+private:
+    Task<size_t> fill();
+    size_t copyOut(std::span<const iovec> iov);
+    Task<bool> flushLocked();
+    void scheduleCork();
+    void rethrowFlushError();
+
+    StreamPtr inner_;
+    Scheduler * scheduler_;
+    utils::IoBuffer readBuf_;
+    std::string writeBuf_;
+    Mutex writeMutex_;
+    bool autoCork_{ true };
+    bool corkPending_{ false };
+    bool peerGone_{ false };
+    std::exception_ptr flushError_;
+};
+
+} // namespace nitrocoro::io
@@ -37,7 +37,7 @@ public:
     void setErrorCallback(std::function<void()> cb);
 
 private:
-    static void handleIoEvents(State * state, uint32_t ev);
+    static void handleIoEvents(void * context, int fd, uint32_t ev);
     void setEvents(uint32_t newEvents);
 
     uint64_t id_;
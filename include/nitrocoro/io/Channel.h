@@ -15,8 +15,17 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
 #include <coroutine>
 #include <memory>
+#include <optional>
+#include <span>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <nitrocoro/core/CancelToken.h>
 #include <nitrocoro/core/Scheduler.h>
 #include <nitrocoro/core/Task.h>
 #include <nitrocoro/core/Types.h>
@@ -30,6 +39,37 @@ using nitrocoro::Task;
 class Channel;
 using IoChannelPtr = std::shared_ptr<Channel>;
 
+/**
+ * @brief Bound on a single I/O wait: a deadline, a CancelToken, or both.
+ *
+ * Converts implicitly, so call sites read naturally:
+ *   co_await conn->read(buf, len, std::chrono::seconds(5));
+ *   co_await conn->read(buf, len, source.token());
+ * A wait that hits the deadline completes with IoResult::TimedOut, one whose
+ * token fires with IoResult::Canceled. Data that is already available is
+ * returned even when the deadline has passed.
+ */
+struct IoDeadline
+{
+    TimePoint when{ TimePoint::max() };
+    CancelToken token;
+
+    IoDeadline() = default;
+    // NOLINTBEGIN(google-explicit-constructor)
+    IoDeadline(TimePoint deadline)
+        : when(deadline) {}
+    template <typename Rep, typename Period>
+    IoDeadline(std::chrono::duration<Rep, Period> timeout)
+        : when(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout)) {}
+    IoDeadline(CancelToken cancel)
+        : token(std::move(cancel)) {}
+    // NOLINTEND(google-explicit-constructor)
+    IoDeadline(TimePoint deadline, CancelToken cancel)
+        : when(deadline), token(std::move(cancel)) {}
+
+    bool hasTimer() const noexcept { return when != TimePoint::max(); }
+};
+
 class Channel
 {
 public:
@@ -70,13 +110,21 @@ public:
     void disableReading();
     void disableWriting();
     void disableAll();
+    /**
+     * @brief For sockets using MSG_ZEROCOPY: EPOLLERR then also signals
+     * completion notifications on the error queue, so it marks the channel
+     * errored only when SO_ERROR reports a pending socket error. Wait for
+     * notifications by returning IoStatus::NeedErrorQueue from perform().
+     */
+    void enableErrorQueue() { state_->errorQueue = true; }
 
     // Returned by adapters/lambdas to drive the performImpl loop
     enum class IoStatus
     {
         Success,
-        NeedRead,  // wait for readable, then retry
-        NeedWrite, // wait for writable, then retry
+        NeedRead,       // wait for readable, then retry
+        NeedWrite,      // wait for writable, then retry
+        NeedErrorQueue, // wait for error-queue data (EPOLLERR), then retry; see enableErrorQueue()
         Retry,
         Eof,  // read() returned 0: peer closed write direction
         Error // ECONNRESET, EPIPE, or other fatal errors
@@ -86,16 +134,19 @@ public:
     enum class IoResult
     {
         Success,
-        Eof,     // read() returned 0: peer closed write direction
-        Error,   // ECONNRESET, EPIPE, or other fatal errors
-        Canceled // operation was canceled via cancelRead()/cancelWrite()
+        Eof,        // read() returned 0: peer closed write direction
+        Error,      // ECONNRESET, EPIPE, or other fatal errors
+        Canceled,   // operation was canceled via cancelRead()/cancelWrite() or an IoDeadline token
+        TimedOut,   // IoDeadline passed before the fd became ready
+        Unsupported // sendFileSome(): the kernel cannot sendfile() from this fd
     };
 
     enum class WaitHint
     {
-        Read,  // wait for readable before first invocation
-        Write, // wait for writable before first invocation
-        None   // invoke immediately
+        Read,       // wait for readable before first invocation
+        Write,      // wait for writable before first invocation
+        ErrorQueue, // wait for error-queue data before first invocation
+        None        // invoke immediately
     };
 
     // Adapter pointer overload: perform(&reader) / perform(&writer)
@@ -128,6 +179,127 @@ public:
         co_return co_await perform(std::forward<T>(t), WaitHint::Write);
     }
 
+    // Returned by readSome() / writeSome()
+    struct Transfer
+    {
+        IoResult result;
+        size_t bytes; // bytes transferred when result is Success
+    };
+
+    /**
+     * @brief Awaiter performing a single read()/write() without a coroutine frame.
+     *
+     * When the fd is known to be ready the syscall is tried inline in
+     * await_ready(), so data already sitting in the socket buffer is returned
+     * without suspending. On EAGAIN the awaiter parks itself in IoState and
+     * handleIoEvents() retries the syscall before resuming the coroutine.
+     * On a Scheduler that can submit I/O (PollerType::IoUring), reads and
+     * writes are handed to the kernel instead of waiting for readiness; a
+     * deadline or cancellation then resumes the coroutine only once the kernel
+     * has given the buffer back, with the data if the transfer won the race.
+     * Nothing is allocated unless the caller runs outside the Scheduler's thread
+     * or the IoDeadline carries a CancelToken.
+     */
+    class [[nodiscard]] TransferAwaiter
+    {
+    public:
+        TransferAwaiter(TransferAwaiter &&) noexcept = default;
+        TransferAwaiter & operator=(TransferAwaiter &&) = delete;
+
+        bool await_ready() noexcept;
+        void await_suspend(std::coroutine_handle<> h) noexcept;
+        Transfer await_resume() noexcept { return result_; }
+
+    private:
+        friend class Channel;
+
+        TransferAwaiter(Channel * channel, void * buf, size_t len, bool write, IoDeadline limit = {}) noexcept
+            : channel_(channel), buf_(buf), len_(len), write_(write), limit_(std::move(limit))
+        {
+        }
+        TransferAwaiter(Channel * channel, std::span<const iovec> iov, bool write, IoDeadline limit) noexcept
+            : channel_(channel)
+            , buf_(nullptr)
+            , len_(0)
+            , write_(write)
+            , iov_(iov.data())
+            , iovcnt_(static_cast<int>(std::min<size_t>(iov.size(), IOV_MAX)))
+            , limit_(std::move(limit))
+        {
+        }
+        TransferAwaiter(Channel * channel, int srcFd, off_t srcOffset, size_t len, IoDeadline limit) noexcept
+            : channel_(channel)
+            , buf_(nullptr)
+            , len_(len)
+            , write_(true)
+            , srcFd_(srcFd)
+            , srcOffset_(srcOffset)
+            , limit_(std::move(limit))
+        {
+        }
+
+        bool attempt() noexcept; // true once result_ is final
+        void settle(ssize_t ret) noexcept; // result_ from bytes or -errno
+        void park() noexcept;    // submit, or wait for readiness; loop thread only
+        bool submit() noexcept;
+        void waitReady() noexcept;
+        void expire(IoResult result) noexcept;
+        void complete() noexcept;
+        // Drops the deadline timer and token hook. Used instead of complete()
+        // once the Channel may be gone, so only the Scheduler is touched.
+        void disarm(Scheduler * scheduler) noexcept;
+        static void onSubmitted(IoOperation * op, int result) noexcept;
+
+        Channel * channel_;
+        void * buf_;
+        size_t len_;
+        bool write_;
+        const iovec * iov_{ nullptr }; // readv()/writev() instead of read()/write() when set
+        int iovcnt_{ 0 };
+        int srcFd_{ -1 };      // sendfile() from srcFd_ when srcOffset_ >= 0, else splice() from a pipe
+        off_t srcOffset_{ -1 };
+        Transfer result_{ IoResult::Success, 0 };
+        std::coroutine_handle<> waiter_;
+        IoDeadline limit_;
+        TimerId timer_{ kInvalidTimerId };
+        CancelRegistration cancelReg_;
+    };
+
+    // Single read()/write() of up to len bytes; see TransferAwaiter.
+    TransferAwaiter readSome(void * buf, size_t len, IoDeadline limit = {}) noexcept
+    {
+        return { this, buf, len, false, std::move(limit) };
+    }
+    TransferAwaiter writeSome(const void * buf, size_t len, IoDeadline limit = {}) noexcept
+    {
+        return { this, const_cast<void *>(buf), len, true, std::move(limit) };
+    }
+    // Single readv() into up to IOV_MAX buffers; @p iov must outlive the await.
+    TransferAwaiter readvSome(std::span<const iovec> iov, IoDeadline limit = {}) noexcept
+    {
+        return { this, iov, false, std::move(limit) };
+    }
+    // One readv() only if it would not block: std::nullopt on EAGAIN, after
+    // which the channel counts as not readable. Loop thread only, and never
+    // while another read is pending.
+    std::optional<Transfer> tryReadv(std::span<const iovec> iov) noexcept;
+    // Single writev() of up to IOV_MAX buffers; @p iov must outlive the await.
+    TransferAwaiter writevSome(std::span<const iovec> iov, IoDeadline limit = {}) noexcept
+    {
+        return { this, iov, true, std::move(limit) };
+    }
+    // Single sendfile() of up to len bytes of @p fileFd at @p offset; yields
+    // Unsupported when the source cannot be sent this way, and 0 bytes at end of file.
+    TransferAwaiter sendFileSome(int fileFd, off_t offset, size_t len, IoDeadline limit = {}) noexcept
+    {
+        return { this, fileFd, offset, len, std::move(limit) };
+    }
+    // Single splice() of up to len bytes from the pipe @p pipeFd.
+    TransferAwaiter spliceSome(int pipeFd, size_t len, IoDeadline limit = {}) noexcept
+    {
+        return { this, pipeFd, -1, len, std::move(limit) };
+    }
+
     void cancelRead();
     void cancelWrite();
     void cancelAll();
@@ -136,17 +308,37 @@ private:
     struct IoState
     {
         int fd{ -1 };
+        Scheduler * scheduler{ nullptr };
+        std::atomic<bool> closed{ false }; // Channel destroyed, ignore events until removeIo()
         bool readable{ false };
         bool writable{ true };
         bool errored{ false };
+        bool errorQueue{ false }; // EPOLLERR may be error-queue data only
         std::coroutine_handle<> readableWaiter;
         std::coroutine_handle<> writableWaiter;
         bool readCanceled{ false };
         bool writeCanceled{ false };
+        TransferAwaiter * readOp{ nullptr }; // parked readSome(), retried on readable
+        TransferAwaiter * writeOp{ nullptr };
+
+        // The op of a parked TransferAwaiter that went to the kernel instead.
+        struct Submission : IoOperation
+        {
+            bool write{ false };
+            bool canceling{ false };
+            IoResult cancelResult{ IoResult::Canceled };
+            // Held while the kernel owns the op, so a completion that arrives
+            // after the Channel is gone still finds its state.
+            std::shared_ptr<IoState> keepAlive;
+        };
+        Submission readSub;
+        Submission writeSub;
+
+        bool inKernel(bool write) const noexcept { return (write ? writeSub : readSub).keepAlive != nullptr; }
     };
 
     // Called by Scheduler::process_io_events() when epoll reports events
-    static void handleIoEvents(Scheduler * scheduler, IoState * state, uint32_t ev);
+    static void handleIoEvents(void * context, int fd, uint32_t ev);
 
     struct [[nodiscard]] ReadableAwaiter
     {
@@ -166,6 +358,17 @@ private:
         void await_resume() noexcept;
     };
 
+    // Waits for the next EPOLLERR (or any write-side wakeup); shares the
+    // writable slot, so cancelWrite() interrupts it.
+    struct [[nodiscard]] ErrorQueueAwaiter
+    {
+        IoState * state_;
+
+        bool await_ready() noexcept { return state_->errored; }
+        void await_suspend(std::coroutine_handle<> h) noexcept { state_->writableWaiter = h; }
+        void await_resume() noexcept {}
+    };
+
     template <typename T>
     Task<IoResult> performImpl(T && func, WaitHint hint)
     {
@@ -192,6 +395,15 @@ private:
                     co_return IoResult::Canceled;
                 }
             }
+            else if (pendingWait == WaitHint::ErrorQueue)
+            {
+                co_await ErrorQueueAwaiter{ state_.get() };
+                if (state_->writeCanceled)
+                {
+                    state_->writeCanceled = false;
+                    co_return IoResult::Canceled;
+                }
+            }
 
             IoStatus status;
             if constexpr (std::is_pointer_v<std::remove_reference_t<T>>)
@@ -220,6 +432,10 @@ private:
                     pendingWait = WaitHint::Write;
                     break;
 
+                case IoStatus::NeedErrorQueue:
+                    pendingWait = WaitHint::ErrorQueue;
+                    break;
+
                 case IoStatus::Retry:
                     pendingWait = WaitHint::None;
                     break;
@@ -6,7 +6,15 @@
 
 #include <nitrocoro/core/Task.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 namespace nitrocoro::io
 {
@@ -18,6 +26,70 @@ concept StreamConcept = requires(S & s, void * rbuf, const void * wbuf, size_t l
     { s.shutdown() } -> std::same_as<Task<>>;
 };
 
+/**
+ * @brief Streams that also offer frame-free single-syscall awaiters.
+ *
+ * readSome()/writeSome() return awaiters yielding the byte count; Stream
+ * prefers them over read()/write() so a read that finds data already buffered
+ * costs no coroutine frames beyond the caller's.
+ */
+template <typename S>
+concept DirectStreamConcept = StreamConcept<S> && requires(S & s, void * rbuf, const void * wbuf, size_t len) {
+    { s.readSome(rbuf, len).await_resume() } -> std::same_as<size_t>;
+    { s.writeSome(wbuf, len).await_resume() } -> std::same_as<size_t>;
+};
+
+/**
+ * @brief Streams with a native gather write.
+ *
+ * writev() must send every buffer (or stop early only when the peer has gone)
+ * and yield the bytes written; Stream falls back to one write() per buffer for
+ * streams without it.
+ */
+template <typename S>
+concept VectoredStreamConcept = StreamConcept<S> && requires(S & s, std::span<const iovec> iov) {
+    { s.writev(iov) } -> std::same_as<Task<size_t>>;
+};
+
+/**
+ * @brief Streams with a native scatter read and an idle wait.
+ *
+ * readv() has read()'s contract spread over several buffers. waitReadable()
+ * completes once a read would not block, without consuming anything, so an
+ * idle reader can release its buffers meanwhile. Stream falls back to a read()
+ * into the first non-empty buffer and to returning at once.
+ */
+template <typename S>
+concept ScatterStreamConcept = StreamConcept<S> && requires(S & s, std::span<const iovec> iov) {
+    { s.readv(iov) } -> std::same_as<Task<size_t>>;
+    { s.waitReadable() } -> std::same_as<Task<>>;
+};
+
+/**
+ * @brief Streams that can read without ever suspending.
+ *
+ * tryReadv() does one readv() if it would not block and yields the bytes read
+ * (0 on EOF), or std::nullopt when nothing is pending. It lets an idle reader
+ * keep its buffers while the next message is already there. Stream answers
+ * std::nullopt for other streams.
+ */
+template <typename S>
+concept TryReadStreamConcept = StreamConcept<S> && requires(S & s, std::span<const iovec> iov) {
+    { s.tryReadv(iov) } -> std::same_as<std::optional<size_t>>;
+};
+
+/**
+ * @brief Streams that can send file contents without copying them through
+ * user space (sendfile/splice on a plain socket).
+ *
+ * sendFile() has write()'s contract for @p len bytes of @p fd read from
+ * @p offset; Stream falls back to pread() and write() for other streams.
+ */
+template <typename S>
+concept FileStreamConcept = StreamConcept<S> && requires(S & s, int fd, off_t offset, size_t len) {
+    { s.sendFile(fd, offset, len) } -> std::same_as<Task<size_t>>;
+};
+
 class Stream;
 using StreamPtr = std::shared_ptr<Stream>;
 
@@ -45,6 +117,16 @@ public:
 
     Task<size_t> read(void * buf, size_t len) { return holder_->read(buf, len); }
     Task<size_t> write(const void * buf, size_t len) { return holder_->write(buf, len); }
+    // @p iov must stay valid until the returned Task completes.
+    Task<size_t> readv(std::span<const iovec> iov) { return holder_->readv(iov); }
+    // Completes once read()/readv() would not block; see ScatterStreamConcept.
+    Task<> waitReadable() { return holder_->waitReadable(); }
+    // Reads only if that would not block; see TryReadStreamConcept.
+    std::optional<size_t> tryReadv(std::span<const iovec> iov) { return holder_->tryReadv(iov); }
+    // @p iov must stay valid until the returned Task completes.
+    Task<size_t> writev(std::span<const iovec> iov) { return holder_->writev(iov); }
+    // Sends @p len bytes of @p fd from @p offset; throws if the file is shorter.
+    Task<size_t> sendFile(int fd, off_t offset, size_t len) { return holder_->sendFile(fd, offset, len); }
     Task<> shutdown() { return holder_->shutdown(); }
 
 private:
@@ -53,6 +135,11 @@ private:
         virtual ~HolderBase() = default;
         virtual Task<size_t> read(void * buf, size_t len) = 0;
         virtual Task<size_t> write(const void * buf, size_t len) = 0;
+        virtual Task<size_t> readv(std::span<const iovec> iov) = 0;
+        virtual Task<> waitReadable() = 0;
+        virtual std::optional<size_t> tryReadv(std::span<const iovec> iov) = 0;
+        virtual Task<size_t> writev(std::span<const iovec> iov) = 0;
+        virtual Task<size_t> sendFile(int fd, off_t offset, size_t len) = 0;
         virtual Task<> shutdown() = 0;
     };
 
@@ -63,9 +150,97 @@ private:
 
         explicit Holder(std::shared_ptr<S> s)
             : stream(std::move(s)) {}
-        Task<size_t> read(void * buf, size_t len) override { co_return co_await stream->read(buf, len); }
-        Task<size_t> write(const void * buf, size_t len) override { co_return co_await stream->write(buf, len); }
-        Task<> shutdown() override { co_await stream->shutdown(); }
+        Task<size_t> read(void * buf, size_t len) override
+        {
+            if constexpr (DirectStreamConcept<S>)
+                return readDirect(stream.get(), buf, len);
+            else
+                return stream->read(buf, len);
+        }
+        Task<size_t> write(const void * buf, size_t len) override { return stream->write(buf, len); }
+        Task<size_t> readv(std::span<const iovec> iov) override
+        {
+            if constexpr (ScatterStreamConcept<S>)
+                return stream->readv(iov);
+            else
+                return readFirst(this, iov);
+        }
+        Task<> waitReadable() override
+        {
+            if constexpr (ScatterStreamConcept<S>)
+                return stream->waitReadable();
+            else
+                return readyNow();
+        }
+        std::optional<size_t> tryReadv(std::span<const iovec> iov) override
+        {
+            if constexpr (TryReadStreamConcept<S>)
+                return stream->tryReadv(iov);
+            else
+                return std::nullopt;
+        }
+        Task<size_t> writev(std::span<const iovec> iov) override
+        {
+            if constexpr (VectoredStreamConcept<S>)
+                return stream->writev(iov);
+            else
+                return writeEach(stream.get(), iov);
+        }
+        Task<size_t> sendFile(int fd, off_t offset, size_t len) override
+        {
+            if constexpr (FileStreamConcept<S>)
+                return stream->sendFile(fd, offset, len);
+            else
+                return copyFile(stream.get(), fd, offset, len);
+        }
+        Task<> shutdown() override { return stream->shutdown(); }
+
+        static Task<size_t> readDirect(S * s, void * buf, size_t len) { co_return co_await s->readSome(buf, len); }
+
+        static Task<size_t> readFirst(Holder * self, std::span<const iovec> iov)
+        {
+            for (const auto & v : iov)
+            {
+                if (v.iov_len != 0)
+                    co_return co_await self->read(v.iov_base, v.iov_len);
+            }
+            co_return 0;
+        }
+
+        static Task<> readyNow() { co_return; }
+
+        static Task<size_t> writeEach(S * s, std::span<const iovec> iov)
+        {
+            size_t total = 0;
+            for (const auto & v : iov)
+            {
+                if (v.iov_len == 0)
+                    continue;
+                size_t n = co_await s->write(v.iov_base, v.iov_len);
+                total += n;
+                if (n < v.iov_len)
+                    break;
+            }
+            co_return total;
+        }
+
+        static Task<size_t> copyFile(S * s, int fd, off_t offset, size_t len)
+        {
+            constexpr size_t kChunkSize = 65536;
+            auto buf = std::make_unique<char[]>(kChunkSize);
+            for (size_t sent = 0; sent < len;)
+            {
+                ssize_t n = ::pread(fd, buf.get(), std::min(len - sent, kChunkSize), offset + static_cast<off_t>(sent));
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    throw std::runtime_error("sendFile: cannot read the requested length from the file");
+                if (co_await s->write(buf.get(), static_cast<size_t>(n)) == 0)
+                    co_return 0;
+                sent += static_cast<size_t>(n);
+            }
+            co_return len;
+        }
     };
 
     std::shared_ptr<HolderBase> holder_;
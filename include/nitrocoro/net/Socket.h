@@ -4,6 +4,8 @@
  */
 #pragma once
 
+#include <chrono>
+
 namespace nitrocoro::net
 {
 
@@ -27,6 +29,12 @@ public:
     int fd() const noexcept { return fd_; }
     bool valid() const noexcept { return fd_ >= 0; }
     void shutdownWrite() noexcept;
+    // SO_BUSY_POLL; the kernel refuses values above net.core.busy_read without CAP_NET_ADMIN.
+    bool setBusyPoll(std::chrono::microseconds spin) noexcept;
+    // SO_ZEROCOPY, required before send(MSG_ZEROCOPY); Linux 4.14+.
+    bool setZeroCopy() noexcept;
+    // Drops the connection with a RST and discards unsent data; the fd stays open.
+    void abort() noexcept;
 
 private:
     int fd_{ -1 };
@@ -9,6 +9,11 @@
 #include <nitrocoro/io/Channel.h>
 #include <nitrocoro/net/InetAddress.h>
 #include <nitrocoro/net/Socket.h>
+#include <optional>
+
+#include <span>
+#include <sys/types.h>
+#include <sys/uio.h>
 
 namespace nitrocoro::net
 {
@@ -16,6 +21,7 @@ namespace nitrocoro::net
 using nitrocoro::Mutex;
 using nitrocoro::Task;
 using nitrocoro::io::Channel;
+using nitrocoro::io::IoDeadline;
 using nitrocoro::net::Socket;
 class TcpConnection;
 using TcpConnectionPtr = std::shared_ptr<TcpConnection>;
@@ -23,7 +29,8 @@ using TcpConnectionPtr = std::shared_ptr<TcpConnection>;
 class TcpConnection
 {
 public:
-    static Task<TcpConnectionPtr> connect(const InetAddress & addr);
+    // @p limit bounds the handshake; see IoDeadline.
+    static Task<TcpConnectionPtr> connect(const InetAddress & addr, IoDeadline limit = {});
 
     TcpConnection(std::unique_ptr<Channel>, std::shared_ptr<Socket>, InetAddress localAddr, InetAddress peerAddr);
     ~TcpConnection();
@@ -33,8 +40,88 @@ public:
     TcpConnection(TcpConnection &&) = delete;
     TcpConnection & operator=(TcpConnection &&) = delete;
 
-    Task<size_t> read(void * buf, size_t len);
-    Task<size_t> write(const void * buf, size_t len);
+    class ReadSomeAwaiter;
+    class WriteSomeAwaiter;
+
+    /**
+     * With an IoDeadline, a wait that outlives it throws TimeoutException and
+     * one whose token fires throws CancelledException. The pending epoll wait
+     * itself is cancelled, and the connection stays usable. For write() the
+     * deadline covers the whole buffer.
+     */
+    Task<size_t> read(void * buf, size_t len, IoDeadline limit = {});
+    Task<size_t> write(const void * buf, size_t len, IoDeadline limit = {});
+
+    /**
+     * @brief Frame-free variants of read()/write(): one syscall, no allocation.
+     *
+     * readSome() yields the bytes read (0 on EOF); writeSome() yields the bytes
+     * written, which may be less than len (0 once the peer has gone). Both
+     * throw on I/O errors, timeouts and cancellation, like read()/write().
+     */
+    ReadSomeAwaiter readSome(void * buf, size_t len, IoDeadline limit = {}) noexcept;
+    WriteSomeAwaiter writeSome(const void * buf, size_t len, IoDeadline limit = {}) noexcept;
+
+    /**
+     * @brief Scatter reads: one readv() filling several buffers, e.g. the free
+     * blocks of an IoBuffer. Yields the bytes read, 0 on EOF, like read().
+     * readvSome() is the frame-free variant; @p iov must stay valid until it
+     * completes.
+     */
+    Task<size_t> readv(std::span<const iovec> iov, IoDeadline limit = {});
+    ReadSomeAwaiter readvSome(std::span<const iovec> iov, IoDeadline limit = {}) noexcept;
+
+    /**
+     * @brief Waits until a read would not block (data, EOF or an error is
+     * pending) without reading anything, so an idle caller can hand its
+     * buffers back first and only take them again when bytes arrive.
+     *
+     * tryReadv() is the check to make before giving the buffers back: one
+     * readv() on the loop thread that never suspends, yielding the bytes read
+     * (0 on EOF) or std::nullopt when nothing is pending. After std::nullopt,
+     * waitReadable() parks without peeking at the socket again.
+     */
+    Task<> waitReadable(IoDeadline limit = {});
+    std::optional<size_t> tryReadv(std::span<const iovec> iov);
+
+    /**
+     * @brief Gather writes: one writev() for scattered buffers (header block,
+     * body, chunk framing) instead of a copy or a syscall per piece.
+     *
+     * writev() retries short writes until every buffer is sent and yields the
+     * total, or 0 once the peer has gone, like write(). writevSome() is the
+     * single-syscall variant; @p iov must stay valid until it completes.
+     */
+    Task<size_t> writev(std::span<const iovec> iov, IoDeadline limit = {});
+    WriteSomeAwaiter writevSome(std::span<const iovec> iov, IoDeadline limit = {}) noexcept;
+
+    /**
+     * @brief Zero-copy file transmission: sends @p len bytes of @p fd from
+     * @p offset straight out of the page cache with sendfile(2), or through a
+     * pipe with splice(2) when the file does not support sendfile().
+     *
+     * Yields len, or 0 once the peer has gone, like write(); throws
+     * std::runtime_error if the file ends before @p len bytes. The deadline
+     * covers the whole transfer. The file offset of @p fd is not changed.
+     */
+    Task<size_t> sendFile(int fd, off_t offset, size_t len, IoDeadline limit = {});
+
+    /**
+     * @brief Opt-in MSG_ZEROCOPY for large writes: write() and writev()
+     * calls of at least @p threshold bytes in total pin the caller's pages
+     * instead of copying them into the kernel; 0 turns it off. Returns false,
+     * leaving writes copying, if the socket refuses SO_ZEROCOPY.
+     * writeSome()/writevSome() always copy.
+     *
+     * Such a write returns only once the kernel has released the buffers
+     * (the peer has acknowledged the data), so the borrow contract still
+     * holds. It pays off for buffers of hundreds of KB and up; below
+     * that, pinning and the completion round trip cost more than the copy.
+     * A deadline or cancellation that interrupts a zero-copy write resets
+     * the connection, since the kernel could otherwise still be reading the
+     * buffer after write() has thrown. Call on the connection's loop thread.
+     */
+    bool setZeroCopyThreshold(size_t threshold);
 
     Task<> shutdown();
     Task<> forceClose();
@@ -52,10 +139,49 @@ public:
     const InetAddress & localAddr() const { return localAddr_; }
     const InetAddress & peerAddr() const { return peerAddr_; }
 
+    class [[nodiscard]] ReadSomeAwaiter
+    {
+    public:
+        bool await_ready() noexcept { return inner_.await_ready(); }
+        void await_suspend(std::coroutine_handle<> h) noexcept { inner_.await_suspend(h); }
+        size_t await_resume();
+
+    private:
+        friend class TcpConnection;
+        ReadSomeAwaiter(TcpConnection * conn, Channel::TransferAwaiter inner) noexcept
+            : conn_(conn), inner_(std::move(inner)) {}
+
+        TcpConnection * conn_;
+        Channel::TransferAwaiter inner_;
+    };
+
+    class [[nodiscard]] WriteSomeAwaiter
+    {
+    public:
+        bool await_ready() noexcept { return inner_.await_ready(); }
+        void await_suspend(std::coroutine_handle<> h) noexcept { inner_.await_suspend(h); }
+        size_t await_resume();
+
+    private:
+        friend class TcpConnection;
+        WriteSomeAwaiter(TcpConnection * conn, Channel::TransferAwaiter inner) noexcept
+            : conn_(conn), inner_(std::move(inner)) {}
+
+        TcpConnection * conn_;
+        Channel::TransferAwaiter inner_;
+    };
+
 private:
+    Task<size_t> spliceFile(int fd, off_t offset, size_t len, IoDeadline limit);
+    Task<size_t> writeZeroCopy(std::span<const iovec> iov, size_t total, IoDeadline limit);
+    size_t finishRead(Channel::Transfer transfer);
+    size_t finishWrite(Channel::Transfer transfer);
+
     std::shared_ptr<Socket> socket_;
     std::unique_ptr<Channel> ioChannelPtr_;
     State state_ = State::None;
+    size_t zeroCopyThreshold_{ 0 };
+    bool drained_{ false }; // last tryReadv() hit EAGAIN
     InetAddress localAddr_;
     InetAddress peerAddr_;
 };
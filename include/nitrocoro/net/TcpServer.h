@@ -6,6 +6,7 @@
 
 #include <nitrocoro/core/Future.h>
 #include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/SchedulerGroup.h>
 #include <nitrocoro/core/Task.h>
 #include <nitrocoro/net/InetAddress.h>
 #include <nitrocoro/net/Socket.h>
@@ -15,11 +16,13 @@
 #include <functional>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
 namespace nitrocoro::net
 {
 
 using nitrocoro::Scheduler;
+using nitrocoro::SchedulerGroup;
 using nitrocoro::Task;
 using nitrocoro::io::Channel;
 
@@ -38,6 +41,18 @@ public:
 
     explicit TcpServer(uint16_t port, Scheduler * scheduler = Scheduler::current());
     explicit TcpServer(const InetAddress & addr, Scheduler * scheduler = Scheduler::current());
+
+    /**
+     * @brief Multi-loop server: one SO_REUSEPORT listener per Scheduler in @p group.
+     *
+     * The kernel spreads incoming connections across the listeners, and each
+     * connection lives entirely on the loop that accepted it. start()/stop()
+     * and the started()/wait() futures are driven from @p scheduler, which
+     * defaults to the calling thread's Scheduler, or the group's first one.
+     * The group must keep running until this server is destroyed.
+     */
+    TcpServer(uint16_t port, SchedulerGroup & group, Scheduler * scheduler = Scheduler::current());
+    TcpServer(const InetAddress & addr, SchedulerGroup & group, Scheduler * scheduler = Scheduler::current());
     ~TcpServer();
 
     /**
@@ -55,21 +70,31 @@ public:
     uint16_t port() const { return addr_.toPort(); }
 
 private:
-    void setup_socket();
+    using ConnectionSet = std::unordered_set<TcpConnectionPtr>;
+
+    // One listening socket and its accept loop; all members except socket are
+    // touched only from the listener's own scheduler.
+    struct Listener
+    {
+        Scheduler * scheduler;
+        std::shared_ptr<net::Socket> socket;
+        std::unique_ptr<Channel> channel;
+        std::shared_ptr<ConnectionSet> connSet{ std::make_shared<ConnectionSet>() };
+    };
+
+    std::shared_ptr<net::Socket> setup_socket(Scheduler * loop);
+    Task<> acceptLoop(Listener & listener, std::shared_ptr<ConnectionHandler> handlerPtr);
+    Task<> stopListener(Listener & listener);
 
     InetAddress addr_;
     Scheduler * scheduler_;
-    std::shared_ptr<net::Socket> listenSocketPtr_;
+    std::vector<Listener> listeners_;
     std::atomic_bool started_{ false };
     std::atomic_bool stopped_{ false };
     Promise<> startPromise_;
     SharedFuture<> startFuture_;
     Promise<> stopPromise_;
     SharedFuture<> stopFuture_;
-    std::unique_ptr<Channel> listenChannel_;
-
-    using ConnectionSet = std::unordered_set<TcpConnectionPtr>;
-    std::shared_ptr<ConnectionSet> connSetPtr_{ std::make_shared<ConnectionSet>() };
 };
 
 } // namespace nitrocoro::net
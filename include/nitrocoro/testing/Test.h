@@ -170,6 +170,7 @@ inline void record_failure_ne(
 inline int run_all(int argc = 0, char ** argv = nullptr)
 {
     std::string filter;
+    PollerType pollerType = PollerType::Epoll;
 
     for (int i = 1; i < argc; ++i)
     {
@@ -178,6 +179,19 @@ inline int run_all(int argc = 0, char ** argv = nullptr)
         {
             filter = argv[++i];
         }
+        else if (arg == "-p" && i + 1 < argc)
+        {
+            std::string_view poller = argv[++i];
+            if (poller == "epoll")
+                pollerType = PollerType::Epoll;
+            else if (poller == "io_uring")
+                pollerType = PollerType::IoUring;
+            else
+            {
+                fprintf(stderr, "Unknown poller: %s\n", argv[i]);
+                return 1;
+            }
+        }
         else if (arg == "-v")
         {
             verbose_mode() = true;
@@ -190,8 +204,9 @@ inline int run_all(int argc = 0, char ** argv = nullptr)
         }
         else if (arg == "-h" || arg == "--help")
         {
-            printf("Usage: %s [-n pattern] [-v] [-l] [-h]\n"
+            printf("Usage: %s [-n pattern] [-p poller] [-v] [-l] [-h]\n"
                    "  -n <pattern>  only run tests whose name contains pattern\n"
+                   "  -p <poller>   scheduler poller backend: epoll (default) or io_uring\n"
                    "  -v            print passing checks\n"
                    "  -l            list all tests\n"
                    "  -h            show this help\n",
@@ -273,7 +288,7 @@ inline int run_all(int argc = 0, char ** argv = nullptr)
         Scheduler::current()->stop();
     };
 
-    Scheduler scheduler;
+    Scheduler scheduler(pollerType);
     scheduler.spawn(run_tests);
     scheduler.run();
     return failed > 0 ? 1 : 0;
@@ -0,0 +1,47 @@
+/**
+ * @file BufferPool.h
+ * @brief Per-thread pool of fixed-size, page-aligned I/O blocks
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nitrocoro::utils
+{
+
+// Counters for the calling thread's pool.
+struct BufferPoolStats
+{
+    uint64_t hits{ 0 };   // served from the freelist
+    uint64_t misses{ 0 }; // fell through to the heap
+    int64_t inUse{ 0 };   // taken minus returned on this thread
+    uint32_t cached{ 0 }; // blocks sitting in the freelist
+};
+
+/**
+ * @brief Blocks of kBlockSize bytes, aligned to a page, for IoBuffer chains.
+ *
+ * Every Scheduler runs on its own thread, so the per-thread freelist is a
+ * per-Scheduler pool that needs no locking. Freed blocks go to the freeing
+ * thread's list, capped at kMaxCached; beyond the cap they return to the heap.
+ */
+class BufferPool
+{
+public:
+    static constexpr size_t kBlockSize = 16 * 1024;
+    static constexpr size_t kAlignment = 4096;
+    static constexpr uint32_t kMaxCached = 1024; // 16MB per thread
+
+    static char * allocate();
+    static void deallocate(char * block) noexcept;
+
+    static BufferPoolStats stats() noexcept;
+};
+
+inline BufferPoolStats bufferPoolStats() noexcept
+{
+    return BufferPool::stats();
+}
+
+} // namespace nitrocoro::utils
@@ -0,0 +1,109 @@
+/**
+ * @file IoBuffer.h
+ * @brief Chained I/O buffer over pooled, page-aligned blocks
+ */
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <sys/uio.h>
+#include <vector>
+
+namespace nitrocoro::utils
+{
+
+/**
+ * @brief Byte queue stored as a chain of BufferPool blocks.
+ *
+ * Unlike StringBuffer it never grows by reallocation and never compacts:
+ * writes go into the tail block or a fresh block appended after it, reads
+ * consume from the head, and a block is returned to the pool as soon as the
+ * reader has drained it. prepareWritev() hands out free space in several
+ * blocks for one readv(). Once nothing is buffered, shrink() gives back the
+ * last blocks too, so an idle connection holds no buffer memory at all.
+ *
+ * Satisfies ExtendableBuffer. view() only covers the head block; use find()
+ * and pullup() for tokens that may straddle blocks.
+ */
+class IoBuffer
+{
+public:
+    static constexpr size_t npos = std::string_view::npos;
+
+    IoBuffer() = default;
+    ~IoBuffer() { clear(); }
+
+    IoBuffer(IoBuffer && other) noexcept;
+    IoBuffer & operator=(IoBuffer && other) noexcept;
+    IoBuffer(const IoBuffer &) = delete;
+    IoBuffer & operator=(const IoBuffer &) = delete;
+
+    // Unconsumed bytes in the head block
+    std::string_view view() const;
+
+    // Offset of @p pattern in the unconsumed data, searching across blocks; npos if absent
+    size_t find(std::string_view pattern, size_t pos = 0) const;
+
+    // Makes the first @p len unconsumed bytes contiguous (copying only when
+    // they straddle blocks) and returns them; len must not exceed remainSize()
+    std::string_view pullup(size_t len);
+
+    // Mark n bytes as consumed
+    void consume(size_t n);
+
+    // Copies up to @p len unconsumed bytes to @p dst and consumes them
+    size_t read(char * dst, size_t len);
+
+    // Prepare at least len contiguous writable bytes, returns pointer to write position
+    char * prepareWrite(size_t len);
+
+    // Get write begin position (without growing)
+    char * beginWrite();
+
+    // Get writable size in the current block (without growing)
+    size_t writableSize() const;
+
+    /**
+     * Fills @p iov with up to @p maxIov free regions totalling at least @p len
+     * bytes (fewer if maxIov runs out), appending blocks as needed, and
+     * returns the count. commitWrite() then spreads over them in order.
+     */
+    size_t prepareWritev(iovec * iov, size_t maxIov, size_t len);
+
+    // Commit actual written bytes
+    void commitWrite(size_t len);
+
+    // Get size of unconsumed data
+    size_t remainSize() const { return size_; }
+    bool hasRemaining() const { return size_ > 0; }
+
+    // Blocks currently held, including empty spares
+    size_t blockCount() const { return blocks_.size(); }
+
+    // Returns spare blocks to the pool; every block if nothing is buffered
+    void shrink();
+
+    // Drops all data and blocks
+    void clear();
+
+private:
+    struct Block
+    {
+        char * data;
+        size_t capacity;
+        size_t begin; // start of unconsumed data
+        size_t end;   // end of written data
+    };
+
+    static Block makeBlock(size_t minCapacity);
+    static void freeBlock(const Block & block) noexcept;
+    bool matchesAt(size_t index, size_t offset, std::string_view pattern) const;
+    void dropSpares() noexcept;
+
+    // Blocks before writeIndex_ hold data only; blocks after it are empty spares
+    std::vector<Block> blocks_;
+    size_t writeIndex_ = 0;
+    size_t size_ = 0;
+};
+
+} // namespace nitrocoro::utils
@@ -0,0 +1,235 @@
+/**
+ * @file BufferedStream.cc
+ * @brief Implementation of BufferedStream
+ */
+#include <nitrocoro/io/BufferedStream.h>
+
+#include <nitrocoro/core/Scheduler.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace nitrocoro::io
+{
+
+namespace
+{
+
+// Moves the caller to the Background lane of the current loop iteration: it
+// resumes only after every Normal-lane coroutine that is ready has run.
+struct BackgroundHop
+{
+    Scheduler * scheduler;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) { scheduler->schedule(h, Lane::Background); }
+    void await_resume() const noexcept {}
+};
+
+} // namespace
+
+BufferedStream::BufferedStream(StreamPtr inner)
+    : inner_(std::move(inner))
+    , scheduler_(Scheduler::current())
+{
+}
+
+// ── read ─────────────────────────────────────────────────────────────────────
+
+Task<size_t> BufferedStream::fill()
+{
+    iovec iov[2];
+    size_t count = readBuf_.prepareWritev(iov, 2, kReadAhead);
+    size_t n = co_await inner_->readv({ iov, count });
+    readBuf_.commitWrite(n);
+    co_return n;
+}
+
+size_t BufferedStream::copyOut(std::span<const iovec> iov)
+{
+    size_t total = 0;
+    for (const auto & v : iov)
+    {
+        if (!readBuf_.hasRemaining())
+            break;
+        total += readBuf_.read(static_cast<char *>(v.iov_base), v.iov_len);
+    }
+    return total;
+}
+
+Task<size_t> BufferedStream::read(void * buf, size_t len)
+{
+    if (!readBuf_.hasRemaining())
+    {
+        // Nothing to gain from staging a large read
+        if (len >= kReadAhead)
+            co_return co_await inner_->read(buf, len);
+        size_t n = co_await fill();
+        if (n == 0)
+            co_return 0;
+    }
+    co_return readBuf_.read(static_cast<char *>(buf), len);
+}
+
+Task<size_t> BufferedStream::readv(std::span<const iovec> iov)
+{
+    if (!readBuf_.hasRemaining())
+    {
+        size_t total = 0;
+        for (const auto & v : iov)
+            total += v.iov_len;
+        if (total >= kReadAhead)
+            co_return co_await inner_->readv(iov);
+        size_t n = co_await fill();
+        if (n == 0)
+            co_return 0;
+    }
+    co_return copyOut(iov);
+}
+
+Task<> BufferedStream::waitReadable()
+{
+    if (readBuf_.hasRemaining())
+        co_return;
+    readBuf_.shrink();
+    co_await inner_->waitReadable();
+}
+
+Task<std::string_view> BufferedStream::peek(size_t n)
+{
+    while (readBuf_.remainSize() < n)
+    {
+        size_t got = co_await fill();
+        if (got == 0)
+            break;
+    }
+    co_return readBuf_.pullup(std::min(n, readBuf_.remainSize()));
+}
+
+void BufferedStream::consume(size_t n)
+{
+    readBuf_.consume(std::min(n, readBuf_.remainSize()));
+}
+
+// ── write ────────────────────────────────────────────────────────────────────
+
+void BufferedStream::rethrowFlushError()
+{
+    if (flushError_)
+        std::rethrow_exception(std::exchange(flushError_, nullptr));
+}
+
+Task<size_t> BufferedStream::write(const void * buf, size_t len)
+{
+    iovec iov{ const_cast<void *>(buf), len };
+    co_return co_await writev({ &iov, 1 });
+}
+
+Task<size_t> BufferedStream::writev(std::span<const iovec> iov)
+{
+    size_t total = 0;
+    for (const auto & v : iov)
+        total += v.iov_len;
+
+    // Every write takes the lock, so bytes leave in call order even while a
+    // flush is suspended on a full socket buffer.
+    [[maybe_unused]] auto lock = co_await writeMutex_.scoped_lock();
+    rethrowFlushError();
+    if (peerGone_)
+        co_return 0;
+
+    if (total < kWriteBufferSize)
+    {
+        for (const auto & v : iov)
+            writeBuf_.append(static_cast<const char *>(v.iov_base), v.iov_len);
+        if (writeBuf_.size() >= kWriteBufferSize)
+        {
+            bool sent = co_await flushLocked();
+            co_return sent ? total : 0;
+        }
+        scheduleCork();
+        co_return total;
+    }
+
+    // Large write: pending bytes and the caller's buffers in one writev()
+    std::vector<iovec> all;
+    all.reserve(iov.size() + 1);
+    if (!writeBuf_.empty())
+        all.push_back({ writeBuf_.data(), writeBuf_.size() });
+    all.insert(all.end(), iov.begin(), iov.end());
+    size_t expected = writeBuf_.size() + total;
+    size_t n = co_await inner_->writev(all);
+    writeBuf_.clear();
+    if (n < expected)
+    {
+        peerGone_ = true;
+        co_return 0;
+    }
+    co_return total;
+}
+
+Task<size_t> BufferedStream::sendFile(int fd, off_t offset, size_t len)
+{
+    [[maybe_unused]] auto lock = co_await writeMutex_.scoped_lock();
+    rethrowFlushError();
+    bool flushed = co_await flushLocked();
+    if (!flushed)
+        co_return 0;
+    size_t n = co_await inner_->sendFile(fd, offset, len);
+    if (n < len)
+        peerGone_ = true;
+    co_return n;
+}
+
+Task<bool> BufferedStream::flush()
+{
+    [[maybe_unused]] auto lock = co_await writeMutex_.scoped_lock();
+    rethrowFlushError();
+    co_return co_await flushLocked();
+}
+
+Task<bool> BufferedStream::flushLocked()
+{
+    if (peerGone_)
+        co_return false;
+    if (writeBuf_.empty())
+        co_return true;
+    size_t n = co_await inner_->write(writeBuf_.data(), writeBuf_.size());
+    bool sent = n == writeBuf_.size();
+    writeBuf_.clear();
+    if (!sent)
+        peerGone_ = true;
+    co_return sent;
+}
+
+void BufferedStream::scheduleCork()
+{
+    if (!autoCork_ || corkPending_)
+        return;
+    corkPending_ = true;
+    scheduler_->spawn([self = shared_from_this()]() -> Task<> {
+        co_await BackgroundHop{ self->scheduler_ };
+        self->corkPending_ = false;
+        try
+        {
+            [[maybe_unused]] auto lock = co_await self->writeMutex_.scoped_lock();
+            co_await self->flushLocked();
+        }
+        catch (...)
+        {
+            self->flushError_ = std::current_exception();
+        }
+    });
+}
+
+Task<> BufferedStream::shutdown()
+{
+    {
+        [[maybe_unused]] auto lock = co_await writeMutex_.scoped_lock();
+        rethrowFlushError();
+        co_await flushLocked();
+    }
+    co_await inner_->shutdown();
+}
+
+} // namespace nitrocoro::io
@@ -8,7 +8,13 @@
 #include <nitrocoro/utils/Debug.h>
 
 #include <cassert>
+#include <cerrno>
+#include <fcntl.h>
 #include <sys/epoll.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
 
 namespace nitrocoro::io
 {
@@ -18,38 +24,70 @@ Channel::Channel(int fd, TriggerMode mode, Scheduler * scheduler)
     , fd_(fd)
     , scheduler_(scheduler)
     , triggerMode_(mode)
-    , state_(std::make_shared<IoState>(fd))
+    , state_(std::make_shared<IoState>(fd, scheduler))
 {
     assert(scheduler_ != nullptr);
 
     scheduler->dispatch([id = id_, fd, weakState = std::weak_ptr(state_), scheduler]() {
-        if (auto _ = weakState.lock())
-        {
-            scheduler->setIoHandler(fd, id, [scheduler, weakState](int fd_, uint32_t ev) {
-                if (auto state = weakState.lock())
-                {
-                    assert(fd_ == state->fd);
-                    handleIoEvents(scheduler, state.get(), ev);
-                }
-            });
-        }
+        // The destructor keeps the state alive until removeIo(), so the raw pointer handed
+        // to the Scheduler stays valid for as long as it is registered.
+        if (auto state = weakState.lock())
+            scheduler->setIoHandler(fd, id, &Channel::handleIoEvents, state.get());
     });
 }
 
 Channel::~Channel() noexcept
 {
-    scheduler_->dispatch([fd = fd_, id = id_, scheduler = scheduler_, guard = std::move(guard_)]() {
+    state_->closed.store(true, std::memory_order_relaxed);
+    scheduler_->dispatch([fd = fd_, id = id_, scheduler = scheduler_, state = std::move(state_), guard = std::move(guard_)]() {
+        // Operations still in the kernel finish early and resume their
+        // awaiters from the kept-alive state; nothing may call into the
+        // Channel meanwhile, so their deadline and token hooks go now.
+        for (bool write : { false, true })
+        {
+            if (!state->inKernel(write))
+                continue;
+            if (TransferAwaiter * op = write ? state->writeOp : state->readOp)
+                op->disarm(scheduler);
+            scheduler->cancelIo(write ? &state->writeSub : &state->readSub);
+        }
         scheduler->removeIo(fd, id);
-        // guard auto released
+        // state and guard auto released
     });
 }
 
-void Channel::handleIoEvents(Scheduler * scheduler, IoState * state, uint32_t ev)
+static bool hasSocketError(int fd)
+{
+    int error = 0;
+    socklen_t len = sizeof(error);
+    return ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) != 0 || error != 0;
+}
+
+void Channel::handleIoEvents(void * context, int fd, uint32_t ev)
 {
+    auto * state = static_cast<IoState *>(context);
+    assert(fd == state->fd);
+    if (state->closed.load(std::memory_order_relaxed))
+        return;
+    Scheduler * scheduler = state->scheduler;
+
+    if ((ev & EPOLLERR) && state->errorQueue && !hasSocketError(fd))
+    {
+        // Only error-queue data (MSG_ZEROCOPY completions): wake whoever waits for it.
+        if (state->writableWaiter)
+            scheduler->schedule(std::exchange(state->writableWaiter, nullptr));
+        ev &= ~EPOLLERR;
+    }
+
     if (ev & EPOLLERR)
     {
         NITRO_TRACE("socket %d EPOLLERR", state->fd);
         state->errored = true;
+        // Ops in the kernel report the error through their own completion.
+        if (state->readOp && !state->inKernel(false) && state->readOp->attempt())
+            std::exchange(state->readOp, nullptr)->complete();
+        if (state->writeOp && !state->inKernel(true) && state->writeOp->attempt())
+            std::exchange(state->writeOp, nullptr)->complete();
         if (state->readableWaiter)
         {
             auto h = state->readableWaiter;
@@ -67,6 +105,17 @@ void Channel::handleIoEvents(Scheduler * scheduler, IoState * state, uint32_t ev
     if (ev & (EPOLLIN | EPOLLHUP)) // (POLLIN | POLLPRI | POLLRDHUP)
     {
         state->readable = true;
+        if (state->inKernel(false))
+        {
+            state->readable = false; // the submitted read takes the data
+        }
+        else if (state->readOp)
+        {
+            if (state->readOp->attempt())
+                std::exchange(state->readOp, nullptr)->complete();
+            else
+                state->readable = false;
+        }
         if (state->readableWaiter)
         {
             auto h = state->readableWaiter;
@@ -78,6 +127,17 @@ void Channel::handleIoEvents(Scheduler * scheduler, IoState * state, uint32_t ev
     {
         NITRO_DEBUG("Handle write fd %d writable = %d", state->fd, state->writable);
         state->writable = true;
+        if (state->inKernel(true))
+        {
+            state->writable = false;
+        }
+        else if (state->writeOp)
+        {
+            if (state->writeOp->attempt())
+                std::exchange(state->writeOp, nullptr)->complete();
+            else
+                state->writable = false;
+        }
         if (state->writableWaiter)
         {
             auto h = state->writableWaiter;
@@ -121,6 +181,261 @@ void Channel::WritableAwaiter::await_resume() noexcept
 {
 }
 
+bool Channel::TransferAwaiter::attempt() noexcept
+{
+    if (iov_ ? iovcnt_ == 0 : srcFd_ >= 0 ? len_ == 0 : (!buf_ || len_ == 0))
+        return true;
+
+    while (true)
+    {
+        ssize_t ret;
+        if (iov_)
+            ret = write_ ? ::writev(channel_->fd_, iov_, iovcnt_) : ::readv(channel_->fd_, iov_, iovcnt_);
+        else if (srcFd_ >= 0 && srcOffset_ >= 0)
+            ret = ::sendfile(channel_->fd_, srcFd_, &srcOffset_, len_);
+        else if (srcFd_ >= 0)
+            ret = ::splice(srcFd_, nullptr, channel_->fd_, nullptr, len_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        else
+            ret = write_ ? ::write(channel_->fd_, buf_, len_) : ::read(channel_->fd_, buf_, len_);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return false;
+            ret = -errno;
+        }
+        settle(ret);
+        return true;
+    }
+}
+
+void Channel::TransferAwaiter::settle(ssize_t ret) noexcept
+{
+    if (ret >= 0)
+    {
+        if (ret == 0 && !write_)
+            result_ = { IoResult::Eof, 0 };
+        else
+            result_ = { IoResult::Success, static_cast<size_t>(ret) };
+        return;
+    }
+    switch (-ret)
+    {
+        case EINVAL:
+        case ENOSYS:
+        case EOPNOTSUPP:
+            if (srcFd_ >= 0 && srcOffset_ >= 0)
+            {
+                result_ = { IoResult::Unsupported, 0 };
+                return;
+            }
+            result_ = { IoResult::Error, 0 };
+            return;
+        case EPIPE:
+        case ECONNRESET:
+            // Same mapping as BufferWriter; a reset seen by read() is an error
+            result_ = { write_ ? IoResult::Eof : IoResult::Error, 0 };
+            return;
+        default:
+            result_ = { IoResult::Error, 0 };
+            return;
+    }
+}
+
+bool Channel::TransferAwaiter::await_ready() noexcept
+{
+    if (limit_.token.isCancelled())
+    {
+        result_ = { IoResult::Canceled, 0 };
+        return true;
+    }
+    if (!channel_->scheduler_->isInOwnThread())
+        return false;
+
+    IoState * state = channel_->state_.get();
+    bool & ready = write_ ? state->writable : state->readable;
+    if (!ready && !state->errored)
+        return false;
+    if (attempt())
+        return true;
+    ready = false;
+    return false;
+}
+
+std::optional<Channel::Transfer> Channel::tryReadv(std::span<const iovec> iov) noexcept
+{
+    assert(scheduler_->isInOwnThread());
+    assert(!state_->readOp && !state_->inKernel(false));
+    TransferAwaiter op(this, iov, false, {});
+    if (op.attempt())
+        return op.result_;
+    state_->readable = false;
+    return std::nullopt;
+}
+
+void Channel::TransferAwaiter::await_suspend(std::coroutine_handle<> h) noexcept
+{
+    waiter_ = h;
+    Scheduler * scheduler = channel_->scheduler_;
+    if (scheduler->isInOwnThread())
+    {
+        park();
+        return;
+    }
+    // Slow path: hop to the loop thread and retry there.
+    scheduler->schedule([this] {
+        IoState * state = channel_->state_.get();
+        bool & ready = write_ ? state->writable : state->readable;
+        if ((ready || state->errored) && attempt())
+        {
+            channel_->scheduler_->schedule(waiter_);
+            return;
+        }
+        ready = false;
+        park();
+    });
+}
+
+void Channel::TransferAwaiter::park() noexcept
+{
+    if (!submit())
+        waitReady();
+
+    // Armed only once parked, so the callbacks always find this awaiter at its final address.
+    if (limit_.hasTimer())
+        timer_ = channel_->scheduler_->run_at(limit_.when, [this]() { expire(IoResult::TimedOut); });
+    if (limit_.token)
+        cancelReg_ = limit_.token.onCancel([this]() { expire(IoResult::Canceled); });
+}
+
+bool Channel::TransferAwaiter::submit() noexcept
+{
+    // sendfile()/splice() keep the readiness path
+    Scheduler * scheduler = channel_->scheduler_;
+    if (srcFd_ >= 0 || !scheduler->canSubmitIo())
+        return false;
+
+    IoState * state = channel_->state_.get();
+    IoState::Submission & op = write_ ? state->writeSub : state->readSub;
+    if (iov_)
+    {
+        op.kind = write_ ? IoOperation::Kind::Writev : IoOperation::Kind::Readv;
+        op.buf = const_cast<iovec *>(iov_);
+        op.len = static_cast<size_t>(iovcnt_);
+    }
+    else
+    {
+        op.kind = write_ ? IoOperation::Kind::Write : IoOperation::Kind::Read;
+        op.buf = buf_;
+        op.len = len_;
+    }
+    op.fd = channel_->fd_;
+    op.onComplete = &TransferAwaiter::onSubmitted;
+    op.write = write_;
+    op.canceling = false;
+    if (!scheduler->submitIo(&op))
+        return false;
+    op.keepAlive = channel_->state_;
+    (write_ ? state->writeOp : state->readOp) = this;
+    return true;
+}
+
+void Channel::TransferAwaiter::waitReady() noexcept
+{
+    IoState * state = channel_->state_.get();
+    if (write_)
+    {
+        channel_->enableWriting();
+        state->writeOp = this;
+    }
+    else
+    {
+        state->readOp = this;
+    }
+}
+
+void Channel::TransferAwaiter::onSubmitted(IoOperation * base, int result) noexcept
+{
+    auto * op = static_cast<IoState::Submission *>(base);
+    // Last use of op: the state may go with this reference once the Channel is gone.
+    std::shared_ptr<IoState> state = std::move(op->keepAlive);
+    TransferAwaiter *& slot = op->write ? state->writeOp : state->readOp;
+    TransferAwaiter * self = std::exchange(slot, nullptr);
+    if (!self)
+        return;
+    if (state->closed.load(std::memory_order_relaxed))
+    {
+        // The Channel is gone: hand over whatever the kernel did, touching only the state.
+        if (result >= 0)
+            self->settle(result);
+        else
+            self->result_ = { IoResult::Canceled, 0 };
+        state->scheduler->schedule(self->waiter_);
+        return;
+    }
+
+    if (op->canceling && (result == -ECANCELED || result == -EINTR))
+    {
+        self->result_ = { op->cancelResult, 0 };
+    }
+    else if (result == -EINTR || result == -EAGAIN || result == -EWOULDBLOCK)
+    {
+        // Interrupted, or a kernel that will not wait on this fd: retry now,
+        // then fall back to readiness.
+        if (!self->attempt())
+        {
+            if (result == -EAGAIN || result == -EWOULDBLOCK || !self->submit())
+                self->waitReady();
+            return;
+        }
+    }
+    else
+    {
+        self->settle(result);
+    }
+    self->complete();
+}
+
+void Channel::TransferAwaiter::expire(IoResult result) noexcept
+{
+    IoState * state = channel_->state_.get();
+    TransferAwaiter *& slot = write_ ? state->writeOp : state->readOp;
+    if (slot != this)
+        return; // completed in the meantime
+    IoState::Submission & op = write_ ? state->writeSub : state->readSub;
+    if (op.keepAlive)
+    {
+        // The kernel still owns the buffer: resume only when it reports back.
+        if (!op.canceling)
+        {
+            op.canceling = true;
+            op.cancelResult = result;
+            disarm(channel_->scheduler_);
+            channel_->scheduler_->cancelIo(&op);
+        }
+        return;
+    }
+    slot = nullptr;
+    result_ = { result, 0 };
+    complete();
+}
+
+void Channel::TransferAwaiter::disarm(Scheduler * scheduler) noexcept
+{
+    if (timer_ != kInvalidTimerId)
+        scheduler->cancel_timer(std::exchange(timer_, kInvalidTimerId));
+    cancelReg_.unregister();
+}
+
+void Channel::TransferAwaiter::complete() noexcept
+{
+    disarm(channel_->scheduler_);
+    if (write_)
+        channel_->disableWriting();
+    channel_->scheduler_->schedule(waiter_);
+}
+
 void Channel::enableReading()
 {
     if (!(events_ & EPOLLIN))
@@ -168,6 +483,8 @@ void Channel::disableAll()
 
 void Channel::cancelRead()
 {
+    if (state_->readOp)
+        state_->readOp->expire(IoResult::Canceled);
     if (state_->readableWaiter)
     {
         state_->readCanceled = true;
@@ -179,6 +496,8 @@ void Channel::cancelRead()
 
 void Channel::cancelWrite()
 {
+    if (state_->writeOp)
+        state_->writeOp->expire(IoResult::Canceled);
     if (state_->writableWaiter)
     {
         state_->writeCanceled = true;
@@ -207,6 +526,7 @@ namespace nitrocoro::io
 
 struct CallbackChannel::State
 {
+    std::atomic<bool> closed{ false };
     std::function<void()> onReadable;
     std::function<void()> onWritable;
     std::function<void()> onClose;
@@ -220,26 +540,25 @@ CallbackChannel::CallbackChannel(int fd, Scheduler * scheduler)
     , state_(std::make_shared<State>())
 {
     scheduler->dispatch([fd, id = id_, weakState = std::weak_ptr(state_), scheduler]() {
-        if (auto _ = weakState.lock())
-        {
-            scheduler->setIoHandler(fd, id, [weakState](int, uint32_t ev) {
-                if (auto state = weakState.lock())
-                    handleIoEvents(state.get(), ev);
-            });
-        }
+        if (auto state = weakState.lock())
+            scheduler->setIoHandler(fd, id, &CallbackChannel::handleIoEvents, state.get());
     });
 }
 
 CallbackChannel::~CallbackChannel() noexcept
 {
-    scheduler_->dispatch([fd = fd_, id = id_, scheduler = scheduler_, guard = std::move(guard_)]() {
+    state_->closed.store(true, std::memory_order_relaxed);
+    scheduler_->dispatch([fd = fd_, id = id_, scheduler = scheduler_, state = std::move(state_), guard = std::move(guard_)]() {
         scheduler->removeIo(fd, id);
-        // guard auto released
+        // state and guard auto released
     });
 }
 
-void CallbackChannel::handleIoEvents(State * state, uint32_t ev)
+void CallbackChannel::handleIoEvents(void * context, int, uint32_t ev)
 {
+    auto * state = static_cast<State *>(context);
+    if (state->closed.load(std::memory_order_relaxed))
+        return;
     if ((ev & EPOLLHUP) && !(ev & EPOLLIN) && state->onClose)
         state->onClose();
     if ((ev & EPOLLERR) && state->onError)
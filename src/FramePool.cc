@@ -0,0 +1,110 @@
+/**
+ * @file FramePool.cc
+ * @brief Coroutine frame pool implementation
+ */
+#include <nitrocoro/core/FramePool.h>
+
+#include <new>
+
+namespace nitrocoro::detail
+{
+
+namespace
+{
+
+struct FreeBlock
+{
+    FreeBlock * next;
+};
+
+// Trivially destructible so it stays usable while other thread_local or
+// static destructors free frames late in thread/process teardown.
+struct ThreadCache
+{
+    FreeBlock * heads[FramePool::kNumClasses];
+    uint32_t counts[FramePool::kNumClasses];
+    FramePoolStats stats;
+    bool armed;     // Reclaimer registered for this thread
+    bool reclaimed; // thread is exiting, bypass the cache
+};
+
+thread_local ThreadCache tlsCache{};
+
+// Returns cached blocks to the heap when the thread exits.
+struct Reclaimer
+{
+    ~Reclaimer()
+    {
+        for (size_t i = 0; i < FramePool::kNumClasses; ++i)
+        {
+            while (FreeBlock * block = tlsCache.heads[i])
+            {
+                tlsCache.heads[i] = block->next;
+                ::operator delete(block);
+            }
+            tlsCache.counts[i] = 0;
+        }
+        tlsCache.reclaimed = true;
+    }
+};
+
+thread_local Reclaimer tlsReclaimer;
+
+inline void armReclaimer(ThreadCache & cache)
+{
+    if (!cache.armed)
+    {
+        cache.armed = true;
+        [[maybe_unused]] auto * reclaimer = &tlsReclaimer; // odr-use constructs it
+    }
+}
+
+inline size_t classOf(size_t size)
+{
+    return (size + FramePool::kGranularity - 1) / FramePool::kGranularity - 1;
+}
+
+} // namespace
+
+void * FramePool::allocate(size_t size)
+{
+    auto & cache = tlsCache;
+    size_t cls = classOf(size);
+    if (cls < kNumClasses)
+    {
+        if (FreeBlock * block = cache.heads[cls])
+        {
+            cache.heads[cls] = block->next;
+            --cache.counts[cls];
+            ++cache.stats.hits;
+            return block;
+        }
+        ++cache.stats.misses;
+        return ::operator new((cls + 1) * kGranularity);
+    }
+    ++cache.stats.misses;
+    return ::operator new(size);
+}
+
+void FramePool::deallocate(void * ptr, size_t size) noexcept
+{
+    auto & cache = tlsCache;
+    size_t cls = classOf(size);
+    if (cls >= kNumClasses || cache.reclaimed || cache.counts[cls] >= kMaxCachedPerClass)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    armReclaimer(cache);
+    auto * block = static_cast<FreeBlock *>(ptr);
+    block->next = cache.heads[cls];
+    cache.heads[cls] = block;
+    ++cache.counts[cls];
+}
+
+FramePoolStats FramePool::stats() noexcept
+{
+    return tlsCache.stats;
+}
+
+} // namespace nitrocoro::detail
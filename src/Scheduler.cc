@@ -4,13 +4,20 @@
  */
 #include <nitrocoro/core/Scheduler.h>
 
+#include "poller/Poller.h"
+#include "timer/TimerWheel.h"
+
 #include <nitrocoro/io/Channel.h>
 #include <nitrocoro/utils/Debug.h>
 
+#include <algorithm>
 #include <cassert>
 #include <csignal>
 #include <cstring>
+#include <pthread.h>
+#include <sched.h>
 #include <stdexcept>
+#include <string>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
 #include <unistd.h>
@@ -23,7 +30,7 @@ namespace nitrocoro
 
 static constexpr int64_t kDefaultTimeoutMs = 10000;
 
-Scheduler::Scheduler()
+Scheduler::Scheduler(PollerType pollerType)
 {
     if (current_ != nullptr)
     {
@@ -31,15 +38,12 @@ Scheduler::Scheduler()
     }
 
     signal(SIGPIPE, SIG_IGN);
-    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
-    if (epollFd_ < 0)
-    {
-        throw std::runtime_error("Failed to create epoll");
-    }
+    poller_ = Poller::create(pollerType);
+    submitsIo_ = poller_->supportsSubmission();
+    timerWheel_ = std::make_unique<TimerWheel>(std::chrono::steady_clock::now());
     wakeupFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
     if (wakeupFd_ < 0)
     {
-        close(epollFd_);
         throw std::runtime_error("Failed to create wakeup fd");
     }
     current_ = this;
@@ -51,8 +55,6 @@ Scheduler::~Scheduler()
         current_ = nullptr;
     if (wakeupFd_ >= 0)
         close(wakeupFd_);
-    if (epollFd_ >= 0)
-        close(epollFd_);
 
     wakeupChannel_.reset(); // Channel destructor will access readyQueue_
 }
@@ -65,6 +67,7 @@ Scheduler * Scheduler::current() noexcept
 void Scheduler::run()
 {
     threadId_ = std::this_thread::get_id();
+    resumeSite_.store(&detail::tlsResumeSite, std::memory_order_release);
     wakeupChannel_ = std::make_unique<io::Channel>(wakeupFd_, TriggerMode::LevelTriggered, this);
     wakeupChannel_->enableReading();
 
@@ -88,15 +91,22 @@ void Scheduler::stop()
     }
 }
 
+TimePoint Scheduler::now() const noexcept
+{
+    if (isInOwnThread())
+        return loopTime_;
+    return std::chrono::steady_clock::now();
+}
+
 TimerAwaiter Scheduler::sleep_for(double seconds)
 {
-    auto when = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds));
+    auto when = now() + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds));
     return TimerAwaiter{ this, when };
 }
 
 TimerAwaiter Scheduler::sleep_for(std::chrono::steady_clock::duration dur)
 {
-    auto when = std::chrono::steady_clock::now() + dur;
+    auto when = now() + dur;
     return TimerAwaiter{ this, when };
 }
 
@@ -110,41 +120,241 @@ SchedulerAwaiter Scheduler::switch_to() noexcept
     return SchedulerAwaiter{ this };
 }
 
+void Scheduler::scheduleBatch(std::span<const std::coroutine_handle<>> handles)
+{
+    if (handles.empty())
+        return;
+    if (isInOwnThread())
+    {
+        for (auto handle : handles)
+            localReady_.push(handle);
+        return;
+    }
+
+    size_t pushed = 0;
+    while (pushed < handles.size() && remoteReady_.try_push(handles[pushed]))
+        ++pushed;
+    if (pushed < handles.size())
+    {
+        readyQueue_.push([rest = std::vector<std::coroutine_handle<>>(handles.begin() + pushed, handles.end())]() {
+            for (auto handle : rest)
+                handle.resume();
+        });
+    }
+    wakeup();
+}
+
+void Scheduler::schedule(std::coroutine_handle<> handle, Lane lane)
+{
+    if (lane == Lane::Normal)
+    {
+        schedule(handle);
+        return;
+    }
+    dispatch([this, handle]() { backgroundReady_.push(handle); });
+}
+
+void YieldAwaiter::await_suspend(std::coroutine_handle<> h)
+{
+    if (scheduler_->isInOwnThread())
+        scheduler_->yielded_[lane_ == Lane::Normal ? 0 : 1].push(h);
+    else
+        scheduler_->schedule(h, lane_);
+}
+
 void Scheduler::schedule(std::coroutine_handle<> handle)
 {
-    readyQueue_.push([handle]() { handle.resume(); });
-    if (!isInOwnThread())
+    if (isInOwnThread())
     {
-        wakeup();
+        localReady_.push(handle);
+        return;
+    }
+    if (!remoteReady_.try_push(handle))
+    {
+        readyQueue_.push([handle]() { handle.resume(); });
     }
+    wakeup();
 }
 
-void Scheduler::schedule_at(TimePoint when, std::coroutine_handle<> handle)
+TimerId Scheduler::schedule_at(TimePoint when, std::coroutine_handle<> handle)
 {
-    pendingTimers_.push(Timer{ when, handle });
-    if (!isInOwnThread())
+    return add_timer(when, handle, nullptr);
+}
+
+TimerId Scheduler::run_at(TimePoint when, std::function<void()> func)
+{
+    return add_timer(when, nullptr, std::move(func));
+}
+
+TimerId Scheduler::run_after(std::chrono::steady_clock::duration delay, std::function<void()> func)
+{
+    return add_timer(now() + delay, nullptr, std::move(func));
+}
+
+TimerId Scheduler::add_timer(TimePoint when, std::coroutine_handle<> handle, std::function<void()> func)
+{
+    if (isInOwnThread())
     {
-        wakeup();
+        return timerWheel_->add(when, TimerWheel::Entry{ handle, std::move(func) });
     }
+    pendingTimers_.push(Timer{ when, handle, std::move(func) });
+    wakeup();
+    return kInvalidTimerId;
+}
+
+void Scheduler::cancel_timer(TimerId id)
+{
+    if (id == kInvalidTimerId)
+        return;
+    dispatch([this, id]() { timerWheel_->cancel(id); });
 }
 
 void Scheduler::process_ready_queue()
 {
-    while (auto func = readyQueue_.pop())
+    stats_.readyDepth(localReady_.size());
+    // Coroutines that yielded during the previous drain rejoin their lanes now.
+    while (auto handle = yielded_[0].pop())
+        localReady_.push(handle);
+    while (auto handle = yielded_[1].pop())
+        backgroundReady_.push(handle);
+    readyPending_ = false;
+
+    size_t ran = 0;
+    TimePoint start = budgetTime_.count() ? std::chrono::steady_clock::now() : loopTime_;
+    while (true)
+    {
+        bool withinBudget = drain_normal_lanes(ran, start);
+
+        // The Background lane only runs once everything else is drained, but
+        // always gets one resume per iteration so it cannot starve entirely.
+        bool ranBackground = false;
+        while (auto handle = backgroundReady_.pop())
+        {
+            stats_.taskRun();
+            handle.resume();
+            ranBackground = true;
+            if (!withinBudget || ready_budget_exhausted(++ran, start))
+            {
+                readyPending_ = true;
+                return;
+            }
+            if (!localReady_.empty())
+                break; // new Normal work goes first
+        }
+        if (!withinBudget)
+        {
+            readyPending_ = true;
+            return;
+        }
+        if (!ranBackground)
+            return;
+    }
+}
+
+// Runs the function queue, the cross-thread ring and the local FIFO until all
+// are empty; returns false if the budget ran out first.
+bool Scheduler::drain_normal_lanes(size_t & ran, TimePoint start)
+{
+    bool drained = false;
+    while (!drained)
     {
-        (*func)();
+        drained = true;
+        while (auto func = readyQueue_.pop())
+        {
+            stats_.taskRun();
+            (*func)();
+            drained = false;
+            if (ready_budget_exhausted(++ran, start))
+                return false;
+        }
+        while (auto handle = remoteReady_.pop())
+        {
+            stats_.taskRun();
+            handle->resume();
+            drained = false;
+            if (ready_budget_exhausted(++ran, start))
+                return false;
+        }
+        while (auto handle = localReady_.pop())
+        {
+            stats_.taskRun();
+            handle.resume();
+            drained = false;
+            if (ready_budget_exhausted(++ran, start))
+                return false;
+        }
     }
+    return true;
+}
+
+bool Scheduler::ready_budget_exhausted(size_t ran, TimePoint start) const
+{
+    if (budgetTasks_ != 0 && ran >= budgetTasks_)
+        return true;
+    // Reading the clock per resume would cost more than most resumes.
+    if (budgetTime_.count() != 0 && (ran & 31) == 0)
+        return std::chrono::steady_clock::now() - start >= budgetTime_;
+    return false;
+}
+
+void Scheduler::setReadyBudget(size_t maxTasks, std::chrono::microseconds maxTime)
+{
+    budgetTasks_ = maxTasks;
+    budgetTime_ = maxTime;
+}
+
+void Scheduler::setBusyPoll(std::chrono::microseconds spin)
+{
+    busyPoll_ = spin;
+}
+
+void Scheduler::pinToCpu(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (err != 0)
+        throw std::runtime_error("Failed to pin thread to CPU " + std::to_string(cpu) + ": " + strerror(err));
 }
 
 void Scheduler::process_io_events(int timeout_ms)
 {
-    epoll_event events[128];
-    // TODO: abstract poller
-    int n = epoll_wait(epollFd_, events, 128, timeout_ms);
+    Poller::Event events[128];
+    stats_.beforePoll(loopTime_);
+    bool watched = watchdogs_.load(std::memory_order_relaxed) > 0;
+    if (watched)
+        busySinceNs_.store(0, std::memory_order_relaxed);
+    int n;
+    if (busyPoll_.count() == 0 || timeout_ms == 0)
+    {
+        n = poller_->poll(events, 128, timeout_ms);
+    }
+    else
+    {
+        // Spin with non-blocking polls, then block for whatever is left of the timeout.
+        auto deadline = loopTime_ + std::chrono::milliseconds(timeout_ms);
+        auto spinUntil = std::min(loopTime_ + busyPoll_, deadline);
+        auto now = loopTime_;
+        do
+        {
+            n = poller_->poll(events, 128, 0);
+            now = std::chrono::steady_clock::now();
+        } while (n == 0 && now < spinUntil);
+        if (n == 0 && now < deadline)
+            n = poller_->poll(events, 128, static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count()));
+    }
+    loopTime_ = std::chrono::steady_clock::now();
+    if (watched)
+    {
+        auto sinceEpoch = loopTime_.time_since_epoch();
+        busySinceNs_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count(), std::memory_order_relaxed);
+    }
+    stats_.afterPoll(n, loopTime_);
 
     for (int i = 0; i < n; ++i)
     {
-        int fd = events[i].data.fd;
+        int fd = events[i].fd;
         uint32_t ev = events[i].events;
         if (fd == wakeupChannel_->fd())
         {
@@ -152,16 +362,18 @@ void Scheduler::process_io_events(int timeout_ms)
             ssize_t ret = read(wakeupFd_, &dummy, sizeof(dummy));
             if (ret < 0)
                 NITRO_ERROR("wakeup read error: %s", strerror(errno));
+            // Acquire pairs with every producer's release, so work they queued
+            // before skipping their own write is visible to this iteration's drain.
+            wakeupPending_.exchange(false, std::memory_order_acq_rel);
             continue;
         }
 
-        auto iter = ioContexts_.find(fd);
-        if (iter == ioContexts_.end())
+        if (static_cast<size_t>(fd) >= ioContexts_.size() || ioContexts_[fd].id == 0)
         {
             NITRO_ERROR("fd %d not found!!!", fd);
             continue;
         }
-        auto * ctx = &iter->second;
+        const IoContext & ctx = ioContexts_[fd];
         NITRO_TRACE("fd %d event %d: IN: %d, OUT: %d, ERR: %d",
                     fd,
                     ev,
@@ -169,7 +381,8 @@ void Scheduler::process_io_events(int timeout_ms)
                     ev & EPOLLOUT,
                     ev & (EPOLLERR | EPOLLHUP));
 
-        ctx->handler(fd, ev);
+        if (ctx.handler)
+            ctx.handler(ctx.context, fd, ev);
     }
 }
 
@@ -177,39 +390,49 @@ int64_t Scheduler::get_next_timeout()
 {
     while (auto timer = pendingTimers_.pop())
     {
-        timers_.push(std::move(*timer));
+        timerWheel_->add(timer->when, TimerWheel::Entry{ timer->handle, std::move(timer->func) });
     }
 
-    if (timers_.empty())
-        return kDefaultTimeoutMs;
-
-    auto now = std::chrono::steady_clock::now();
-    auto next = timers_.top().when;
-
-    if (next <= now)
+    loopTime_ = std::chrono::steady_clock::now();
+    if (readyPending_ || !yielded_[0].empty() || !yielded_[1].empty() || !backgroundReady_.empty())
         return 0;
-
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(next - now);
-    return ms.count();
+    int64_t timeout = timerWheel_->nextTimeoutMs(loopTime_);
+    if (timeout < 0)
+        return kDefaultTimeoutMs;
+    return std::min(timeout, kDefaultTimeoutMs);
 }
 
 void Scheduler::process_timers()
 {
-    if (timers_.empty())
+    stats_.timersPending(timerWheel_->size());
+    if (timerWheel_->empty())
         return;
 
-    auto now = std::chrono::steady_clock::now();
-
-    while (!timers_.empty() && timers_.top().when <= now)
-    {
-        auto timer = std::move(timers_.top());
-        timers_.pop();
-        readyQueue_.push([handle = timer.handle]() { handle.resume(); });
-    }
+    timerWheel_->expire(loopTime_, [this](TimerWheel::Entry & entry) {
+        stats_.timerFired(entry.when, loopTime_);
+        if (entry.handle)
+        {
+            localReady_.push(entry.handle);
+            return;
+        }
+        try
+        {
+            entry.func();
+        }
+        catch (const std::exception & ex)
+        {
+            NITRO_ERROR("timer callback threw: %s", ex.what());
+        }
+    });
 }
 
 void Scheduler::wakeup()
 {
+    // Only the first producer since the loop last consumed the eventfd pays
+    // for the write; later ones are covered by the same wakeup.
+    if (wakeupPending_.exchange(true, std::memory_order_acq_rel))
+        return;
+    stats_.wakeup();
     uint64_t val = 1;
     ssize_t result = write(wakeupFd_, &val, sizeof(val));
     if (result < 0)
@@ -218,119 +441,114 @@ void Scheduler::wakeup()
     }
 }
 
-void Scheduler::setIoHandler(int fd, uint64_t id, Scheduler::IoEventHandler handler)
+// Returns the slot for (fd, id), claiming or resetting it if it belongs to an older id
+// (fd reuse); nullptr if the caller's id is the stale one.
+Scheduler::IoContext * Scheduler::findIo(int fd, uint64_t id)
 {
-    nitrocoro_SCHEDULER_ASSERT_IN_OWN_THREAD();
+    if (static_cast<size_t>(fd) >= ioContexts_.size())
+        ioContexts_.resize(std::max<size_t>(fd + 1, ioContexts_.size() * 2));
 
-    auto iter = ioContexts_.find(fd);
-    if (iter != ioContexts_.end())
+    IoContext & ctx = ioContexts_[fd];
+    if (ctx.id == 0)
     {
-        if (iter->second.id != id)
-        {
-            if (id < iter->second.id)
-            {
-                NITRO_TRACE("fd %d reuse detected, ignoring stale operation (cur id=%lu, op id=%lu)", fd, iter->second.id, id);
-                return;
-            }
-            NITRO_TRACE("fd %d reuse detected, evicting stale IoContext (cur id=%lu, op id=%lu)", fd, iter->second.id, id);
-            iter->second = IoContext{ fd, id, std::move(handler) };
-            return;
-        }
-
-        assert(iter->second.handler == nullptr);
-        iter->second.handler = std::move(handler);
+        ctx = IoContext{ id };
     }
-    else
+    else if (ctx.id != id)
     {
-        ioContexts_.emplace(fd, IoContext{ fd, id, std::move(handler) });
+        if (id < ctx.id)
+        {
+            NITRO_TRACE("fd %d reuse detected, ignoring stale operation (cur id=%lu, op id=%lu)", fd, ctx.id, id);
+            return nullptr;
+        }
+        NITRO_TRACE("fd %d reuse detected, evicting stale IoContext (cur id=%lu, op id=%lu)", fd, ctx.id, id);
+        ctx = IoContext{ id };
     }
+    return &ctx;
+}
+
+void Scheduler::setIoHandler(int fd, uint64_t id, IoEventHandler handler, void * context)
+{
+    nitrocoro_SCHEDULER_ASSERT_IN_OWN_THREAD();
+
+    IoContext * ctx = findIo(fd, id);
+    if (!ctx)
+        return;
+
+    assert(ctx->handler == nullptr);
+    ctx->handler = handler;
+    ctx->context = context;
 }
 
 void Scheduler::updateIo(int fd, uint64_t id, uint32_t events, TriggerMode mode)
 {
     nitrocoro_SCHEDULER_ASSERT_IN_OWN_THREAD();
 
-    IoContext * ctx;
-    auto iter = ioContexts_.find(fd);
-    if (iter != ioContexts_.end())
-    {
-        if (iter->second.id != id)
-        {
-            if (id < iter->second.id)
-            {
-                NITRO_TRACE("fd %d reuse detected, ignoring stale operation (cur id=%lu, op id=%lu)", fd, iter->second.id, id);
-                return;
-            }
-            NITRO_TRACE("fd %d reuse detected, evicting stale IoContext (cur id=%lu, op id=%lu)", fd, iter->second.id, id);
-            iter->second = IoContext{ fd, id, {} };
-        }
-        ctx = &iter->second;
-    }
-    else
-    {
-        ctx = &ioContexts_.emplace(fd, IoContext{ fd, id, {} }).first->second;
-    }
+    IoContext * ctx = findIo(fd, id);
+    if (!ctx)
+        return;
 
     if (events == 0)
     {
-        if (ctx->addedToEpoll)
+        if (ctx->addedToPoller)
         {
-            epoll_event ev{};
-            if (::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, &ev) < 0)
+            if (!poller_->removeFd(fd))
             {
-                NITRO_ERROR("Failed to call EPOLL_CTL_DEL on epoll %d fd %d errno %d: %s\n", epollFd_, fd, errno, strerror(errno));
-                // throw std::runtime_error("Failed to call EPOLL_CTL_DEL on epoll");
+                NITRO_ERROR("Failed to remove fd %d from poller errno %d: %s\n", fd, errno, strerror(errno));
             }
-            ctx->addedToEpoll = false;
+            ctx->addedToPoller = false;
         }
         return;
     }
 
-    epoll_event ev{};
-    ev.events = events | (mode == TriggerMode::EdgeTriggered ? EPOLLET : 0);
-    ev.data.fd = fd;
-
-    int op = ctx->addedToEpoll ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
-    if (::epoll_ctl(epollFd_, op, fd, &ev) < 0)
-    {
-        NITRO_ERROR("epoll_ctl %s fd %d ev %d error: %s",
-                    ctx->addedToEpoll ? "MOD" : "ADD", fd, events, strerror(errno));
-        throw std::runtime_error(ctx->addedToEpoll ? "Failed to call EPOLL_CTL_MOD on epoll" : "Failed to call EPOLL_CTL_ADD on epoll");
-    }
+    if (ctx->addedToPoller)
+        poller_->modifyFd(fd, events, mode);
+    else
+        poller_->addFd(fd, events, mode);
 
-    ctx->addedToEpoll = true;
+    ctx->addedToPoller = true;
 }
 
 void Scheduler::removeIo(int fd, uint64_t id)
 {
     nitrocoro_SCHEDULER_ASSERT_IN_OWN_THREAD();
 
-    auto iter = ioContexts_.find(fd);
-    assert(iter != ioContexts_.end());
-    if (iter->second.id != id)
+    assert(static_cast<size_t>(fd) < ioContexts_.size() && ioContexts_[fd].id != 0);
+    if (static_cast<size_t>(fd) >= ioContexts_.size())
+        return;
+    IoContext & slot = ioContexts_[fd];
+    if (slot.id != id)
     {
-        if (id > iter->second.id)
-            NITRO_ERROR("fd %d removeIo: unexpected op id > cur id (cur id=%lu, op id=%lu)\n", fd, iter->second.id, id);
-        NITRO_TRACE("fd %d reuse detected, ignoring stale operation (cur id=%lu, op id=%lu)", fd, iter->second.id, id);
+        if (id > slot.id)
+            NITRO_ERROR("fd %d removeIo: unexpected op id > cur id (cur id=%lu, op id=%lu)\n", fd, slot.id, id);
+        NITRO_TRACE("fd %d reuse detected, ignoring stale operation (cur id=%lu, op id=%lu)", fd, slot.id, id);
         return;
     }
 
-    auto ctx = std::move(iter->second);
-    ioContexts_.erase(iter);
+    bool addedToPoller = slot.addedToPoller;
+    slot = IoContext{};
 
-    if (!ctx.addedToEpoll)
+    if (!addedToPoller)
     {
         return;
     }
-    epoll_event ev{};
-    ev.events = 0;
-    ev.data.fd = fd;
-    if (::epoll_ctl(epollFd_, EPOLL_CTL_DEL, ctx.fd, &ev) < 0)
+    if (!poller_->removeFd(fd))
     {
-        NITRO_TRACE("Failed to call EPOLL_CTL_DEL on epoll %d fd %d, error = %d", epollFd_, ctx.fd, errno);
+        NITRO_TRACE("Failed to remove fd %d from poller, error = %d", fd, errno);
     }
 }
 
+bool Scheduler::submitIo(IoOperation * op)
+{
+    nitrocoro_SCHEDULER_ASSERT_IN_OWN_THREAD();
+    return submitsIo_ && poller_->submit(op);
+}
+
+void Scheduler::cancelIo(IoOperation * op)
+{
+    nitrocoro_SCHEDULER_ASSERT_IN_OWN_THREAD();
+    poller_->cancel(op);
+}
+
 bool Scheduler::isInOwnThread() const noexcept
 {
     return std::this_thread::get_id() == threadId_;
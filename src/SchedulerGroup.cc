@@ -0,0 +1,159 @@
+/**
+ * @file SchedulerGroup.cc
+ * @brief SchedulerGroup implementation
+ */
+#include <nitrocoro/core/SchedulerGroup.h>
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <sched.h>
+#include <stdexcept>
+
+namespace nitrocoro
+{
+
+SchedulerGroup::SchedulerGroup(size_t numThreads, PollerType pollerType)
+    : numThreads_(numThreads)
+    , pollerType_(pollerType)
+{
+    if (numThreads_ == 0)
+        numThreads_ = std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+SchedulerGroup::~SchedulerGroup()
+{
+    stop();
+    wait();
+}
+
+void SchedulerGroup::setCpuAffinity(std::vector<int> cpus)
+{
+    if (started_)
+        throw std::logic_error("SchedulerGroup::setCpuAffinity() after start()");
+    if (cpus.empty())
+    {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &allowed))
+                    cpus.push_back(cpu);
+            }
+        }
+        if (cpus.empty())
+            throw std::runtime_error("SchedulerGroup::setCpuAffinity(): no CPU available");
+    }
+    pinned_ = true;
+    cpus_ = std::move(cpus);
+}
+
+void SchedulerGroup::setBusyPoll(std::chrono::microseconds spin)
+{
+    if (started_)
+        throw std::logic_error("SchedulerGroup::setBusyPoll() after start()");
+    busyPoll_ = spin;
+}
+
+void SchedulerGroup::start()
+{
+    if (started_)
+        throw std::logic_error("SchedulerGroup already started");
+    started_ = true;
+
+    std::vector<std::promise<Scheduler *>> ready(numThreads_);
+    threads_.reserve(numThreads_);
+    for (size_t i = 0; i < numThreads_; ++i)
+    {
+        int cpu = pinned_ ? cpus_[i % cpus_.size()] : -1;
+        threads_.emplace_back([pollerType = pollerType_, busyPoll = busyPoll_, cpu, &promise = ready[i]]() {
+            // Setup failures (pinning, or a poller the kernel refuses, e.g.
+            // io_uring under a seccomp profile) are rethrown by start().
+            std::optional<Scheduler> scheduler;
+            try
+            {
+                // Pin first: everything the Scheduler allocates is then first touched on its node.
+                if (cpu >= 0)
+                    Scheduler::pinToCpu(cpu);
+                scheduler.emplace(pollerType);
+                scheduler->setBusyPoll(busyPoll);
+            }
+            catch (...)
+            {
+                promise.set_exception(std::current_exception());
+                return;
+            }
+            // Report readiness from inside the loop, so a stop() issued right
+            // after start() returns cannot race with run() setting running_.
+            scheduler->schedule([&scheduler, &promise]() { promise.set_value(&*scheduler); });
+            scheduler->run();
+        });
+    }
+
+    std::vector<Scheduler *> schedulers;
+    schedulers.reserve(numThreads_);
+    std::exception_ptr failure;
+    for (auto & promise : ready)
+    {
+        try
+        {
+            schedulers.push_back(promise.get_future().get());
+        }
+        catch (...)
+        {
+            failure = std::current_exception();
+        }
+    }
+    {
+        std::lock_guard lock(mutex_);
+        schedulers_ = std::move(schedulers);
+        // A stop() that arrived while the loops were starting still applies
+        if (stopped_)
+        {
+            for (auto * scheduler : schedulers_)
+                scheduler->stop();
+        }
+    }
+    if (failure)
+    {
+        stop();
+        wait();
+        std::rethrow_exception(failure);
+    }
+}
+
+void SchedulerGroup::stop()
+{
+    // Only the first call reaches the loops: once they exit, their Schedulers
+    // are gone from the loop threads' stacks and the pointers dangle.
+    std::lock_guard lock(mutex_);
+    if (stopped_)
+        return;
+    stopped_ = true;
+    for (auto * scheduler : schedulers_)
+        scheduler->stop();
+}
+
+void SchedulerGroup::wait()
+{
+    for (auto & t : threads_)
+    {
+        if (t.joinable())
+            t.join();
+    }
+    threads_.clear();
+}
+
+Scheduler * SchedulerGroup::next() noexcept
+{
+    if (schedulers_.empty())
+        return nullptr;
+    size_t index = nextIndex_.fetch_add(1, std::memory_order_relaxed);
+    return schedulers_[index % schedulers_.size()];
+}
+
+} // namespace nitrocoro
@@ -0,0 +1,80 @@
+/**
+ * @file SchedulerStats.cc
+ * @brief Scheduler statistics recorder and histogram helpers
+ */
+#include <nitrocoro/core/SchedulerStats.h>
+
+#include <bit>
+#include <cmath>
+
+namespace nitrocoro
+{
+
+uint64_t LatencyHistogram::percentileUs(double p) const noexcept
+{
+    if (count == 0)
+        return 0;
+    auto target = static_cast<uint64_t>(std::ceil(p * static_cast<double>(count)));
+    if (target == 0)
+        target = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= target)
+            return i + 1 == kBuckets ? maxUs : uint64_t{ 1 } << i;
+    }
+    return maxUs;
+}
+
+#ifndef NITROCORO_DISABLE_SCHEDULER_STATS
+
+namespace detail
+{
+
+void SchedulerStatsRecorder::Histogram::record(uint64_t us) noexcept
+{
+    size_t bucket = us == 0 ? 0 : static_cast<size_t>(std::bit_width(us));
+    if (bucket >= LatencyHistogram::kBuckets)
+        bucket = LatencyHistogram::kBuckets - 1;
+    bump(buckets[bucket]);
+    bump(count);
+    bump(totalUs, us);
+    raise(maxUs, us);
+}
+
+void SchedulerStatsRecorder::Histogram::load(LatencyHistogram & out) const noexcept
+{
+    for (size_t i = 0; i < LatencyHistogram::kBuckets; ++i)
+        out.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+    out.count = count.load(std::memory_order_relaxed);
+    out.totalUs = totalUs.load(std::memory_order_relaxed);
+    out.maxUs = maxUs.load(std::memory_order_relaxed);
+}
+
+SchedulerStats SchedulerStatsRecorder::snapshot() const noexcept
+{
+    SchedulerStats s;
+    s.enabled = true;
+    s.iterations = iterations_.load(std::memory_order_relaxed);
+    s.pollWaitNs = pollWaitNs_.load(std::memory_order_relaxed);
+    s.busyNs = busyNs_.load(std::memory_order_relaxed);
+    s.ioEvents = ioEvents_.load(std::memory_order_relaxed);
+    s.maxEventsPerPoll = maxEventsPerPoll_.load(std::memory_order_relaxed);
+    s.tasksRun = tasksRun_.load(std::memory_order_relaxed);
+    s.readyDepth = readyDepth_.load(std::memory_order_relaxed);
+    s.maxReadyDepth = maxReadyDepth_.load(std::memory_order_relaxed);
+    s.timersPending = timersPending_.load(std::memory_order_relaxed);
+    s.timersFired = timersFired_.load(std::memory_order_relaxed);
+    s.wakeups = wakeups_.load(std::memory_order_relaxed);
+    loopBusy_.load(s.loopBusy);
+    timerLateness_.load(s.timerLateness);
+    return s;
+}
+
+} // namespace detail
+
+#endif
+
+} // namespace nitrocoro
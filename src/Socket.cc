@@ -38,4 +38,35 @@ void Socket::shutdownWrite() noexcept
         NITRO_ERROR("shutdownWrite fd %d failed: %s", fd_, strerror(errno));
 }
 
+bool Socket::setBusyPoll(std::chrono::microseconds spin) noexcept
+{
+    int usec = static_cast<int>(spin.count());
+    if (::setsockopt(fd_, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec)) < 0)
+    {
+        NITRO_DEBUG("SO_BUSY_POLL on fd %d failed: %s", fd_, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool Socket::setZeroCopy() noexcept
+{
+    int on = 1;
+    if (::setsockopt(fd_, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) < 0)
+    {
+        NITRO_DEBUG("SO_ZEROCOPY on fd %d failed: %s", fd_, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void Socket::abort() noexcept
+{
+    // connect(AF_UNSPEC) runs tcp_disconnect(): RST, and the send queue is purged.
+    sockaddr addr{};
+    addr.sa_family = AF_UNSPEC;
+    if (::connect(fd_, &addr, sizeof(addr)) < 0)
+        NITRO_DEBUG("abort fd %d failed: %s", fd_, strerror(errno));
+}
+
 } // namespace nitrocoro::net
@@ -0,0 +1,101 @@
+/**
+ * @file StallWatchdog.cc
+ * @brief StallWatchdog implementation
+ */
+#include <nitrocoro/core/StallWatchdog.h>
+
+#include <nitrocoro/core/SchedulerGroup.h>
+#include <nitrocoro/utils/Debug.h>
+
+#include <algorithm>
+
+namespace nitrocoro
+{
+
+StallWatchdog::StallWatchdog(std::vector<Scheduler *> schedulers, std::chrono::milliseconds threshold, Handler handler)
+    : threshold_(std::max(threshold, std::chrono::milliseconds(1)))
+    , handler_(std::move(handler))
+{
+    if (!handler_)
+    {
+        handler_ = [](const StallReport & report) {
+            NITRO_ERROR("Scheduler %p stalled for %lld ms, running coroutine resumed at %s:%u (%s)",
+                        static_cast<void *>(report.scheduler),
+                        static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(report.duration).count()),
+                        report.site.file_name(),
+                        static_cast<unsigned>(report.site.line()),
+                        report.site.function_name());
+        };
+    }
+
+    watched_.reserve(schedulers.size());
+    for (Scheduler * scheduler : schedulers)
+    {
+        scheduler->watchdogs_.fetch_add(1, std::memory_order_relaxed);
+        watched_.push_back(Watched{ scheduler });
+    }
+    thread_ = std::thread([this]() { run(); });
+}
+
+StallWatchdog::StallWatchdog(const SchedulerGroup & group, std::chrono::milliseconds threshold, Handler handler)
+    : StallWatchdog(group.schedulers(), threshold, std::move(handler))
+{
+}
+
+StallWatchdog::~StallWatchdog()
+{
+    stop();
+}
+
+void StallWatchdog::stop()
+{
+    {
+        std::lock_guard lock(mutex_);
+        if (stopping_)
+            return;
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())
+        thread_.join();
+    for (auto & watched : watched_)
+        watched.scheduler->watchdogs_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void StallWatchdog::run()
+{
+    // Sample several times per threshold so reports are not late by a full period.
+    auto period = std::max<std::chrono::steady_clock::duration>(threshold_ / 4, std::chrono::milliseconds(1));
+    std::unique_lock lock(mutex_);
+    while (!cv_.wait_for(lock, period, [this] { return stopping_; }))
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+        for (auto & watched : watched_)
+            check(watched, nowNs);
+    }
+}
+
+void StallWatchdog::check(Watched & watched, int64_t nowNs)
+{
+    int64_t since = watched.scheduler->busySinceNs_.load(std::memory_order_relaxed);
+    if (since == 0 || nowNs <= since)
+        return;
+
+    int64_t busyNs = nowNs - since;
+    if (since != watched.stallStartNs)
+    {
+        watched.stallStartNs = since;
+        watched.nextReportNs = std::chrono::duration_cast<std::chrono::nanoseconds>(threshold_).count();
+    }
+    if (busyNs < watched.nextReportNs)
+        return;
+    watched.nextReportNs *= 2;
+
+    StallReport report{ watched.scheduler, std::chrono::nanoseconds(busyNs), {} };
+    if (auto * site = watched.scheduler->resumeSite_.load(std::memory_order_acquire))
+        report.site = site->load(std::memory_order_relaxed);
+    handler_(report);
+}
+
+} // namespace nitrocoro
@@ -5,19 +5,28 @@
 #include <nitrocoro/net/TcpConnection.h>
 
 #include <nitrocoro/core/Scheduler.h>
-#include <nitrocoro/io/adapters/BufferReader.h>
-#include <nitrocoro/io/adapters/BufferWriter.h>
+#include <nitrocoro/core/Timeout.h>
 #include <nitrocoro/net/InetAddress.h>
 #include <nitrocoro/net/Socket.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
 namespace nitrocoro::net
 {
 
 using nitrocoro::Scheduler;
 using nitrocoro::Task;
 using nitrocoro::io::Channel;
-using nitrocoro::io::adapters::BufferReader;
-using nitrocoro::io::adapters::BufferWriter;
 using nitrocoro::net::Socket;
 
 struct Connector
@@ -85,7 +94,117 @@ private:
     bool connecting_{ false };
 };
 
-Task<TcpConnectionPtr> TcpConnection::connect(const InetAddress & addr)
+// Sends buffers with MSG_ZEROCOPY, then waits on the error queue until the
+// kernel has reported every one of those sends complete.
+struct ZeroCopySender
+{
+    explicit ZeroCopySender(std::span<const iovec> iov)
+        : iov_(iov.begin(), iov.end())
+    {
+        advance(0);
+    }
+
+    Channel::IoStatus operator()(int fd, Channel * channel)
+    {
+        while (next_ < iov_.size())
+        {
+            msghdr msg{};
+            msg.msg_iov = iov_.data() + next_;
+            msg.msg_iovlen = std::min<size_t>(iov_.size() - next_, IOV_MAX);
+            ssize_t n = ::sendmsg(fd, &msg, copying_ ? 0 : MSG_ZEROCOPY);
+            if (n >= 0)
+            {
+                advance(static_cast<size_t>(n));
+                if (!copying_)
+                    ++issued_;
+                continue;
+            }
+            switch (errno)
+            {
+                case EAGAIN:
+#if EAGAIN != EWOULDBLOCK
+                case EWOULDBLOCK:
+#endif
+                    channel->enableWriting();
+                    return Channel::IoStatus::NeedWrite;
+                case EINTR:
+                    continue;
+                case ENOBUFS:
+                    // Out of optmem for pinned pages: copy the rest.
+                    copying_ = true;
+                    continue;
+                case EPIPE:
+                case ECONNRESET:
+                    // The kernel purged the send queue with the connection.
+                    channel->disableWriting();
+                    return Channel::IoStatus::Eof;
+                default:
+                    return Channel::IoStatus::Error;
+            }
+        }
+        channel->disableWriting();
+
+        if (!drainCompletions(fd))
+            return Channel::IoStatus::Error;
+        if (completed_ >= issued_)
+            return Channel::IoStatus::Success;
+        if (channel->errored())
+            return Channel::IoStatus::Error;
+        return Channel::IoStatus::NeedErrorQueue;
+    }
+
+    // False on an error-queue entry that is not a zero-copy completion.
+    bool drainCompletions(int fd)
+    {
+        while (true)
+        {
+            char control[128];
+            msghdr msg{};
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            if (::recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+
+            for (cmsghdr * cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm))
+            {
+                bool recverr = (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR)
+                               || (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR);
+                if (!recverr)
+                    continue;
+                sock_extended_err err;
+                std::memcpy(&err, CMSG_DATA(cm), sizeof(err));
+                if (err.ee_origin != SO_EE_ORIGIN_ZEROCOPY || err.ee_errno != 0)
+                    return false;
+                // Sends [ee_info, ee_data] are done; the kernel numbers them from 0 per socket.
+                completed_ += err.ee_data - err.ee_info + 1;
+            }
+        }
+    }
+
+    bool unfinished() const noexcept { return completed_ < issued_; }
+
+private:
+    // Steps past @p n sent bytes and any empty buffers after them, so no
+    // zero-length send is issued (it would get no completion).
+    void advance(size_t n)
+    {
+        while (next_ < iov_.size() && n >= iov_[next_].iov_len)
+            n -= iov_[next_++].iov_len;
+        if (n > 0)
+        {
+            iov_[next_].iov_base = static_cast<char *>(iov_[next_].iov_base) + n;
+            iov_[next_].iov_len -= n;
+        }
+    }
+
+    std::vector<iovec> iov_;
+    size_t next_{ 0 };
+    uint32_t issued_{ 0 };
+    uint32_t completed_{ 0 };
+    bool copying_{ false };
+};
+
+Task<TcpConnectionPtr> TcpConnection::connect(const InetAddress & addr, IoDeadline limit)
 {
     int fd = ::socket(addr.family(), SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (fd < 0)
@@ -95,7 +214,29 @@ Task<TcpConnectionPtr> TcpConnection::connect(const InetAddress & addr)
     channelPtr->setGuard(socket);
     socklen_t addrLen = addr.isIpV6() ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
     Connector connector(addr.getSockAddr(), addrLen);
+
+    // Both hooks cancel the pending writable wait; the timer is dropped as soon
+    // as the handshake finishes, and reg unregisters when leaving scope.
+    Scheduler * scheduler = channelPtr->scheduler();
+    if (scheduler->busyPoll().count() > 0)
+        socket->setBusyPoll(scheduler->busyPoll());
+    bool timedOut = false;
+    TimerId timer = kInvalidTimerId;
+    if (limit.hasTimer())
+        timer = scheduler->run_at(limit.when, [ch = channelPtr.get(), &timedOut]() {
+            timedOut = true;
+            ch->cancelWrite();
+        });
+    auto reg = limit.token.onCancel([ch = channelPtr.get()] { ch->cancelWrite(); });
+
     auto result = co_await channelPtr->performWrite(&connector);
+    scheduler->cancel_timer(timer);
+    if (result == Channel::IoResult::Canceled)
+    {
+        if (timedOut)
+            throw TimeoutException();
+        throw CancelledException();
+    }
     if (result != Channel::IoResult::Success)
         throw std::runtime_error("TCP connect failed");
     co_return std::make_shared<TcpConnection>(std::move(channelPtr), std::move(socket), InetAddress::getLocalAddr(fd), addr);
@@ -113,40 +254,313 @@ TcpConnection::TcpConnection(std::unique_ptr<Channel> channelPtr, std::shared_pt
 
 TcpConnection::~TcpConnection() = default;
 
-Task<size_t> TcpConnection::read(void * buf, size_t len)
+Task<size_t> TcpConnection::read(void * buf, size_t len, IoDeadline limit)
+{
+    co_return co_await readSome(buf, len, std::move(limit));
+}
+
+Task<size_t> TcpConnection::readv(std::span<const iovec> iov, IoDeadline limit)
+{
+    co_return co_await readvSome(iov, std::move(limit));
+}
+
+Task<> TcpConnection::waitReadable(IoDeadline limit)
+{
+    auto peeker = [](int fd, Channel *) {
+        char c;
+        if (::recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) >= 0)
+            return Channel::IoStatus::Success;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return Channel::IoStatus::NeedRead;
+        if (errno == EINTR)
+            return Channel::IoStatus::Retry;
+        // Let the next read report the error
+        return Channel::IoStatus::Success;
+    };
+
+    Scheduler * scheduler = ioChannelPtr_->scheduler();
+    bool timedOut = false;
+    TimerId timer = kInvalidTimerId;
+    if (limit.hasTimer())
+        timer = scheduler->run_at(limit.when, [ch = ioChannelPtr_.get(), &timedOut]() {
+            timedOut = true;
+            ch->cancelRead();
+        });
+    auto reg = limit.token.onCancel([ch = ioChannelPtr_.get()] { ch->cancelRead(); });
+
+    // A tryReadv() that just hit EAGAIN already did the peek's job
+    auto hint = std::exchange(drained_, false) ? Channel::WaitHint::Read : Channel::WaitHint::None;
+    auto result = co_await ioChannelPtr_->perform(peeker, hint);
+    scheduler->cancel_timer(timer);
+    if (result == Channel::IoResult::Canceled)
+    {
+        if (timedOut)
+            throw TimeoutException();
+        throw CancelledException();
+    }
+}
+
+std::optional<size_t> TcpConnection::tryReadv(std::span<const iovec> iov)
+{
+    auto transfer = ioChannelPtr_->tryReadv(iov);
+    if (!transfer)
+    {
+        drained_ = true;
+        return std::nullopt;
+    }
+    drained_ = false;
+    return finishRead(*transfer);
+}
+
+Task<size_t> TcpConnection::write(const void * buf, size_t len, IoDeadline limit)
+{
+    if (zeroCopyThreshold_ != 0 && len >= zeroCopyThreshold_)
+    {
+        iovec one{ const_cast<void *>(buf), len };
+        co_return co_await writeZeroCopy(std::span<const iovec>(&one, 1), len, std::move(limit));
+    }
+
+    size_t written = 0;
+    while (written < len)
+    {
+        size_t n = co_await writeSome(static_cast<const char *>(buf) + written, len - written, limit);
+        if (n == 0)
+            co_return 0;
+        written += n;
+    }
+    co_return len;
+}
+
+Task<size_t> TcpConnection::writev(std::span<const iovec> iov, IoDeadline limit)
 {
-    BufferReader reader(buf, len);
-    auto result = co_await ioChannelPtr_->performRead(&reader);
+    size_t total = 0;
+    for (const auto & v : iov)
+        total += v.iov_len;
+    if (zeroCopyThreshold_ != 0 && total >= zeroCopyThreshold_)
+        co_return co_await writeZeroCopy(iov, total, std::move(limit));
+
+    size_t n = co_await writevSome(iov, limit);
+    if (n == total || n == 0)
+        co_return n;
+
+    // Short write: finish from a copy we can advance past what went out.
+    std::vector<iovec> rest(iov.begin(), iov.end());
+    size_t written = n;
+    size_t first = 0;
+    while (true)
+    {
+        while (n >= rest[first].iov_len)
+            n -= rest[first++].iov_len;
+        rest[first].iov_base = static_cast<char *>(rest[first].iov_base) + n;
+        rest[first].iov_len -= n;
+
+        n = co_await writevSome(std::span<const iovec>(rest).subspan(first), limit);
+        if (n == 0)
+            co_return 0;
+        written += n;
+        if (written == total)
+            co_return total;
+    }
+}
+
+bool TcpConnection::setZeroCopyThreshold(size_t threshold)
+{
+    if (threshold == 0)
+    {
+        zeroCopyThreshold_ = 0;
+        return true;
+    }
+    if (!socket_ || !socket_->setZeroCopy())
+        return false;
+    ioChannelPtr_->enableErrorQueue();
+    zeroCopyThreshold_ = threshold;
+    return true;
+}
+
+Task<size_t> TcpConnection::writeZeroCopy(std::span<const iovec> iov, size_t total, IoDeadline limit)
+{
+    Scheduler * scheduler = ioChannelPtr_->scheduler();
+    bool timedOut = false;
+    TimerId timer = kInvalidTimerId;
+    if (limit.hasTimer())
+        timer = scheduler->run_at(limit.when, [ch = ioChannelPtr_.get(), &timedOut]() {
+            timedOut = true;
+            ch->cancelWrite();
+        });
+    auto reg = limit.token.onCancel([ch = ioChannelPtr_.get()] { ch->cancelWrite(); });
+
+    ZeroCopySender sender(iov);
+    auto result = co_await ioChannelPtr_->performWrite(&sender);
+    scheduler->cancel_timer(timer);
+    ioChannelPtr_->disableWriting();
+
+    if (result == Channel::IoResult::Canceled)
+    {
+        // The kernel may still read the caller's buffer: discard what it holds.
+        if (sender.unfinished())
+        {
+            socket_->abort();
+            state_ = State::Closed;
+        }
+        if (timedOut)
+            throw TimeoutException();
+        throw CancelledException();
+    }
+    if (result == Channel::IoResult::Eof)
+    {
+        state_ = State::Closed;
+        co_return 0;
+    }
+    if (result != Channel::IoResult::Success)
+    {
+        if (sender.unfinished())
+            socket_->abort();
+        state_ = State::Closed;
+        throw std::runtime_error("TCP write error");
+    }
+    co_return total;
+}
+
+TcpConnection::ReadSomeAwaiter TcpConnection::readSome(void * buf, size_t len, IoDeadline limit) noexcept
+{
+    drained_ = false;
+    return { this, ioChannelPtr_->readSome(buf, len, std::move(limit)) };
+}
+
+TcpConnection::ReadSomeAwaiter TcpConnection::readvSome(std::span<const iovec> iov, IoDeadline limit) noexcept
+{
+    drained_ = false;
+    return { this, ioChannelPtr_->readvSome(iov, std::move(limit)) };
+}
+
+TcpConnection::WriteSomeAwaiter TcpConnection::writeSome(const void * buf, size_t len, IoDeadline limit) noexcept
+{
+    return { this, ioChannelPtr_->writeSome(buf, len, std::move(limit)) };
+}
+
+TcpConnection::WriteSomeAwaiter TcpConnection::writevSome(std::span<const iovec> iov, IoDeadline limit) noexcept
+{
+    return { this, ioChannelPtr_->writevSome(iov, std::move(limit)) };
+}
+
+// Deadline and token expiry leave the connection intact.
+static void throwIfInterrupted(Channel::IoResult result)
+{
+    if (result == Channel::IoResult::TimedOut)
+        throw TimeoutException();
+    if (result == Channel::IoResult::Canceled)
+        throw CancelledException();
+}
+
+size_t TcpConnection::ReadSomeAwaiter::await_resume()
+{
+    return conn_->finishRead(inner_.await_resume());
+}
+
+size_t TcpConnection::WriteSomeAwaiter::await_resume()
+{
+    return conn_->finishWrite(inner_.await_resume());
+}
+
+size_t TcpConnection::finishRead(Channel::Transfer transfer)
+{
+    auto [result, bytes] = transfer;
+    throwIfInterrupted(result);
     if (result == Channel::IoResult::Eof)
     {
         if (state_ == State::LocalShutdown)
             state_ = State::Closed;
         else
             state_ = State::PeerShutdown;
-        co_return 0;
+        return 0;
     }
     if (result != Channel::IoResult::Success)
     {
         state_ = State::Closed;
         throw std::runtime_error("TCP read error");
     }
-    co_return reader.readLen();
+    return bytes;
 }
 
-Task<size_t> TcpConnection::write(const void * buf, size_t len)
+size_t TcpConnection::finishWrite(Channel::Transfer transfer)
 {
-    BufferWriter writer(buf, len);
-    auto result = co_await ioChannelPtr_->performWrite(&writer);
+    auto [result, bytes] = transfer;
+    throwIfInterrupted(result);
     if (result == Channel::IoResult::Eof)
     {
         state_ = State::Closed;
-        co_return 0;
+        return 0;
     }
     if (result != Channel::IoResult::Success)
     {
         state_ = State::Closed;
         throw std::runtime_error("TCP write error");
     }
+    return bytes;
+}
+
+Task<size_t> TcpConnection::sendFile(int fd, off_t offset, size_t len, IoDeadline limit)
+{
+    size_t sent = 0;
+    while (sent < len)
+    {
+        auto transfer = co_await ioChannelPtr_->sendFileSome(fd, offset + static_cast<off_t>(sent), len - sent, limit);
+        if (transfer.result == Channel::IoResult::Unsupported)
+        {
+            size_t n = co_await spliceFile(fd, offset + static_cast<off_t>(sent), len - sent, limit);
+            co_return n == 0 ? 0 : len;
+        }
+        if (transfer.result == Channel::IoResult::Success && transfer.bytes == 0)
+            throw std::runtime_error("sendFile: file ended before the requested length");
+        size_t n = finishWrite(transfer);
+        if (n == 0)
+            co_return 0;
+        sent += n;
+    }
+    co_return len;
+}
+
+// file -> pipe -> socket: the pages are moved by reference, never copied to user space.
+Task<size_t> TcpConnection::spliceFile(int fd, off_t offset, size_t len, IoDeadline limit)
+{
+    int pipeFds[2];
+    if (::pipe2(pipeFds, O_NONBLOCK | O_CLOEXEC) != 0)
+        throw std::runtime_error("sendFile: pipe2 failed");
+    struct PipeCloser
+    {
+        int * fds;
+        ~PipeCloser()
+        {
+            ::close(fds[0]);
+            ::close(fds[1]);
+        }
+    } closer{ pipeFds };
+
+    // Bigger pipe, fewer round trips; the default 64KB still works if refused.
+    constexpr int kPipeSize = 1 << 20;
+    ::fcntl(pipeFds[1], F_SETPIPE_SZ, kPipeSize);
+
+    size_t sent = 0;
+    while (sent < len)
+    {
+        loff_t fileOffset = offset + static_cast<off_t>(sent);
+        ssize_t filled = ::splice(fd, &fileOffset, pipeFds[1], nullptr, std::min<size_t>(len - sent, kPipeSize), SPLICE_F_MOVE);
+        if (filled < 0 && errno == EINTR)
+            continue;
+        if (filled < 0)
+            throw std::runtime_error("sendFile: splice from file failed");
+        if (filled == 0)
+            throw std::runtime_error("sendFile: file ended before the requested length");
+
+        for (size_t inPipe = static_cast<size_t>(filled); inPipe > 0;)
+        {
+            size_t n = finishWrite(co_await ioChannelPtr_->spliceSome(pipeFds[0], inPipe, limit));
+            if (n == 0)
+                co_return 0;
+            inPipe -= n;
+            sent += n;
+        }
+    }
     co_return len;
 }
 
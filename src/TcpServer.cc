@@ -33,21 +33,43 @@ TcpServer::TcpServer(const InetAddress & addr, Scheduler * scheduler)
     , stopPromise_(scheduler)
     , stopFuture_(stopPromise_.get_future().share())
 {
-    setup_socket();
+    listeners_.push_back(Listener{ scheduler_, setup_socket(scheduler_) });
+}
+
+TcpServer::TcpServer(uint16_t port, SchedulerGroup & group, Scheduler * scheduler)
+    : TcpServer(InetAddress(port), group, scheduler)
+{
+}
+
+TcpServer::TcpServer(const InetAddress & addr, SchedulerGroup & group, Scheduler * scheduler)
+    : addr_(addr)
+    , scheduler_(scheduler ? scheduler : group.at(0))
+    , startPromise_(scheduler_)
+    , startFuture_(startPromise_.get_future().share())
+    , stopPromise_(scheduler_)
+    , stopFuture_(stopPromise_.get_future().share())
+{
+    // The first bind resolves port 0; the rest join it through SO_REUSEPORT.
+    listeners_.reserve(group.size());
+    for (auto * loop : group.schedulers())
+        listeners_.push_back(Listener{ loop, setup_socket(loop) });
 }
 
 TcpServer::~TcpServer() = default;
 
-void TcpServer::setup_socket()
+std::shared_ptr<Socket> TcpServer::setup_socket(Scheduler * loop)
 {
     int fd = ::socket(addr_.family(), SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (fd < 0)
         throw std::runtime_error("Failed to create socket");
-    listenSocketPtr_ = std::make_shared<Socket>(fd);
+    auto socket = std::make_shared<Socket>(fd);
 
     int opt = 1;
     ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
     ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+    // Accepted connections inherit it from the listener.
+    if (loop->busyPoll().count() > 0)
+        socket->setBusyPoll(loop->busyPoll());
 
     if (addr_.isIpV6())
     {
@@ -71,6 +93,7 @@ void TcpServer::setup_socket()
                 addr_ = InetAddress(*reinterpret_cast<sockaddr_in *>(&ss));
         }
     }
+    return socket;
 }
 
 struct Acceptor
@@ -119,25 +142,51 @@ Task<> TcpServer::start(ConnectionHandler handler)
         throw std::logic_error("TcpServer already started");
     }
 
-    if (::listen(listenSocketPtr_->fd(), 128) < 0)
+    for (auto & listener : listeners_)
     {
-        stopped_.store(true);
-        stopPromise_.set_value();
-        throw std::runtime_error(std::string("Failed to listen: ") + strerror(errno));
+        if (::listen(listener.socket->fd(), 128) < 0)
+        {
+            stopped_.store(true);
+            stopPromise_.set_value();
+            throw std::runtime_error(std::string("Failed to listen: ") + strerror(errno));
+        }
     }
-    NITRO_DEBUG("TcpServer listening on port %hu", addr_.toPort());
+    NITRO_DEBUG("TcpServer listening on port %hu (%zu loops)", addr_.toPort(), listeners_.size());
 
     auto handlerPtr = std::make_shared<ConnectionHandler>(std::move(handler));
-    std::weak_ptr<ConnectionSet> weakConnSet{ connSetPtr_ };
-    listenChannel_ = std::make_unique<Channel>(listenSocketPtr_->fd(), TriggerMode::LevelTriggered, scheduler_);
-    listenChannel_->setGuard(listenSocketPtr_);
-    listenChannel_->enableReading();
+    std::vector<Future<>> loopsDone;
+    loopsDone.reserve(listeners_.size());
+    for (auto & listener : listeners_)
+    {
+        Promise<> done(scheduler_);
+        loopsDone.push_back(done.get_future());
+        listener.scheduler->spawn([this, &listener, handlerPtr, done = std::move(done)]() mutable -> Task<> {
+            co_await acceptLoop(listener, handlerPtr);
+            done.set_value();
+        });
+    }
 
     startPromise_.set_value();
+    for (auto & loopDone : loopsDone)
+    {
+        co_await loopDone.get();
+    }
+    stopPromise_.set_value();
+    NITRO_DEBUG("TcpServer::start() quit");
+}
+
+Task<> TcpServer::acceptLoop(Listener & listener, std::shared_ptr<ConnectionHandler> handlerPtr)
+{
+    Scheduler * scheduler = listener.scheduler;
+    std::weak_ptr<ConnectionSet> weakConnSet{ listener.connSet };
+    listener.channel = std::make_unique<Channel>(listener.socket->fd(), TriggerMode::LevelTriggered, scheduler);
+    listener.channel->setGuard(listener.socket);
+    listener.channel->enableReading();
+
     while (!stopped_.load())
     {
         Acceptor acceptor;
-        auto result = co_await listenChannel_->performRead(&acceptor);
+        auto result = co_await listener.channel->performRead(&acceptor);
         if (result == Channel::IoResult::Canceled)
         {
             NITRO_DEBUG("TcpServer::close() called, break accepting loop");
@@ -152,11 +201,11 @@ Task<> TcpServer::start(ConnectionHandler handler)
         NITRO_DEBUG("Accepted connection");
         auto socket = acceptor.takeSocket();
         auto peerAddr = acceptor.takeClientAddr();
-        auto ioChannelPtr = std::make_unique<Channel>(socket->fd(), TriggerMode::EdgeTriggered, scheduler_);
+        auto ioChannelPtr = std::make_unique<Channel>(socket->fd(), TriggerMode::EdgeTriggered, scheduler);
         ioChannelPtr->setGuard(socket);
         auto connPtr = std::make_shared<TcpConnection>(std::move(ioChannelPtr), socket, addr_, peerAddr);
-        connSetPtr_->insert(connPtr);
-        scheduler_->spawn([scheduler = scheduler_, handlerPtr, connPtr, weakConnSet]() mutable -> Task<> {
+        listener.connSet->insert(connPtr);
+        scheduler->spawn([scheduler, handlerPtr, connPtr, weakConnSet]() mutable -> Task<> {
             try
             {
                 co_await (*handlerPtr)(connPtr);
@@ -178,9 +227,7 @@ Task<> TcpServer::start(ConnectionHandler handler)
             }
         });
     }
-    listenChannel_->disableAll();
-    stopPromise_.set_value();
-    NITRO_DEBUG("TcpServer::start() quit");
+    listener.channel->disableAll();
 }
 
 Task<> TcpServer::stop()
@@ -190,15 +237,30 @@ Task<> TcpServer::stop()
         co_return;
 
     NITRO_DEBUG("TcpServer::stop() requested");
-    listenChannel_->disableAll(); // stop listening first
-    listenChannel_->cancelAll();
+    for (auto & listener : listeners_)
+    {
+        co_await stopListener(listener);
+    }
+    co_await scheduler_->switch_to();
+    co_await stopFuture_.get();
+}
+
+Task<> TcpServer::stopListener(Listener & listener)
+{
+    co_await listener.scheduler->switch_to();
+    // A null channel means the accept loop has not run yet; it will observe
+    // stopped_ before its first accept.
+    if (listener.channel)
+    {
+        listener.channel->disableAll(); // stop listening first
+        listener.channel->cancelAll();
+    }
 
-    std::vector<TcpConnectionPtr> conns(connSetPtr_->begin(), connSetPtr_->end());
+    std::vector<TcpConnectionPtr> conns(listener.connSet->begin(), listener.connSet->end());
     for (auto & c : conns)
     {
         co_await c->shutdown();
     }
-    co_await stopFuture_.get();
 }
 
 SharedFuture<> TcpServer::started() const
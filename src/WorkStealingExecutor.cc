@@ -0,0 +1,417 @@
+/**
+ * @file WorkStealingExecutor.cc
+ * @brief Chase-Lev deques, injection ring and worker loop of WorkStealingExecutor
+ */
+#include <nitrocoro/core/WorkStealingExecutor.h>
+
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace nitrocoro
+{
+
+using detail::ExecutorJob;
+
+namespace
+{
+
+/**
+ * Chase-Lev work-stealing deque, with the C11 memory orderings from
+ * Lê, Pop, Cohen and Zappa Nardelli (PPoPP 2013). push()/pop() are owner
+ * only; steal() may run on any thread. Grown arrays are retired rather than
+ * freed because a thief may still be reading them.
+ */
+class ChaseLevDeque
+{
+public:
+    ChaseLevDeque()
+    {
+        auto array = std::make_unique<Array>(kInitialCapacity);
+        array_.store(array.get(), std::memory_order_relaxed);
+        arrays_.push_back(std::move(array));
+    }
+
+    void push(ExecutorJob * job)
+    {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        Array * a = array_.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1)
+            a = grow(a, t, b);
+        a->put(b, job);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    ExecutorJob * pop()
+    {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array * a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        if (t > b)
+        {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        ExecutorJob * job = a->get(b);
+        if (t == b)
+        {
+            // Last element: race the thieves for it.
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    ExecutorJob * steal()
+    {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b)
+            return nullptr;
+        Array * a = array_.load(std::memory_order_acquire);
+        ExecutorJob * job = a->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr; // lost to the owner or another thief
+        return job;
+    }
+
+private:
+    static constexpr int64_t kInitialCapacity = 256;
+
+    struct Array
+    {
+        explicit Array(int64_t cap)
+            : capacity(cap), slots(std::make_unique<std::atomic<ExecutorJob *>[]>(static_cast<size_t>(cap)))
+        {
+        }
+
+        ExecutorJob * get(int64_t i) const noexcept { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t i, ExecutorJob * job) noexcept { slots[i & (capacity - 1)].store(job, std::memory_order_relaxed); }
+
+        int64_t capacity;
+        std::unique_ptr<std::atomic<ExecutorJob *>[]> slots;
+    };
+
+    Array * grow(Array * old, int64_t t, int64_t b)
+    {
+        auto array = std::make_unique<Array>(old->capacity * 2);
+        for (int64_t i = t; i < b; ++i)
+            array->put(i, old->get(i));
+        Array * raw = array.get();
+        arrays_.push_back(std::move(array));
+        array_.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+    alignas(64) std::atomic<int64_t> top_{ 0 };
+    alignas(64) std::atomic<int64_t> bottom_{ 0 };
+    std::atomic<Array *> array_{ nullptr };
+    std::vector<std::unique_ptr<Array>> arrays_; // owner only
+};
+
+struct FunctionJob : ExecutorJob
+{
+    explicit FunctionJob(std::function<void()> f)
+        : fn(std::move(f))
+    {
+        execute = &FunctionJob::run;
+    }
+
+    static void run(ExecutorJob * job)
+    {
+        std::unique_ptr<FunctionJob> self(static_cast<FunctionJob *>(job));
+        self->fn();
+    }
+
+    std::function<void()> fn;
+};
+
+struct CurrentWorker
+{
+    const WorkStealingExecutor * executor{ nullptr };
+    void * worker{ nullptr };
+};
+
+thread_local CurrentWorker tlsWorker;
+
+// Spin iterations before an idle worker parks.
+constexpr int kIdleSpins = 64;
+
+} // namespace
+
+struct WorkStealingExecutor::Worker
+{
+    ChaseLevDeque deque;
+    std::thread thread;
+    uint64_t rng;
+};
+
+/**
+ * Submissions from threads that are not workers. A bounded MPMC ring
+ * (Vyukov's per-cell sequence scheme) takes the common case without locks;
+ * a mutex-guarded overflow list keeps submit() from ever failing.
+ */
+struct WorkStealingExecutor::Injector
+{
+    static constexpr size_t kCapacity = 4096;
+
+    Injector()
+        : cells(std::make_unique<Cell[]>(kCapacity))
+    {
+        for (size_t i = 0; i < kCapacity; ++i)
+            cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    void push(ExecutorJob * job)
+    {
+        if (tryPush(job))
+            return;
+        std::lock_guard lock(overflowMutex);
+        overflow.push_back(job);
+        overflowSize.fetch_add(1, std::memory_order_release);
+    }
+
+    ExecutorJob * pop()
+    {
+        if (ExecutorJob * job = tryPop())
+            return job;
+        if (overflowSize.load(std::memory_order_acquire) == 0)
+            return nullptr;
+        std::lock_guard lock(overflowMutex);
+        if (overflow.empty())
+            return nullptr;
+        ExecutorJob * job = overflow.front();
+        overflow.pop_front();
+        overflowSize.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    bool tryPush(ExecutorJob * job)
+    {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell & cell = cells[pos & (kCapacity - 1)];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.job = job;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    ExecutorJob * tryPop()
+    {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell & cell = cells[pos & (kCapacity - 1)];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    ExecutorJob * job = cell.job;
+                    cell.seq.store(pos + kCapacity, std::memory_order_release);
+                    return job;
+                }
+            }
+            else if (diff < 0)
+            {
+                return nullptr;
+            }
+            else
+            {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        ExecutorJob * job{ nullptr };
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueuePos{ 0 };
+    alignas(64) std::atomic<size_t> dequeuePos{ 0 };
+
+    alignas(64) std::atomic<size_t> overflowSize{ 0 };
+    std::mutex overflowMutex;
+    std::deque<ExecutorJob *> overflow;
+};
+
+WorkStealingExecutor::WorkStealingExecutor(size_t threadNum)
+    : injector_(std::make_unique<Injector>())
+{
+    if (threadNum == 0)
+        threadNum = std::max(std::thread::hardware_concurrency(), 1u);
+
+    workers_.reserve(threadNum);
+    for (size_t i = 0; i < threadNum; ++i)
+    {
+        workers_.push_back(std::make_unique<Worker>());
+        workers_.back()->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+    }
+    // Start threads only once every deque exists, since workers steal from all of them.
+    for (size_t i = 0; i < threadNum; ++i)
+        workers_[i]->thread = std::thread([this, i] { workerLoop(i); });
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    stop_.store(true, std::memory_order_seq_cst);
+    epoch_.fetch_add(1, std::memory_order_release);
+    epoch_.notify_all();
+
+    for (auto & w : workers_)
+        if (w->thread.joinable())
+            w->thread.join();
+
+    // Free dropped post() jobs; awaiter-owned jobs belong to their frames.
+    auto release = [](ExecutorJob * job) {
+        if (job->execute == &FunctionJob::run)
+            delete static_cast<FunctionJob *>(job);
+    };
+    while (ExecutorJob * job = injector_->pop())
+        release(job);
+    for (auto & w : workers_)
+        while (ExecutorJob * job = w->deque.steal())
+            release(job);
+}
+
+void WorkStealingExecutor::post(std::function<void()> task)
+{
+    submit(new FunctionJob(std::move(task)));
+}
+
+void WorkStealingExecutor::submit(ExecutorJob * job)
+{
+    if (tlsWorker.executor == this)
+        static_cast<Worker *>(tlsWorker.worker)->deque.push(job);
+    else
+        injector_->push(job);
+    wake(1);
+}
+
+void WorkStealingExecutor::submit(std::span<ExecutorJob * const> jobs)
+{
+    if (jobs.empty())
+        return;
+    if (tlsWorker.executor == this)
+    {
+        auto & deque = static_cast<Worker *>(tlsWorker.worker)->deque;
+        for (ExecutorJob * job : jobs)
+            deque.push(job);
+    }
+    else
+    {
+        for (ExecutorJob * job : jobs)
+            injector_->push(job);
+    }
+    wake(jobs.size());
+}
+
+size_t WorkStealingExecutor::chunkCount(size_t n, size_t grain) const noexcept
+{
+    // A few chunks per worker lets stealing even out uneven iterations.
+    size_t maxChunks = workers_.size() * 4;
+    size_t chunks = (n + std::max<size_t>(grain, 1) - 1) / std::max<size_t>(grain, 1);
+    return std::clamp<size_t>(chunks, 1, std::max<size_t>(maxChunks, 1));
+}
+
+void WorkStealingExecutor::wake(size_t jobs)
+{
+    // Pairs with the fence in workerLoop(): either the parking worker sees the
+    // job on its final scan, or we see it counted in sleepers_.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) == 0)
+        return;
+    epoch_.fetch_add(1, std::memory_order_release);
+    if (jobs > 1)
+        epoch_.notify_all();
+    else
+        epoch_.notify_one();
+}
+
+ExecutorJob * WorkStealingExecutor::findJob(Worker & self)
+{
+    if (ExecutorJob * job = self.deque.pop())
+        return job;
+    if (ExecutorJob * job = injector_->pop())
+        return job;
+
+    size_t n = workers_.size();
+    if (n < 2)
+        return nullptr;
+    // xorshift64 picks where the sweep over victims starts.
+    self.rng ^= self.rng << 13;
+    self.rng ^= self.rng >> 7;
+    self.rng ^= self.rng << 17;
+    size_t start = static_cast<size_t>(self.rng % n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        Worker & victim = *workers_[(start + i) % n];
+        if (&victim == &self)
+            continue;
+        if (ExecutorJob * job = victim.deque.steal())
+            return job;
+    }
+    return nullptr;
+}
+
+void WorkStealingExecutor::workerLoop(size_t index)
+{
+    Worker & self = *workers_[index];
+    tlsWorker = CurrentWorker{ this, &self };
+
+    while (!stop_.load(std::memory_order_acquire))
+    {
+        ExecutorJob * job = findJob(self);
+        for (int spin = 0; !job && spin < kIdleSpins; ++spin)
+        {
+            std::this_thread::yield();
+            job = findJob(self);
+        }
+
+        if (!job)
+        {
+            uint32_t epoch = epoch_.load(std::memory_order_acquire);
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            job = findJob(self);
+            if (!job && !stop_.load(std::memory_order_acquire))
+                epoch_.wait(epoch, std::memory_order_acquire);
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            if (!job)
+                continue;
+        }
+
+        job->execute(job);
+    }
+    tlsWorker = CurrentWorker{};
+}
+
+} // namespace nitrocoro
@@ -0,0 +1,80 @@
+/**
+ * @file EpollPoller.cc
+ * @brief epoll(7) based Poller implementation
+ */
+#include "EpollPoller.h"
+
+#include <nitrocoro/utils/Debug.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace nitrocoro
+{
+
+static constexpr int kMaxEpollEvents = 128;
+
+EpollPoller::EpollPoller()
+{
+    epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0)
+    {
+        throw std::runtime_error("Failed to create epoll");
+    }
+}
+
+EpollPoller::~EpollPoller()
+{
+    if (epollFd_ >= 0)
+        ::close(epollFd_);
+}
+
+void EpollPoller::addFd(int fd, uint32_t events, TriggerMode mode)
+{
+    epoll_event ev{};
+    ev.events = events | (mode == TriggerMode::EdgeTriggered ? static_cast<uint32_t>(EPOLLET) : 0u);
+    ev.data.fd = fd;
+    if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+        NITRO_ERROR("epoll_ctl ADD fd %d ev %d error: %s", fd, events, strerror(errno));
+        throw std::runtime_error("Failed to call EPOLL_CTL_ADD on epoll");
+    }
+}
+
+void EpollPoller::modifyFd(int fd, uint32_t events, TriggerMode mode)
+{
+    epoll_event ev{};
+    ev.events = events | (mode == TriggerMode::EdgeTriggered ? static_cast<uint32_t>(EPOLLET) : 0u);
+    ev.data.fd = fd;
+    if (::epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev) < 0)
+    {
+        NITRO_ERROR("epoll_ctl MOD fd %d ev %d error: %s", fd, events, strerror(errno));
+        throw std::runtime_error("Failed to call EPOLL_CTL_MOD on epoll");
+    }
+}
+
+bool EpollPoller::removeFd(int fd)
+{
+    epoll_event ev{};
+    return ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, &ev) == 0;
+}
+
+int EpollPoller::poll(Event * events, int maxEvents, int timeoutMs)
+{
+    epoll_event evs[kMaxEpollEvents];
+    if (maxEvents > kMaxEpollEvents)
+        maxEvents = kMaxEpollEvents;
+
+    int n = ::epoll_wait(epollFd_, evs, maxEvents, timeoutMs);
+    for (int i = 0; i < n; ++i)
+    {
+        events[i].fd = evs[i].data.fd;
+        events[i].events = evs[i].events;
+    }
+    return n < 0 ? 0 : n;
+}
+
+} // namespace nitrocoro
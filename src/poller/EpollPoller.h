@@ -0,0 +1,30 @@
+/**
+ * @file EpollPoller.h
+ * @brief epoll(7) based Poller
+ */
+#pragma once
+
+#include "Poller.h"
+
+namespace nitrocoro
+{
+
+class EpollPoller final : public Poller
+{
+public:
+    EpollPoller();
+    ~EpollPoller() override;
+
+    EpollPoller(const EpollPoller &) = delete;
+    EpollPoller & operator=(const EpollPoller &) = delete;
+
+    void addFd(int fd, uint32_t events, TriggerMode mode) override;
+    void modifyFd(int fd, uint32_t events, TriggerMode mode) override;
+    bool removeFd(int fd) override;
+    int poll(Event * events, int maxEvents, int timeoutMs) override;
+
+private:
+    int epollFd_{ -1 };
+};
+
+} // namespace nitrocoro
@@ -0,0 +1,355 @@
+/**
+ * @file IoUringPoller.cc
+ * @brief io_uring based Poller implementation
+ */
+#include "IoUringPoller.h"
+
+#include <nitrocoro/utils/Debug.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace nitrocoro
+{
+
+// user_data of requests whose completions carry no fd event (poll and operation removals)
+static constexpr uint64_t kInternalUserData = ~uint64_t{ 0 };
+// Set on poll requests; user-space pointers (IoOperation completions) never have it.
+static constexpr uint64_t kPollTag = uint64_t{ 1 } << 63;
+
+static uint64_t encodeUserData(int fd, uint32_t gen)
+{
+    return kPollTag | (static_cast<uint64_t>(gen & 0x7fffffff) << 32) | static_cast<uint32_t>(fd);
+}
+
+static unsigned loadAcquire(unsigned * p)
+{
+    return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire);
+}
+
+static void storeRelease(unsigned * p, unsigned v)
+{
+    std::atomic_ref<unsigned>(*p).store(v, std::memory_order_release);
+}
+
+IoUringPoller::IoUringPoller(unsigned entries)
+{
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CLAMP;
+    ringFd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (ringFd_ < 0)
+    {
+        throw std::runtime_error(std::string("Failed to create io_uring: ") + strerror(errno));
+    }
+    if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_NODROP))
+    {
+        ::close(ringFd_);
+        throw std::runtime_error("io_uring kernel support too old (need EXT_ARG and NODROP)");
+    }
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap)
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+    sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+    if (sqRing_ == MAP_FAILED)
+    {
+        ::close(ringFd_);
+        throw std::runtime_error("Failed to mmap io_uring SQ ring");
+    }
+    if (singleMmap)
+    {
+        cqRing_ = sqRing_;
+    }
+    else
+    {
+        cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED)
+        {
+            ::munmap(sqRing_, sqRingSize_);
+            ::close(ringFd_);
+            throw std::runtime_error("Failed to mmap io_uring CQ ring");
+        }
+    }
+
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    void * sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        if (cqRing_ != sqRing_)
+            ::munmap(cqRing_, cqRingSize_);
+        ::munmap(sqRing_, sqRingSize_);
+        ::close(ringFd_);
+        throw std::runtime_error("Failed to mmap io_uring SQEs");
+    }
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+    auto * sq = static_cast<char *>(sqRing_);
+    sqHead_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqFlags_ = reinterpret_cast<unsigned *>(sq + params.sq_off.flags);
+    sqArray_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sqMask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqEntries_ = params.sq_entries;
+    sqTailLocal_ = *sqTail_;
+
+    auto * cq = static_cast<char *>(cqRing_);
+    cqHead_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqMask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+}
+
+IoUringPoller::~IoUringPoller()
+{
+    ::munmap(sqes_, sqesSize_);
+    if (cqRing_ != sqRing_)
+        ::munmap(cqRing_, cqRingSize_);
+    ::munmap(sqRing_, sqRingSize_);
+    ::close(ringFd_);
+}
+
+IoUringPoller::FdState & IoUringPoller::stateOf(int fd)
+{
+    if (static_cast<size_t>(fd) >= fds_.size())
+        fds_.resize(std::max<size_t>(fd + 1, fds_.size() * 2));
+    return fds_[fd];
+}
+
+int IoUringPoller::enter(unsigned toSubmit, unsigned minComplete, unsigned flags, void * arg, size_t argSize)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ringFd_, toSubmit, minComplete, flags, arg, argSize));
+}
+
+void IoUringPoller::flushSubmissions()
+{
+    storeRelease(sqTail_, sqTailLocal_);
+    unsigned pending = sqTailLocal_ - loadAcquire(sqHead_);
+    if (pending > 0 && enter(pending, 0, 0, nullptr, 0) < 0 && errno != EINTR && errno != EBUSY)
+    {
+        NITRO_ERROR("io_uring_enter submit error: %s", strerror(errno));
+    }
+}
+
+io_uring_sqe * IoUringPoller::tryGetSqe()
+{
+    if (sqTailLocal_ - loadAcquire(sqHead_) >= sqEntries_)
+    {
+        // SQ full: push what we have to the kernel before queueing more
+        flushSubmissions();
+        if (sqTailLocal_ - loadAcquire(sqHead_) >= sqEntries_)
+            return nullptr;
+    }
+    unsigned idx = sqTailLocal_ & sqMask_;
+    io_uring_sqe * sqe = &sqes_[idx];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray_[idx] = idx;
+    ++sqTailLocal_;
+    return sqe;
+}
+
+io_uring_sqe * IoUringPoller::getSqe()
+{
+    io_uring_sqe * sqe = tryGetSqe();
+    if (!sqe)
+        throw std::runtime_error("io_uring submission queue full");
+    return sqe;
+}
+
+void IoUringPoller::armPoll(int fd, FdState & st)
+{
+    io_uring_sqe * sqe = getSqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    sqe->poll32_events = __builtin_bswap32(st.events);
+#else
+    sqe->poll32_events = st.events;
+#endif
+    if (st.mode == TriggerMode::EdgeTriggered)
+        sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = encodeUserData(fd, st.gen);
+    st.armed = true;
+}
+
+void IoUringPoller::cancelPoll(int fd, FdState & st)
+{
+    if (!st.armed)
+        return;
+    io_uring_sqe * sqe = getSqe();
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = encodeUserData(fd, st.gen);
+    sqe->user_data = kInternalUserData;
+    st.armed = false;
+}
+
+void IoUringPoller::addFd(int fd, uint32_t events, TriggerMode mode)
+{
+    auto & st = stateOf(fd);
+    cancelPoll(fd, st);
+    st.events = events;
+    st.mode = mode;
+    st.registered = true;
+    ++st.gen;
+    armPoll(fd, st);
+}
+
+void IoUringPoller::modifyFd(int fd, uint32_t events, TriggerMode mode)
+{
+    auto & st = stateOf(fd);
+    cancelPoll(fd, st);
+    st.events = events;
+    st.mode = mode;
+    st.registered = true;
+    // new generation: completions of the cancelled request are dropped as stale
+    ++st.gen;
+    armPoll(fd, st);
+}
+
+bool IoUringPoller::removeFd(int fd)
+{
+    auto & st = stateOf(fd);
+    cancelPoll(fd, st);
+    st.registered = false;
+    ++st.gen;
+    return true;
+}
+
+bool IoUringPoller::submit(IoOperation * op)
+{
+    io_uring_sqe * sqe = tryGetSqe();
+    if (!sqe)
+        return false;
+    switch (op->kind)
+    {
+        case IoOperation::Kind::Read:
+            sqe->opcode = IORING_OP_READ;
+            break;
+        case IoOperation::Kind::Write:
+            sqe->opcode = IORING_OP_WRITE;
+            break;
+        case IoOperation::Kind::Readv:
+            sqe->opcode = IORING_OP_READV;
+            break;
+        case IoOperation::Kind::Writev:
+            sqe->opcode = IORING_OP_WRITEV;
+            break;
+    }
+    sqe->fd = op->fd;
+    sqe->addr = reinterpret_cast<uint64_t>(op->buf);
+    // A short transfer is fine for every caller, so cap what one SQE can express
+    sqe->len = static_cast<uint32_t>(std::min<size_t>(op->len, 1u << 30));
+    sqe->off = ~uint64_t{ 0 }; // current position; ignored by sockets and pipes
+    sqe->user_data = reinterpret_cast<uint64_t>(op);
+    return true;
+}
+
+void IoUringPoller::cancel(IoOperation * op)
+{
+    io_uring_sqe * sqe = tryGetSqe();
+    if (!sqe)
+    {
+        NITRO_ERROR("io_uring submission queue full, cannot cancel operation on fd %d", op->fd);
+        return;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<uint64_t>(op);
+    sqe->user_data = kInternalUserData;
+}
+
+int IoUringPoller::poll(Event * events, int maxEvents, int timeoutMs)
+{
+    storeRelease(sqTail_, sqTailLocal_);
+    unsigned toSubmit = sqTailLocal_ - loadAcquire(sqHead_);
+    bool ready = loadAcquire(cqTail_) != *cqHead_;
+    bool overflow = std::atomic_ref<unsigned>(*sqFlags_).load(std::memory_order_relaxed) & IORING_SQ_CQ_OVERFLOW;
+
+    if (timeoutMs == 0 || ready)
+    {
+        if ((toSubmit > 0 || overflow) && enter(toSubmit, 0, overflow ? IORING_ENTER_GETEVENTS : 0, nullptr, 0) < 0
+            && errno != EINTR && errno != EBUSY)
+        {
+            NITRO_ERROR("io_uring_enter submit error: %s", strerror(errno));
+        }
+    }
+    else
+    {
+        __kernel_timespec ts{};
+        io_uring_getevents_arg arg{};
+        if (timeoutMs > 0)
+        {
+            ts.tv_sec = timeoutMs / 1000;
+            ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+        }
+        if (enter(toSubmit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg)) < 0
+            && errno != ETIME && errno != EINTR && errno != EBUSY)
+        {
+            NITRO_ERROR("io_uring_enter wait error: %s", strerror(errno));
+        }
+    }
+
+    unsigned head = *cqHead_;
+    unsigned tail = loadAcquire(cqTail_);
+    int n = 0;
+    while (head != tail && n < maxEvents)
+    {
+        const io_uring_cqe & cqe = cqes_[head & cqMask_];
+        ++head;
+        if (cqe.user_data == kInternalUserData)
+            continue;
+        if (!(cqe.user_data & kPollTag))
+        {
+            // Read the CQE out first: the callback may queue new submissions.
+            auto * op = reinterpret_cast<IoOperation *>(cqe.user_data);
+            int result = cqe.res;
+            op->onComplete(op, result);
+            continue;
+        }
+
+        int fd = static_cast<int>(static_cast<uint32_t>(cqe.user_data));
+        auto gen = static_cast<uint32_t>(cqe.user_data >> 32) & 0x7fffffff;
+        if (fd < 0 || static_cast<size_t>(fd) >= fds_.size())
+            continue;
+        auto & st = fds_[fd];
+        if (!st.registered || (st.gen & 0x7fffffff) != gen)
+            continue; // stale completion from a cancelled or replaced request
+
+        if (!(cqe.flags & IORING_CQE_F_MORE))
+        {
+            st.armed = false;
+            rearm_.push_back(fd);
+        }
+        if (cqe.res == -ECANCELED)
+            continue;
+
+        events[n].fd = fd;
+        events[n].events = cqe.res < 0 ? static_cast<uint32_t>(EPOLLERR) : static_cast<uint32_t>(cqe.res);
+        ++n;
+    }
+    storeRelease(cqHead_, head);
+
+    // Re-armed requests are queued and go out with the next poll() call.
+    for (int fd : rearm_)
+    {
+        auto & st = fds_[fd];
+        if (st.registered && !st.armed)
+            armPoll(fd, st);
+    }
+    rearm_.clear();
+    return n;
+}
+
+} // namespace nitrocoro
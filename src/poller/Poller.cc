@@ -0,0 +1,25 @@
+/**
+ * @file Poller.cc
+ * @brief Poller factory
+ */
+#include "Poller.h"
+
+#include "EpollPoller.h"
+#include "IoUringPoller.h"
+
+namespace nitrocoro
+{
+
+std::unique_ptr<Poller> Poller::create(PollerType type)
+{
+    switch (type)
+    {
+        case PollerType::IoUring:
+            return std::make_unique<IoUringPoller>();
+        case PollerType::Epoll:
+        default:
+            return std::make_unique<EpollPoller>();
+    }
+}
+
+} // namespace nitrocoro
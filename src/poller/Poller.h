@@ -0,0 +1,54 @@
+/**
+ * @file Poller.h
+ * @brief I/O backend interface used by Scheduler
+ */
+#pragma once
+
+#include <nitrocoro/core/Types.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace nitrocoro
+{
+
+/**
+ * @brief Readiness notification backend.
+ *
+ * Event masks use the EPOLL* bit values (EPOLLIN, EPOLLOUT, EPOLLERR, EPOLLHUP),
+ * which Channel and CallbackChannel already interpret. All methods are called
+ * from the owning Scheduler's thread only.
+ */
+class Poller
+{
+public:
+    struct Event
+    {
+        int fd;
+        uint32_t events;
+    };
+
+    static std::unique_ptr<Poller> create(PollerType type);
+
+    virtual ~Poller() = default;
+
+    virtual void addFd(int fd, uint32_t events, TriggerMode mode) = 0;
+    virtual void modifyFd(int fd, uint32_t events, TriggerMode mode) = 0;
+    // Returns false on failure with errno set.
+    virtual bool removeFd(int fd) = 0;
+
+    /**
+     * Waits up to timeoutMs (-1 = forever) and fills at most maxEvents entries.
+     * Completions of submitted operations are delivered from here too, through
+     * their onComplete, and do not count towards the result.
+     */
+    virtual int poll(Event * events, int maxEvents, int timeoutMs) = 0;
+
+    // Completion-based operations; see Scheduler::submitIo().
+    virtual bool supportsSubmission() const noexcept { return false; }
+    // Returns false if the operation cannot be queued right now.
+    virtual bool submit(IoOperation *) { return false; }
+    virtual void cancel(IoOperation *) {}
+};
+
+} // namespace nitrocoro
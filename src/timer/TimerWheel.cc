@@ -0,0 +1,236 @@
+/**
+ * @file TimerWheel.cc
+ * @brief Hierarchical timing wheel implementation
+ */
+#include "TimerWheel.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace nitrocoro
+{
+
+TimerWheel::TimerWheel(TimePoint origin)
+    : origin_(origin)
+{
+    heads_.fill(kNil);
+}
+
+uint64_t TimerWheel::tickOf(TimePoint when) const
+{
+    if (when <= origin_)
+        return 0;
+    // Round up so that a timer never fires before its deadline.
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(when - origin_).count();
+    return static_cast<uint64_t>((ns + 999'999) / 1'000'000);
+}
+
+TimerId TimerWheel::add(TimePoint when, Entry entry)
+{
+    uint32_t index;
+    if (freeHead_ != kNil)
+    {
+        index = freeHead_;
+        freeHead_ = nodes_[index].next;
+    }
+    else
+    {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    Node & node = nodes_[index];
+    node.expires = tickOf(when);
+    node.entry = std::move(entry);
+    node.entry.when = when;
+    place(index);
+    ++size_;
+    return (static_cast<uint64_t>(node.gen) << 32) | index;
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    uint32_t index = static_cast<uint32_t>(id & 0xffffffffu);
+    uint32_t gen = static_cast<uint32_t>(id >> 32);
+    if (index >= nodes_.size())
+        return false;
+
+    Node & node = nodes_[index];
+    if (node.gen != gen || node.list == kNil)
+        return false;
+
+    unlink(index);
+    node.entry = {};
+    release(index);
+    return true;
+}
+
+void TimerWheel::place(uint32_t index)
+{
+    Node & node = nodes_[index];
+    uint64_t expires = node.expires;
+    if (expires < nextTick_)
+    {
+        link(index, kDueList);
+        return;
+    }
+
+    uint64_t delta = expires - nextTick_;
+    if (delta > kMaxSpan)
+    {
+        // Park in the farthest top-level slot; re-placed on cascade.
+        expires = nextTick_ + kMaxSpan;
+        delta = kMaxSpan;
+    }
+
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (uint64_t{ 1 } << (kSlotBits * (level + 1))))
+        ++level;
+    uint64_t slot = (expires >> (kSlotBits * level)) & kSlotMask;
+    link(index, static_cast<uint32_t>(level * kSlots + slot));
+}
+
+void TimerWheel::link(uint32_t index, uint32_t list)
+{
+    Node & node = nodes_[index];
+    node.list = list;
+    node.prev = kNil;
+    node.next = heads_[list];
+    if (node.next != kNil)
+        nodes_[node.next].prev = index;
+    heads_[list] = index;
+    if (list != kDueList)
+        occupied_[list / kSlots] |= uint64_t{ 1 } << (list % kSlots);
+}
+
+void TimerWheel::unlink(uint32_t index)
+{
+    Node & node = nodes_[index];
+    if (node.prev != kNil)
+        nodes_[node.prev].next = node.next;
+    else
+        heads_[node.list] = node.next;
+    if (node.next != kNil)
+        nodes_[node.next].prev = node.prev;
+
+    if (heads_[node.list] == kNil && node.list != kDueList)
+        occupied_[node.list / kSlots] &= ~(uint64_t{ 1 } << (node.list % kSlots));
+}
+
+void TimerWheel::release(uint32_t index)
+{
+    Node & node = nodes_[index];
+    node.list = kNil;
+    node.prev = kNil;
+    if (++node.gen == 0)
+        node.gen = 1; // keep TimerIds non-zero
+    node.next = freeHead_;
+    freeHead_ = index;
+    --size_;
+}
+
+void TimerWheel::takeList(uint32_t list)
+{
+    uint32_t index = heads_[list];
+    if (index == kNil)
+        return;
+
+    heads_[list] = kNil;
+    if (list != kDueList)
+        occupied_[list / kSlots] &= ~(uint64_t{ 1 } << (list % kSlots));
+
+    while (index != kNil)
+    {
+        uint32_t next = nodes_[index].next;
+        fired_.push_back(std::move(nodes_[index].entry));
+        nodes_[index].entry = {};
+        release(index);
+        index = next;
+    }
+}
+
+void TimerWheel::cascade(int level, uint64_t slot)
+{
+    uint32_t list = static_cast<uint32_t>(level * kSlots + slot);
+    uint32_t index = heads_[list];
+    heads_[list] = kNil;
+    occupied_[level] &= ~(uint64_t{ 1 } << slot);
+
+    while (index != kNil)
+    {
+        uint32_t next = nodes_[index].next;
+        place(index);
+        index = next;
+    }
+}
+
+uint64_t TimerWheel::nextEventTick() const
+{
+    uint64_t best = UINT64_MAX;
+    if (occupied_[0])
+    {
+        auto rotated = std::rotr(occupied_[0], static_cast<int>(nextTick_ & kSlotMask));
+        best = nextTick_ + std::countr_zero(rotated);
+    }
+    // A level-k slot is cascaded at the first tick whose low 6k bits are zero
+    // and whose next 6 bits equal the slot index.
+    for (int level = 1; level < kLevels; ++level)
+    {
+        if (!occupied_[level])
+            continue;
+        int shift = kSlotBits * level;
+        uint64_t unit = uint64_t{ 1 } << shift;
+        uint64_t boundary = (nextTick_ + unit - 1) & ~(unit - 1);
+        auto rotated = std::rotr(occupied_[level], static_cast<int>((boundary >> shift) & kSlotMask));
+        best = std::min(best, boundary + std::countr_zero(rotated) * unit);
+    }
+    return best;
+}
+
+int64_t TimerWheel::nextTimeoutMs(TimePoint now) const
+{
+    if (size_ == 0)
+        return -1;
+    if (heads_[kDueList] != kNil)
+        return 0;
+
+    auto deadline = origin_ + std::chrono::milliseconds(nextEventTick());
+    if (deadline <= now)
+        return 0;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+    return (ns + 999'999) / 1'000'000;
+}
+
+void TimerWheel::collectExpired(TimePoint now)
+{
+    takeList(kDueList);
+    if (now < origin_)
+        return;
+
+    auto nowTick = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - origin_).count());
+    while (size_ > 0)
+    {
+        // Jump straight to the next tick that fires or cascades anything.
+        uint64_t tick = nextEventTick();
+        if (tick > nowTick)
+            break;
+
+        nextTick_ = tick;
+        if ((tick & kSlotMask) == 0)
+        {
+            for (int level = 1; level < kLevels; ++level)
+            {
+                uint64_t slot = (tick >> (kSlotBits * level)) & kSlotMask;
+                cascade(level, slot);
+                if (slot != 0)
+                    break;
+            }
+        }
+        takeList(static_cast<uint32_t>(tick & kSlotMask));
+        nextTick_ = tick + 1;
+    }
+    if (nextTick_ <= nowTick)
+        nextTick_ = nowTick + 1;
+}
+
+} // namespace nitrocoro
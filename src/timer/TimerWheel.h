@@ -0,0 +1,108 @@
+/**
+ * @file TimerWheel.h
+ * @brief Hierarchical timing wheel with O(1) insert and cancel, used by Scheduler
+ */
+#pragma once
+
+#include <nitrocoro/core/Scheduler.h>
+
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace nitrocoro
+{
+
+/**
+ * @brief Four-level hashed timing wheel with 1ms ticks.
+ *
+ * Level 0 covers the next 64ms one slot per tick; each further level covers
+ * 64x the span of the one below (4s, 4.4min, 4.6h). Timers in higher levels
+ * are cascaded down when the level below wraps; timers beyond the top level
+ * are parked in its farthest slot and re-placed on cascade. Timers never
+ * fire before their deadline.
+ *
+ * Nodes live in a slab indexed by TimerId, so insert/cancel do not allocate
+ * once the slab has grown, and a stale TimerId is rejected by its generation.
+ * All methods are called from the owning Scheduler's thread only.
+ */
+class TimerWheel
+{
+public:
+    struct Entry
+    {
+        std::coroutine_handle<> handle;
+        std::function<void()> func;
+        TimePoint when{}; // deadline, filled in by add()
+    };
+
+    explicit TimerWheel(TimePoint origin);
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel & operator=(const TimerWheel &) = delete;
+
+    TimerId add(TimePoint when, Entry entry);
+    // Returns false if the timer already fired or was cancelled.
+    bool cancel(TimerId id);
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    // Milliseconds until the next timer is due (or the next cascade), -1 if empty.
+    int64_t nextTimeoutMs(TimePoint now) const;
+
+    // Removes every timer due at @p now and invokes fn(Entry &) for each one.
+    template <typename Fn>
+    void expire(TimePoint now, Fn && fn)
+    {
+        collectExpired(now);
+        for (auto & entry : fired_)
+            fn(entry);
+        fired_.clear();
+    }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr uint64_t kSlots = uint64_t{ 1 } << kSlotBits;
+    static constexpr uint64_t kSlotMask = kSlots - 1;
+    static constexpr uint64_t kMaxSpan = (uint64_t{ 1 } << (kLevels * kSlotBits)) - 1;
+    static constexpr uint32_t kNil = UINT32_MAX;
+    // List index of timers that were already due when added
+    static constexpr uint32_t kDueList = kLevels * kSlots;
+
+    struct Node
+    {
+        uint64_t expires{ 0 };
+        uint32_t gen{ 1 };
+        uint32_t list{ kNil }; // kNil when free
+        uint32_t prev{ kNil };
+        uint32_t next{ kNil };
+        Entry entry;
+    };
+
+    uint64_t tickOf(TimePoint when) const;
+    void place(uint32_t index);
+    void link(uint32_t index, uint32_t list);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(int level, uint64_t slot);
+    uint64_t nextEventTick() const;
+    void collectExpired(TimePoint now);
+    void takeList(uint32_t list);
+
+    TimePoint origin_;
+    uint64_t nextTick_{ 0 }; // first tick not processed yet
+    size_t size_{ 0 };
+
+    std::vector<Node> nodes_;
+    uint32_t freeHead_{ kNil };
+    std::array<uint32_t, kLevels * kSlots + 1> heads_;
+    std::array<uint64_t, kLevels> occupied_{}; // non-empty slot bitmap per level
+    std::vector<Entry> fired_;
+};
+
+} // namespace nitrocoro
@@ -0,0 +1,96 @@
+/**
+ * @file BufferPool.cc
+ * @brief I/O block pool implementation
+ */
+#include <nitrocoro/utils/BufferPool.h>
+
+#include <new>
+
+namespace nitrocoro::utils
+{
+
+namespace
+{
+
+struct FreeBlock
+{
+    FreeBlock * next;
+};
+
+// Trivially destructible so it stays usable while other thread_local or
+// static destructors free buffers late in thread/process teardown.
+struct ThreadCache
+{
+    FreeBlock * head;
+    BufferPoolStats stats;
+    bool armed;     // Reclaimer registered for this thread
+    bool reclaimed; // thread is exiting, bypass the cache
+};
+
+thread_local ThreadCache tlsCache{};
+
+void freeBlock(void * block) noexcept
+{
+    ::operator delete(block, std::align_val_t(BufferPool::kAlignment));
+}
+
+// Returns cached blocks to the heap when the thread exits.
+struct Reclaimer
+{
+    ~Reclaimer()
+    {
+        while (FreeBlock * block = tlsCache.head)
+        {
+            tlsCache.head = block->next;
+            freeBlock(block);
+        }
+        tlsCache.stats.cached = 0;
+        tlsCache.reclaimed = true;
+    }
+};
+
+thread_local Reclaimer tlsReclaimer;
+
+} // namespace
+
+char * BufferPool::allocate()
+{
+    auto & cache = tlsCache;
+    ++cache.stats.inUse;
+    if (FreeBlock * block = cache.head)
+    {
+        cache.head = block->next;
+        --cache.stats.cached;
+        ++cache.stats.hits;
+        return reinterpret_cast<char *>(block);
+    }
+    ++cache.stats.misses;
+    return static_cast<char *>(::operator new(kBlockSize, std::align_val_t(kAlignment)));
+}
+
+void BufferPool::deallocate(char * block) noexcept
+{
+    auto & cache = tlsCache;
+    --cache.stats.inUse;
+    if (cache.reclaimed || cache.stats.cached >= kMaxCached)
+    {
+        freeBlock(block);
+        return;
+    }
+    if (!cache.armed)
+    {
+        cache.armed = true;
+        [[maybe_unused]] auto * reclaimer = &tlsReclaimer; // odr-use constructs it
+    }
+    auto * node = reinterpret_cast<FreeBlock *>(block);
+    node->next = cache.head;
+    cache.head = node;
+    ++cache.stats.cached;
+}
+
+BufferPoolStats BufferPool::stats() noexcept
+{
+    return tlsCache.stats;
+}
+
+} // namespace nitrocoro::utils
@@ -0,0 +1,289 @@
+/**
+ * @file IoBuffer.cc
+ * @brief Implementation of IoBuffer
+ */
+#include <nitrocoro/utils/IoBuffer.h>
+
+#include <nitrocoro/utils/BufferPool.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace nitrocoro::utils
+{
+
+IoBuffer::IoBuffer(IoBuffer && other) noexcept
+    : blocks_(std::move(other.blocks_))
+    , writeIndex_(std::exchange(other.writeIndex_, 0))
+    , size_(std::exchange(other.size_, 0))
+{
+    other.blocks_.clear();
+}
+
+IoBuffer & IoBuffer::operator=(IoBuffer && other) noexcept
+{
+    if (this != &other)
+    {
+        clear();
+        blocks_ = std::move(other.blocks_);
+        other.blocks_.clear();
+        writeIndex_ = std::exchange(other.writeIndex_, 0);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+IoBuffer::Block IoBuffer::makeBlock(size_t minCapacity)
+{
+    if (minCapacity <= BufferPool::kBlockSize)
+        return { BufferPool::allocate(), BufferPool::kBlockSize, 0, 0 };
+    // Oversized request: a one-off block, still page-aligned
+    size_t capacity = (minCapacity + BufferPool::kAlignment - 1) & ~(BufferPool::kAlignment - 1);
+    auto * data = static_cast<char *>(::operator new(capacity, std::align_val_t(BufferPool::kAlignment)));
+    return { data, capacity, 0, 0 };
+}
+
+void IoBuffer::freeBlock(const Block & block) noexcept
+{
+    if (block.capacity == BufferPool::kBlockSize)
+        BufferPool::deallocate(block.data);
+    else
+        ::operator delete(block.data, std::align_val_t(BufferPool::kAlignment));
+}
+
+std::string_view IoBuffer::view() const
+{
+    if (blocks_.empty())
+        return {};
+    const Block & head = blocks_.front();
+    return { head.data + head.begin, head.end - head.begin };
+}
+
+bool IoBuffer::matchesAt(size_t index, size_t offset, std::string_view pattern) const
+{
+    for (char c : pattern)
+    {
+        while (index < blocks_.size() && blocks_[index].begin + offset >= blocks_[index].end)
+        {
+            offset = 0;
+            ++index;
+        }
+        if (index == blocks_.size())
+            return false;
+        const Block & block = blocks_[index];
+        if (block.data[block.begin + offset] != c)
+            return false;
+        ++offset;
+    }
+    return true;
+}
+
+size_t IoBuffer::find(std::string_view pattern, size_t pos) const
+{
+    if (pattern.empty())
+        return pos <= size_ ? pos : npos;
+
+    size_t base = 0; // offset of the current block's first unconsumed byte
+    for (size_t i = 0; i < blocks_.size() && base < size_; ++i)
+    {
+        const Block & block = blocks_[i];
+        std::string_view segment(block.data + block.begin, block.end - block.begin);
+        if (pos < base + segment.size())
+        {
+            size_t from = pos > base ? pos - base : 0;
+            size_t hit = segment.find(pattern, from);
+            if (hit != npos)
+                return base + hit;
+            // Matches that start near the end of this block and run into the next
+            size_t tail = segment.size() >= pattern.size() ? segment.size() - pattern.size() + 1 : 0;
+            for (size_t s = std::max(tail, from); s < segment.size(); ++s)
+            {
+                if (matchesAt(i, s, pattern))
+                    return base + s;
+            }
+        }
+        base += segment.size();
+    }
+    return npos;
+}
+
+std::string_view IoBuffer::pullup(size_t len)
+{
+    assert(len <= size_);
+    if (len == 0)
+        return {};
+    Block & head = blocks_.front();
+    if (head.end - head.begin >= len)
+        return { head.data + head.begin, len };
+
+    Block merged = makeBlock(len);
+    merged.end = read(merged.data, len);
+    blocks_.insert(blocks_.begin(), merged);
+    ++writeIndex_;
+    size_ += merged.end;
+    return { merged.data, merged.end };
+}
+
+void IoBuffer::consume(size_t n)
+{
+    assert(n <= size_);
+    size_ -= n;
+    while (n > 0)
+    {
+        Block & head = blocks_.front();
+        size_t available = head.end - head.begin;
+        if (n < available)
+        {
+            head.begin += n;
+            break;
+        }
+        n -= available;
+        head.begin = head.end;
+        if (writeIndex_ == 0)
+            break;
+        // Drained and no longer written to: back to the pool at once
+        freeBlock(head);
+        blocks_.erase(blocks_.begin());
+        --writeIndex_;
+    }
+    if (size_ == 0 && !blocks_.empty())
+    {
+        Block & block = blocks_[writeIndex_];
+        block.begin = block.end = 0;
+    }
+}
+
+size_t IoBuffer::read(char * dst, size_t len)
+{
+    len = std::min(len, size_);
+    size_t copied = 0;
+    for (size_t i = 0; copied < len; ++i)
+    {
+        const Block & block = blocks_[i];
+        size_t n = std::min(len - copied, block.end - block.begin);
+        std::memcpy(dst + copied, block.data + block.begin, n);
+        copied += n;
+    }
+    consume(len);
+    return len;
+}
+
+char * IoBuffer::prepareWrite(size_t len)
+{
+    if (!blocks_.empty())
+    {
+        Block & current = blocks_[writeIndex_];
+        if (current.capacity - current.end >= len)
+            return current.data + current.end;
+        if (writeIndex_ + 1 < blocks_.size() && blocks_[writeIndex_ + 1].capacity >= len)
+        {
+            // Leaves an empty block only when current holds nothing either
+            if (current.begin == current.end)
+            {
+                freeBlock(current);
+                blocks_.erase(blocks_.begin() + static_cast<std::ptrdiff_t>(writeIndex_));
+                return blocks_[writeIndex_].data;
+            }
+            return blocks_[++writeIndex_].data;
+        }
+        dropSpares();
+        if (current.begin == current.end)
+        {
+            freeBlock(current);
+            blocks_.pop_back();
+        }
+    }
+    blocks_.push_back(makeBlock(len));
+    writeIndex_ = blocks_.size() - 1;
+    return blocks_.back().data;
+}
+
+char * IoBuffer::beginWrite()
+{
+    if (blocks_.empty())
+        return nullptr;
+    Block & current = blocks_[writeIndex_];
+    return current.data + current.end;
+}
+
+size_t IoBuffer::writableSize() const
+{
+    if (blocks_.empty())
+        return 0;
+    const Block & current = blocks_[writeIndex_];
+    return current.capacity - current.end;
+}
+
+size_t IoBuffer::prepareWritev(iovec * iov, size_t maxIov, size_t len)
+{
+    if (blocks_.empty())
+    {
+        blocks_.push_back(makeBlock(BufferPool::kBlockSize));
+        writeIndex_ = 0;
+    }
+
+    size_t count = 0;
+    size_t total = 0;
+    for (size_t i = writeIndex_; count < maxIov && total < len; ++i)
+    {
+        if (i == blocks_.size())
+            blocks_.push_back(makeBlock(BufferPool::kBlockSize));
+        Block & block = blocks_[i];
+        size_t room = block.capacity - block.end;
+        if (room == 0)
+            continue;
+        iov[count++] = { block.data + block.end, room };
+        total += room;
+    }
+    return count;
+}
+
+void IoBuffer::commitWrite(size_t len)
+{
+    size_ += len;
+    while (true)
+    {
+        Block & current = blocks_[writeIndex_];
+        size_t n = std::min(len, current.capacity - current.end);
+        current.end += n;
+        len -= n;
+        if (len == 0)
+            break;
+        ++writeIndex_;
+        assert(writeIndex_ < blocks_.size());
+    }
+}
+
+void IoBuffer::dropSpares() noexcept
+{
+    while (blocks_.size() > writeIndex_ + 1)
+    {
+        freeBlock(blocks_.back());
+        blocks_.pop_back();
+    }
+}
+
+void IoBuffer::shrink()
+{
+    if (size_ == 0)
+    {
+        clear();
+        return;
+    }
+    dropSpares();
+}
+
+void IoBuffer::clear()
+{
+    for (const Block & block : blocks_)
+        freeBlock(block);
+    // Swap with an empty vector so the chain's own storage goes too
+    std::vector<Block>().swap(blocks_);
+    writeIndex_ = 0;
+    size_ = 0;
+}
+
+} // namespace nitrocoro::utils
@@ -0,0 +1,173 @@
+/**
+ * @file buffered_stream_test.cc
+ * @brief Tests for BufferedStream read-ahead, peek/consume and write coalescing.
+ */
+#include <nitrocoro/core/Future.h>
+#include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/io/BufferedStream.h>
+#include <nitrocoro/net/TcpConnection.h>
+#include <nitrocoro/net/TcpServer.h>
+#include <nitrocoro/testing/Test.h>
+
+#include <memory>
+#include <string>
+
+using namespace nitrocoro;
+using namespace nitrocoro::net;
+
+namespace
+{
+
+// Counts the calls reaching the wrapped stream.
+struct CountingStream
+{
+    TcpConnectionPtr conn;
+    int reads{ 0 };
+    int writes{ 0 };
+
+    Task<size_t> read(void * buf, size_t len)
+    {
+        ++reads;
+        return conn->read(buf, len);
+    }
+    Task<size_t> readv(std::span<const iovec> iov)
+    {
+        ++reads;
+        return conn->readv(iov);
+    }
+    Task<> waitReadable() { return conn->waitReadable(); }
+    Task<size_t> write(const void * buf, size_t len)
+    {
+        ++writes;
+        return conn->write(buf, len);
+    }
+    Task<size_t> writev(std::span<const iovec> iov)
+    {
+        ++writes;
+        return conn->writev(iov);
+    }
+    Task<> shutdown() { return conn->shutdown(); }
+};
+
+// Connects to a server that echoes everything back until EOF.
+Task<TcpConnectionPtr> connectEcho(TcpServer & server)
+{
+    Scheduler::current()->spawn([&server]() -> Task<> {
+        co_await server.start([](TcpConnectionPtr conn) -> Task<> {
+            char buf[4096];
+            while (size_t n = co_await conn->read(buf, sizeof(buf)))
+                co_await conn->write(buf, n);
+            co_await conn->shutdown();
+        });
+    });
+    co_await server.started();
+    co_return co_await TcpConnection::connect({ "127.0.0.1", server.port() });
+}
+
+Task<std::string> readExact(io::BufferedStream & stream, size_t len)
+{
+    std::string out(len, '\0');
+    for (size_t got = 0; got < len;)
+    {
+        size_t n = co_await stream.read(out.data() + got, len - got);
+        if (n == 0)
+            break;
+        got += n;
+    }
+    co_return out;
+}
+
+} // namespace
+
+/** Small writes in one loop iteration leave in one syscall; small reads are served from read-ahead. */
+NITRO_TEST(buffered_stream_coalescing)
+{
+    TcpServer server(0);
+    auto conn = co_await connectEcho(server);
+    auto counting = std::make_shared<CountingStream>(CountingStream{ conn });
+    auto stream = std::make_shared<io::BufferedStream>(std::make_shared<io::Stream>(counting));
+
+    for (int i = 0; i < 10; ++i)
+    {
+        size_t n = co_await stream->write("0123456789", 10);
+        NITRO_CHECK_EQ(n, 10u);
+    }
+    NITRO_CHECK_EQ(counting->writes, 0);
+
+    // The auto-cork flush runs once this coroutine suspends
+    std::string head = co_await readExact(*stream, 2);
+    NITRO_CHECK_EQ(counting->writes, 1);
+    NITRO_CHECK_EQ(head, "01");
+
+    // Wait until the whole echo is buffered, then take it in small pieces
+    auto all = co_await stream->peek(98);
+    NITRO_CHECK_EQ(all.size(), 98u);
+    int readsBefore = counting->reads;
+    std::string first = co_await readExact(*stream, 4);
+    std::string second = co_await readExact(*stream, 4);
+    NITRO_CHECK_EQ(first, "2345");
+    NITRO_CHECK_EQ(second, "6789");
+    NITRO_CHECK_EQ(counting->reads, readsBefore);
+    NITRO_CHECK_EQ(stream->buffered(), 90u);
+
+    co_await stream->shutdown();
+    co_await server.stop();
+}
+
+/** peek() waits for enough bytes and leaves them in place until consume(). */
+NITRO_TEST(buffered_stream_peek_consume)
+{
+    TcpServer server(0);
+    auto conn = co_await connectEcho(server);
+    auto stream = std::make_shared<io::BufferedStream>(std::make_shared<io::Stream>(conn));
+    stream->setAutoCork(false);
+
+    co_await stream->write("GET / HTTP/1.1\r\n", 16);
+    bool flushed = co_await stream->flush();
+    NITRO_CHECK(flushed);
+
+    auto line = co_await stream->peek(16);
+    NITRO_CHECK_EQ(line, "GET / HTTP/1.1\r\n");
+    auto method = co_await stream->peek(3);
+    NITRO_CHECK_EQ(method, "GET");
+    stream->consume(4);
+    std::string rest = co_await readExact(*stream, 12);
+    NITRO_CHECK_EQ(rest, "/ HTTP/1.1\r\n");
+
+    // At end of stream peek() returns what is left
+    co_await stream->write("tail", 4);
+    co_await stream->shutdown();
+    auto tail = co_await stream->peek(100);
+    NITRO_CHECK_EQ(tail, "tail");
+    stream->consume(tail.size());
+    char c;
+    size_t eof = co_await stream->read(&c, 1);
+    NITRO_CHECK_EQ(eof, 0u);
+
+    co_await server.stop();
+}
+
+/** A large write goes out directly, after what was buffered before it. */
+NITRO_TEST(buffered_stream_large_write_order)
+{
+    TcpServer server(0);
+    auto conn = co_await connectEcho(server);
+    auto stream = std::make_shared<io::BufferedStream>(std::make_shared<io::Stream>(conn));
+
+    std::string big(io::BufferedStream::kWriteBufferSize * 4, 'b');
+    co_await stream->write("head", 4);
+    size_t written = co_await stream->write(big.data(), big.size());
+    NITRO_CHECK_EQ(written, big.size());
+    co_await stream->write("tail", 4);
+
+    std::string echoed = co_await readExact(*stream, big.size() + 8);
+    NITRO_CHECK(echoed == "head" + big + "tail");
+
+    co_await stream->shutdown();
+    co_await server.stop();
+}
+
+int main(int argc, char ** argv)
+{
+    return nitrocoro::test::run_all(argc, argv);
+}
@@ -7,6 +7,9 @@
 #include <nitrocoro/core/Task.h>
 #include <nitrocoro/testing/Test.h>
 
+#include <memory>
+#include <thread>
+
 using namespace nitrocoro;
 
 /** Default-constructed token is never cancelled. */
@@ -182,6 +185,32 @@ NITRO_TEST(cancel_token_from_duration)
     NITRO_CHECK(token.isCancelled());
 }
 
+/** cancelAfter() again replaces the earlier deadline instead of adding a second one. */
+NITRO_TEST(cancel_after_rearm_replaces_deadline)
+{
+    using namespace std::chrono_literals;
+    CancelSource src;
+    src.cancelAfter(20ms);
+    src.cancelAfter(150ms);
+    auto token = src.token();
+    co_await Scheduler::current()->sleep_for(60ms);
+    NITRO_CHECK(!token.isCancelled());
+    co_await Scheduler::current()->sleep_for(150ms);
+    NITRO_CHECK(token.isCancelled());
+}
+
+/** The last owner dropping the state off the timer's thread leaves the timer alone. */
+NITRO_TEST(cancel_state_released_on_other_thread)
+{
+    using namespace std::chrono_literals;
+    auto src = std::make_unique<CancelSource>(10s);
+    auto token = src->token();
+    src.reset();
+    NITRO_CHECK(!token.isCancelled());
+    std::thread([t = std::move(token)]() mutable { t = CancelToken(); }).join();
+    co_await Scheduler::current()->sleep_for(5ms);
+}
+
 int main(int argc, char ** argv)
 {
     return nitrocoro::test::run_all(argc, argv);
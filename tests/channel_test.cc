@@ -0,0 +1,238 @@
+/**
+ * @file channel_test.cc
+ * @brief Tests for AsyncChannel: ordering, backpressure, close and cross-Scheduler use.
+ */
+#include <nitrocoro/core/AsyncChannel.h>
+#include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/SchedulerGroup.h>
+#include <nitrocoro/core/Task.h>
+#include <nitrocoro/core/TaskGroup.h>
+#include <nitrocoro/testing/Test.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using namespace nitrocoro;
+
+/** Items come out in FIFO order; try operations never suspend. */
+NITRO_TEST(channel_fifo_and_try)
+{
+    AsyncChannel<int> channel(4);
+    NITRO_CHECK_EQ(channel.capacity(), 4u);
+    NITRO_CHECK(!channel.tryReceive().has_value());
+
+    for (int i = 0; i < 4; ++i)
+        NITRO_CHECK(channel.trySend(i));
+    NITRO_CHECK(!channel.trySend(99));
+    NITRO_CHECK_EQ(channel.size(), 4u);
+
+    for (int i = 0; i < 4; ++i)
+        NITRO_CHECK_EQ(*co_await channel.receive(), i);
+    NITRO_CHECK_EQ(channel.size(), 0u);
+}
+
+/** A full channel suspends the sender until a receiver makes room. */
+NITRO_TEST(channel_backpressure)
+{
+    AsyncChannel<int> channel(2);
+    std::atomic<int> sent{ 0 };
+    size_t maxBuffered = 0;
+
+    Scheduler::current()->spawn([&]() -> Task<> {
+        for (int i = 0; i < 50; ++i)
+        {
+            bool ok = co_await channel.send(i);
+            if (ok)
+                sent.fetch_add(1);
+        }
+        channel.close();
+    });
+
+    co_await Scheduler::current()->sleep_for(0.01);
+    NITRO_CHECK_EQ(sent.load(), 2);
+
+    int expected = 0;
+    while (auto v = co_await channel.receive())
+    {
+        maxBuffered = std::max(maxBuffered, channel.size() + 1);
+        NITRO_CHECK_EQ(*v, expected++);
+    }
+    NITRO_CHECK_EQ(expected, 50);
+    NITRO_CHECK(maxBuffered <= channel.capacity());
+}
+
+/** close() wakes waiting receivers; buffered items are drained first; later sends fail. */
+NITRO_TEST(channel_close_semantics)
+{
+    AsyncChannel<std::unique_ptr<int>> channel(8);
+    bool waiterWoke = false;
+
+    AsyncChannel<int> empty(1);
+    Scheduler::current()->spawn([&]() -> Task<> {
+        auto v = co_await empty.receive();
+        waiterWoke = !v.has_value();
+    });
+    co_await Scheduler::current()->sleep_for(0.005);
+    empty.close();
+    co_await Scheduler::current()->sleep_for(0.005);
+    NITRO_CHECK(waiterWoke);
+
+    NITRO_CHECK(co_await channel.send(std::make_unique<int>(1)));
+    NITRO_CHECK(co_await channel.send(std::make_unique<int>(2)));
+    channel.close();
+    channel.close();
+    NITRO_CHECK(channel.isClosed());
+    NITRO_CHECK(!co_await channel.send(std::make_unique<int>(3)));
+
+    auto value = std::make_unique<int>(4);
+    NITRO_CHECK(!channel.trySend(std::move(value)));
+    NITRO_CHECK(value != nullptr);
+
+    NITRO_CHECK_EQ(**co_await channel.receive(), 1);
+    NITRO_CHECK_EQ(**co_await channel.receive(), 2);
+    NITRO_CHECK(!(co_await channel.receive()).has_value());
+}
+
+/** A sender blocked on a full channel resumes with false when it is closed. */
+NITRO_TEST(channel_close_wakes_sender)
+{
+    AsyncChannel<int> channel(2);
+    NITRO_CHECK(channel.trySend(1));
+    NITRO_CHECK(channel.trySend(1));
+    int result = -1;
+    Scheduler::current()->spawn([&]() -> Task<> { result = co_await channel.send(2) ? 1 : 0; });
+    co_await Scheduler::current()->sleep_for(0.005);
+    NITRO_CHECK_EQ(result, -1);
+    channel.close();
+    co_await Scheduler::current()->sleep_for(0.005);
+    NITRO_CHECK_EQ(result, 0);
+    NITRO_CHECK_EQ(*co_await channel.receive(), 1);
+    NITRO_CHECK_EQ(*co_await channel.receive(), 1);
+}
+
+/** One item wakes one of many parked receivers rather than all of them. */
+NITRO_TEST(channel_wakes_one_receiver_per_item)
+{
+    constexpr int kReceivers = 16;
+    AsyncChannel<int> channel(2);
+    std::atomic<int> received{ 0 };
+    std::atomic<int> finished{ 0 };
+    for (int i = 0; i < kReceivers; ++i)
+    {
+        Scheduler::current()->spawn([&]() -> Task<> {
+            while (co_await channel.receive())
+                received.fetch_add(1);
+            finished.fetch_add(1);
+        });
+    }
+    co_await Scheduler::current()->sleep_for(0.005);
+
+    [[maybe_unused]] auto before = Scheduler::current()->statsSnapshot();
+    NITRO_CHECK(channel.trySend(1));
+    co_await Scheduler::current()->sleep_for(0.005);
+    NITRO_CHECK_EQ(received.load(), 1);
+#ifndef NITROCORO_DISABLE_SCHEDULER_STATS
+    // The woken receiver's retry and the sleep above; a wake-all would run one retry per receiver.
+    auto after = Scheduler::current()->statsSnapshot();
+    NITRO_CHECK(after.tasksRun - before.tasksRun < kReceivers / 2);
+#endif
+
+    channel.close();
+    co_await Scheduler::current()->sleep_for(0.005);
+    NITRO_CHECK_EQ(finished.load(), kReceivers);
+}
+
+/** Producers and consumers on different Schedulers exchange every item exactly once. */
+NITRO_TEST(channel_cross_scheduler_mpmc)
+{
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 3;
+    constexpr long long kPerProducer = 20000;
+
+    SchedulerGroup loops(4);
+    loops.start();
+
+    AsyncChannel<long long> channel(16);
+    std::atomic<int> producersLeft{ kProducers };
+    std::atomic<long long> sum{ 0 };
+    std::atomic<long long> count{ 0 };
+    {
+        TaskGroup group;
+        for (int p = 0; p < kProducers; ++p)
+        {
+            group.spawn([&, p]() -> Task<> {
+                for (long long i = 0; i < kPerProducer; ++i)
+                    co_await channel.send(p * kPerProducer + i);
+                if (producersLeft.fetch_sub(1) == 1)
+                    channel.close();
+            }, loops.next());
+        }
+        for (int c = 0; c < kConsumers; ++c)
+        {
+            group.spawn([&]() -> Task<> {
+                while (auto v = co_await channel.receive())
+                {
+                    sum.fetch_add(*v, std::memory_order_relaxed);
+                    count.fetch_add(1, std::memory_order_relaxed);
+                }
+            }, loops.next());
+        }
+        co_await group.join();
+    }
+
+    constexpr long long kTotal = kProducers * kPerProducer;
+    NITRO_CHECK_EQ(count.load(), kTotal);
+    NITRO_CHECK_EQ(sum.load(), kTotal * (kTotal - 1) / 2);
+
+    loops.stop();
+    loops.wait();
+}
+
+/** Lock-step ping-pong across Schedulers: a single lost wakeup hangs it. */
+NITRO_TEST(channel_cross_scheduler_ping_pong)
+{
+    constexpr int kPairs = 4;
+    constexpr int kRounds = 200000;
+
+    SchedulerGroup loops(4);
+    loops.start();
+
+    std::vector<std::unique_ptr<AsyncChannel<int>>> channels;
+    for (int i = 0; i < kPairs * 2; ++i)
+        channels.push_back(std::make_unique<AsyncChannel<int>>(2));
+    std::atomic<int> mismatches{ 0 };
+    {
+        TaskGroup group;
+        for (int p = 0; p < kPairs; ++p)
+        {
+            auto & ping = *channels[p * 2];
+            auto & pong = *channels[p * 2 + 1];
+            group.spawn([&]() -> Task<> {
+                for (int i = 0; i < kRounds; ++i)
+                {
+                    co_await ping.send(i);
+                    auto reply = co_await pong.receive();
+                    if (!reply || *reply != i)
+                        mismatches.fetch_add(1, std::memory_order_relaxed);
+                }
+                ping.close();
+            }, loops.next());
+            group.spawn([&]() -> Task<> {
+                while (auto v = co_await ping.receive())
+                    co_await pong.send(*v);
+                pong.close();
+            }, loops.next());
+        }
+        co_await group.join();
+    }
+    NITRO_CHECK_EQ(mismatches.load(), 0);
+
+    loops.stop();
+    loops.wait();
+}
+
+int main(int argc, char ** argv)
+{
+    return nitrocoro::test::run_all(argc, argv);
+}
@@ -1,13 +1,27 @@
 /**
  * @file core_test.cc
- * @brief Tests for Task, Scheduler, and Generator.
+ * @brief Tests for Task, Scheduler, Generator and AsyncGenerator.
  */
+#include <nitrocoro/core/AsyncGenerator.h>
 #include <nitrocoro/core/Future.h>
 #include <nitrocoro/core/Generator.h>
 #include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/SchedulerGroup.h>
+#include <nitrocoro/core/StallWatchdog.h>
 #include <nitrocoro/core/Task.h>
 #include <nitrocoro/testing/Test.h>
 
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <sched.h>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
 using namespace nitrocoro;
 
 // ── Task ──────────────────────────────────────────────────────────────────────
@@ -34,6 +48,26 @@ NITRO_TEST(task_chain)
     NITRO_CHECK_EQ(r, 10);
 }
 
+/** Task frames are recycled through the per-thread frame pool. */
+NITRO_TEST(task_frame_pool_recycles)
+{
+#ifndef NITROCORO_DISABLE_FRAME_POOL
+    auto make = []() -> Task<int> { co_return 1; };
+    co_await make(); // warm the size class
+
+    auto before = framePoolStats();
+    int sum = 0;
+    for (int i = 0; i < 100; ++i)
+        sum += co_await make();
+    auto after = framePoolStats();
+
+    NITRO_CHECK_EQ(sum, 100);
+    NITRO_CHECK_EQ(after.hits - before.hits, 100u);
+    NITRO_CHECK_EQ(after.misses, before.misses);
+#endif
+    co_return;
+}
+
 // ── Scheduler ─────────────────────────────────────────────────────────────────
 
 /** sleep_for suspends for at least the requested duration. */
@@ -69,6 +103,419 @@ NITRO_TEST(scheduler_spawn_order)
     co_return;
 }
 
+/** Timers fire in deadline order regardless of insertion order. */
+NITRO_TEST(scheduler_timer_order)
+{
+    auto * sched = Scheduler::current();
+    auto now = std::chrono::steady_clock::now();
+    std::vector<int> fired;
+    Promise<> done(sched);
+    auto f = done.get_future();
+
+    sched->run_at(now + std::chrono::milliseconds(90), [&fired, &done]() { fired.push_back(3); done.set_value(); });
+    sched->run_at(now + std::chrono::milliseconds(10), [&fired]() { fired.push_back(1); });
+    sched->run_at(now + std::chrono::milliseconds(70), [&fired]() { fired.push_back(2); });
+    sched->run_at(now - std::chrono::milliseconds(5), [&fired]() { fired.push_back(0); });
+
+    co_await f.get();
+    NITRO_CHECK(std::chrono::steady_clock::now() - now >= std::chrono::milliseconds(90));
+    NITRO_REQUIRE_EQ(fired.size(), 4u);
+    for (int i = 0; i < 4; ++i)
+        NITRO_CHECK_EQ(fired[i], i);
+}
+
+/** A cancelled timer never fires; cancelling a fired timer is a no-op. */
+NITRO_TEST(scheduler_timer_cancel)
+{
+    auto * sched = Scheduler::current();
+    bool cancelledFired = false;
+    bool keptFired = false;
+
+    TimerId cancelled = sched->run_after(std::chrono::milliseconds(20), [&cancelledFired]() { cancelledFired = true; });
+    TimerId kept = sched->run_after(std::chrono::milliseconds(10), [&keptFired]() { keptFired = true; });
+    NITRO_CHECK_NE(cancelled, kInvalidTimerId);
+    NITRO_CHECK_NE(cancelled, kept);
+    sched->cancel_timer(cancelled);
+
+    co_await sched->sleep_for(0.05);
+    NITRO_CHECK(keptFired);
+    NITRO_CHECK(!cancelledFired);
+    sched->cancel_timer(kept);
+}
+
+/** Timers beyond the lowest wheel level cascade down and still fire on time. */
+NITRO_TEST(scheduler_timer_cascade)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    co_await Scheduler::current()->sleep_for(std::chrono::milliseconds(150));
+    auto elapsed = std::chrono::steady_clock::now() - t0;
+    NITRO_CHECK(elapsed >= std::chrono::milliseconds(150));
+    NITRO_CHECK(elapsed < std::chrono::milliseconds(300));
+}
+
+// Resumes through the generic std::function queue, i.e. what schedule(handle) used to do.
+struct FunctionQueueResume
+{
+    Scheduler * target;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) { target->schedule([h]() { h.resume(); }); }
+    void await_resume() noexcept {}
+};
+
+struct HandleQueueResume
+{
+    Scheduler * target;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) { target->schedule(h); }
+    void await_resume() noexcept {}
+};
+
+/** Microbenchmark: resumes/sec via the std::function queue vs the handle queues. */
+NITRO_TEST(scheduler_resume_throughput)
+{
+    using Clock = std::chrono::steady_clock;
+    auto perSec = [](int n, Clock::duration d) {
+        return n / std::chrono::duration<double>(d).count();
+    };
+
+    Scheduler * self = Scheduler::current();
+    constexpr int kLocal = 200000;
+
+    auto t0 = Clock::now();
+    for (int i = 0; i < kLocal; ++i)
+        co_await FunctionQueueResume{ self };
+    auto localBefore = perSec(kLocal, Clock::now() - t0);
+
+    t0 = Clock::now();
+    for (int i = 0; i < kLocal; ++i)
+        co_await HandleQueueResume{ self };
+    auto localAfter = perSec(kLocal, Clock::now() - t0);
+
+    // Cross-thread: hop to another loop and back; every hop is a remote resume.
+    SchedulerGroup group(1);
+    group.start();
+    Scheduler * other = group.at(0);
+    constexpr int kHops = 20000;
+
+    t0 = Clock::now();
+    for (int i = 0; i < kHops; ++i)
+    {
+        co_await FunctionQueueResume{ other };
+        co_await FunctionQueueResume{ self };
+    }
+    auto remoteBefore = perSec(kHops * 2, Clock::now() - t0);
+
+    t0 = Clock::now();
+    for (int i = 0; i < kHops; ++i)
+    {
+        co_await HandleQueueResume{ other };
+        co_await HandleQueueResume{ self };
+    }
+    auto remoteAfter = perSec(kHops * 2, Clock::now() - t0);
+
+    group.stop();
+    group.wait();
+
+    NITRO_INFO("same-thread resumes/sec: std::function queue %.0f, handle FIFO %.0f", localBefore, localAfter);
+    NITRO_INFO("cross-thread resumes/sec: std::function queue %.0f, handle ring %.0f", remoteBefore, remoteAfter);
+    NITRO_CHECK(Scheduler::current() == self);
+}
+
+/** SchedulerGroup runs each loop on its own thread and round-robins next(). */
+NITRO_TEST(scheduler_group_threads)
+{
+    Scheduler * testScheduler = Scheduler::current();
+    SchedulerGroup group(3);
+    group.start();
+    NITRO_REQUIRE_EQ(group.size(), 3u);
+    NITRO_CHECK(group.next() == group.at(0));
+    NITRO_CHECK(group.next() == group.at(1));
+    NITRO_CHECK(group.next() == group.at(2));
+    NITRO_CHECK(group.next() == group.at(0));
+
+    std::set<std::thread::id> threadIds;
+    for (auto * loop : group.schedulers())
+    {
+        co_await loop->switch_to();
+        NITRO_CHECK(Scheduler::current() == loop);
+        threadIds.insert(std::this_thread::get_id());
+    }
+    co_await testScheduler->switch_to();
+    NITRO_CHECK_EQ(threadIds.size(), 3u);
+
+    group.stop();
+    group.wait();
+}
+
+/** stop() may be repeated, and may be left to the destructor's wait(); next() is null before start(). */
+NITRO_TEST(scheduler_group_repeated_stop)
+{
+    SchedulerGroup group(2);
+    NITRO_CHECK(group.next() == nullptr);
+    group.start();
+    NITRO_CHECK(group.next() != nullptr);
+    group.stop();
+    group.stop();
+    group.wait();
+    group.stop();
+
+    {
+        SchedulerGroup unjoined(2);
+        unjoined.start();
+        unjoined.stop();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    co_return;
+}
+
+/** Pinned loops run only on their CPU; busy-poll loops still honour timers and remote wakeups. */
+NITRO_TEST(scheduler_group_affinity_and_busy_poll)
+{
+    Scheduler * testScheduler = Scheduler::current();
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    NITRO_REQUIRE(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    int cpu = 0;
+    while (!CPU_ISSET(cpu, &allowed))
+        ++cpu;
+
+    SchedulerGroup group(2);
+    group.setCpuAffinity({ cpu });
+    group.setBusyPoll(std::chrono::microseconds(200));
+    group.start();
+
+    for (auto * loop : group.schedulers())
+    {
+        co_await loop->switch_to();
+        NITRO_CHECK(loop->busyPoll() == std::chrono::microseconds(200));
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        NITRO_CHECK(sched_getaffinity(0, sizeof(mask), &mask) == 0);
+        NITRO_CHECK_EQ(CPU_COUNT(&mask), 1);
+        NITRO_CHECK(CPU_ISSET(cpu, &mask));
+
+        auto t0 = std::chrono::steady_clock::now();
+        co_await loop->sleep_for(std::chrono::milliseconds(3));
+        NITRO_CHECK(std::chrono::steady_clock::now() - t0 >= std::chrono::milliseconds(3));
+    }
+    co_await testScheduler->switch_to();
+
+    group.stop();
+    group.wait();
+
+    // A CPU that cannot be used fails start() cleanly.
+    SchedulerGroup bad(2);
+    bad.setCpuAffinity({ CPU_SETSIZE - 1 });
+    NITRO_CHECK_THROWS_AS(bad.start(), std::runtime_error);
+}
+
+/** now() is cached per loop iteration and advances across suspensions. */
+NITRO_TEST(scheduler_loop_time)
+{
+    auto * sched = Scheduler::current();
+    auto t0 = sched->now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    NITRO_CHECK(sched->now() == t0); // same iteration, no clock read
+    NITRO_CHECK(t0 <= std::chrono::steady_clock::now());
+
+    co_await sched->sleep_for(std::chrono::milliseconds(5));
+    auto t1 = sched->now();
+    NITRO_CHECK(t1 - t0 >= std::chrono::milliseconds(5));
+    NITRO_CHECK(t1 <= std::chrono::steady_clock::now());
+}
+
+/** statsSnapshot() reflects loop iterations, fired timers and cross-thread wakeups. */
+NITRO_TEST(scheduler_stats_snapshot)
+{
+#ifndef NITROCORO_DISABLE_SCHEDULER_STATS
+    auto * sched = Scheduler::current();
+    auto before = sched->statsSnapshot();
+    NITRO_CHECK(before.enabled);
+
+    for (int i = 0; i < 3; ++i)
+        co_await sched->sleep_for(std::chrono::milliseconds(2));
+
+    SchedulerStats fromThread;
+    std::thread([&] {
+        sched->schedule([] {});
+        fromThread = sched->statsSnapshot();
+    }).join();
+    co_await sched->sleep_for(std::chrono::milliseconds(1));
+
+    auto after = sched->statsSnapshot();
+    NITRO_CHECK(fromThread.enabled);
+    NITRO_CHECK(after.iterations > before.iterations);
+    NITRO_CHECK(after.timersFired >= before.timersFired + 3);
+    NITRO_CHECK(after.timerLateness.count >= before.timerLateness.count + 3);
+    NITRO_CHECK(after.wakeups > before.wakeups);
+    NITRO_CHECK(after.tasksRun > before.tasksRun);
+    NITRO_CHECK(after.pollWaitNs > before.pollWaitNs);
+    NITRO_CHECK(after.loopBusy.count > 0);
+#endif
+    co_return;
+}
+
+/** co_await yield() defers to the next iteration, so a yielding loop cannot starve timers. */
+NITRO_TEST(scheduler_yield_lets_timers_run)
+{
+    auto * sched = Scheduler::current();
+    bool fired = false;
+    sched->run_after(std::chrono::milliseconds(1), [&fired] { fired = true; });
+
+    size_t spins = 0;
+    while (!fired && spins < 10'000'000)
+    {
+        ++spins;
+        co_await yield();
+    }
+    NITRO_CHECK(fired);
+}
+
+/** With a ready budget, a coroutine rescheduling itself via schedule() still lets the loop poll. */
+NITRO_TEST(scheduler_ready_budget)
+{
+    struct Reschedule
+    {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { Scheduler::current()->schedule(h); }
+        void await_resume() noexcept {}
+    };
+
+    auto * sched = Scheduler::current();
+    sched->setReadyBudget(64);
+    bool fired = false;
+    sched->run_after(std::chrono::milliseconds(1), [&fired] { fired = true; });
+
+    size_t spins = 0;
+    while (!fired && spins < 10'000'000)
+    {
+        ++spins;
+        co_await Reschedule{};
+    }
+    sched->setReadyBudget(0);
+    NITRO_CHECK(fired);
+}
+
+/** Background-lane work runs only after Normal-lane work is drained. */
+NITRO_TEST(scheduler_background_lane)
+{
+    auto * sched = Scheduler::current();
+    std::vector<int> order;
+    Promise<> done(sched);
+    auto f = done.get_future();
+
+    sched->spawn([&order, &done]() -> Task<> {
+        co_await yield(Lane::Background);
+        order.push_back(3);
+        done.set_value();
+    });
+    sched->spawn([&order]() -> Task<> {
+        order.push_back(1);
+        co_await yield();
+        order.push_back(2);
+    });
+
+    co_await f.get();
+    NITRO_REQUIRE(order.size() == 3u);
+    NITRO_CHECK_EQ(order[0], 1);
+    NITRO_CHECK_EQ(order[1], 2);
+    NITRO_CHECK_EQ(order[2], 3);
+}
+
+/** Cross-thread schedules coalesce their eventfd writes; scheduleBatch() wakes the loop once. */
+NITRO_TEST(scheduler_wakeup_coalescing)
+{
+    struct Park
+    {
+        std::vector<std::coroutine_handle<>> * parked;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { parked->push_back(h); }
+        void await_resume() noexcept {}
+    };
+
+    auto * sched = Scheduler::current();
+    constexpr int kCount = 10000;
+    std::atomic<int> ran{ 0 };
+    auto before = sched->statsSnapshot();
+
+    std::thread([&] {
+        for (int i = 0; i < kCount; ++i)
+            sched->schedule([&ran] { ran.fetch_add(1, std::memory_order_relaxed); });
+    }).join();
+    while (ran.load() < kCount)
+        co_await sched->sleep_for(std::chrono::milliseconds(1));
+
+    auto after = sched->statsSnapshot();
+    if (after.enabled)
+        NITRO_CHECK(after.wakeups - before.wakeups < static_cast<uint64_t>(kCount) / 10);
+
+    // Park coroutines, then resume them all from another thread in one batch.
+    std::vector<std::coroutine_handle<>> parked;
+    int resumed = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        sched->spawn([&parked, &resumed]() -> Task<> {
+            co_await Park{ &parked };
+            ++resumed;
+        });
+    }
+    co_await yield();
+    NITRO_REQUIRE(parked.size() == 8u);
+    std::thread([&] { sched->scheduleBatch(parked); }).join();
+    while (resumed < 8)
+        co_await sched->sleep_for(std::chrono::milliseconds(1));
+    NITRO_CHECK_EQ(resumed, 8);
+}
+
+/** LatencyHistogram::percentileUs() returns the upper edge of the matching log2 bucket. */
+NITRO_TEST(scheduler_stats_histogram)
+{
+    LatencyHistogram h;
+    h.buckets[0] = 50;  // < 1us
+    h.buckets[4] = 40;  // [8, 16) us
+    h.buckets[10] = 10; // [512, 1024) us
+    h.count = 100;
+    h.maxUs = 900;
+
+    NITRO_CHECK_EQ(h.percentileUs(0.5), 1u);
+    NITRO_CHECK_EQ(h.percentileUs(0.9), 16u);
+    NITRO_CHECK_EQ(h.percentileUs(0.99), 1024u);
+    NITRO_CHECK_EQ(LatencyHistogram{}.percentileUs(0.5), 0u);
+    co_return;
+}
+
+/** StallWatchdog reports a blocked loop with the co_await site the coroutine resumed from. */
+NITRO_TEST(scheduler_stall_watchdog)
+{
+    std::mutex mutex;
+    std::vector<StallReport> reports;
+    StallWatchdog watchdog({ Scheduler::current() }, std::chrono::milliseconds(20), [&](const StallReport & report) {
+        std::lock_guard lock(mutex);
+        reports.push_back(report);
+    });
+
+    const unsigned resumeLine = __LINE__ + 1;
+    co_await Scheduler::current()->sleep_for(0.005);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100)); // blocks the loop
+    co_await Scheduler::current()->sleep_for(0.005);
+    watchdog.stop();
+
+    std::lock_guard lock(mutex);
+    NITRO_REQUIRE(!reports.empty());
+    NITRO_CHECK(reports.size() <= 3); // 20ms, 40ms, 80ms
+    NITRO_CHECK(reports[0].scheduler == Scheduler::current());
+    NITRO_CHECK(reports[0].duration >= std::chrono::milliseconds(20));
+#ifndef NITROCORO_DISABLE_RESUME_SITES
+    NITRO_CHECK_EQ(reports[0].site.line(), resumeLine);
+    NITRO_CHECK(std::string_view(reports[0].site.file_name()).ends_with("core_test.cc"));
+#else
+    (void)resumeLine;
+    NITRO_CHECK_EQ(reports[0].site.line(), 0u);
+#endif
+}
+
 // ── Generator ─────────────────────────────────────────────────────────────────
 
 /** Generator yields values lazily and stops at the end. */
@@ -107,6 +554,101 @@ NITRO_TEST(generator_exception)
     co_return;
 }
 
+// ── AsyncGenerator ────────────────────────────────────────────────────────────
+
+/** The producer may co_await between yields; values arrive in order, then nullopt. */
+NITRO_TEST(async_generator_awaits_between_yields)
+{
+    auto ticks = [](int n) -> AsyncGenerator<int> {
+        for (int i = 0; i < n; ++i)
+        {
+            co_await Scheduler::current()->sleep_for(0.001);
+            co_yield i;
+        }
+    };
+    auto gen = ticks(4);
+    std::vector<int> got;
+    while (auto v = co_await gen.next())
+        got.push_back(*v);
+    NITRO_CHECK(got == std::vector<int>({ 0, 1, 2, 3 }));
+    NITRO_CHECK(!(co_await gen.next()).has_value());
+}
+
+/** Yielded lvalues are moved out without copies; const lvalues are copied. */
+NITRO_TEST(async_generator_moves_values)
+{
+    auto words = []() -> AsyncGenerator<std::unique_ptr<std::string>> {
+        auto word = std::make_unique<std::string>("moved");
+        co_yield word;
+        co_yield std::make_unique<std::string>("temporary");
+    };
+    auto gen = words();
+    NITRO_CHECK_EQ(**co_await gen.next(), std::string("moved"));
+    NITRO_CHECK_EQ(**co_await gen.next(), std::string("temporary"));
+
+    auto constant = []() -> AsyncGenerator<std::string> {
+        const std::string word = "copied";
+        co_yield word;
+    };
+    auto gen2 = constant();
+    NITRO_CHECK_EQ(*co_await gen2.next(), std::string("copied"));
+}
+
+/** A producer exception is rethrown by next(); the generator then reports the end. */
+NITRO_TEST(async_generator_exception)
+{
+    auto failing = []() -> AsyncGenerator<int> {
+        co_yield 1;
+        co_await Scheduler::current()->sleep_for(0.001);
+        throw std::runtime_error("producer failed");
+    };
+    auto gen = failing();
+    NITRO_CHECK_EQ(*co_await gen.next(), 1);
+    NITRO_CHECK_THROWS_AS(co_await gen.next(), std::runtime_error);
+    NITRO_CHECK(!(co_await gen.next()).has_value());
+}
+
+/** Dropping a generator mid-stream destroys the producer's locals. */
+NITRO_TEST(async_generator_early_destroy)
+{
+    bool cleaned = false;
+    {
+        auto endless = [](bool & flag) -> AsyncGenerator<int> {
+            struct Cleanup
+            {
+                bool & flag;
+                ~Cleanup() { flag = true; }
+            } cleanup{ flag };
+            for (int i = 0;; ++i)
+                co_yield i;
+        };
+        auto gen = endless(cleaned);
+        NITRO_CHECK_EQ(*co_await gen.next(), 0);
+        NITRO_CHECK_EQ(*co_await gen.next(), 1);
+    }
+    NITRO_CHECK(cleaned);
+}
+
+/** forEach accepts plain and coroutine callbacks. */
+NITRO_TEST(async_generator_for_each)
+{
+    auto range = [](int n) -> AsyncGenerator<int> {
+        for (int i = 1; i <= n; ++i)
+            co_yield i;
+    };
+    int sum = 0;
+    auto gen = range(4);
+    co_await forEach(gen, [&sum](int v) { sum += v; });
+    NITRO_CHECK_EQ(sum, 10);
+
+    auto gen2 = range(3);
+    co_await forEach(gen2, [&sum](int v) -> Task<> {
+        co_await Scheduler::current()->sleep_for(0.001);
+        sum += v;
+    });
+    NITRO_CHECK_EQ(sum, 16);
+}
+
 int main(int argc, char ** argv)
 {
     return nitrocoro::test::run_all(argc, argv);
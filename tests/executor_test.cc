@@ -0,0 +1,160 @@
+/**
+ * @file executor_test.cc
+ * @brief Tests for WorkStealingExecutor: offload, parallel algorithms and stealing.
+ */
+#include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/Task.h>
+#include <nitrocoro/core/WorkStealingExecutor.h>
+#include <nitrocoro/testing/Test.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace nitrocoro;
+
+/** run() executes off the loop thread and resumes the caller on its Scheduler. */
+NITRO_TEST(executor_run_resumes_on_scheduler)
+{
+    WorkStealingExecutor executor(2);
+    auto * sched = Scheduler::current();
+    auto loopThread = std::this_thread::get_id();
+
+    std::thread::id workerThread;
+    int value = co_await executor.run([&] {
+        workerThread = std::this_thread::get_id();
+        return 42;
+    });
+
+    NITRO_CHECK_EQ(value, 42);
+    NITRO_CHECK(workerThread != loopThread);
+    NITRO_CHECK(std::this_thread::get_id() == loopThread);
+    NITRO_CHECK(Scheduler::current() == sched);
+}
+
+/** Exceptions thrown by offloaded work are rethrown at the co_await. */
+NITRO_TEST(executor_run_propagates_exception)
+{
+    WorkStealingExecutor executor(1);
+    NITRO_CHECK_THROWS_AS(co_await executor.run([]() -> int { throw std::runtime_error("boom"); }), std::runtime_error);
+    co_await executor.run([] {});
+}
+
+/** parallel_for visits every index exactly once. */
+NITRO_TEST(executor_parallel_for)
+{
+    WorkStealingExecutor executor(4);
+    constexpr size_t kCount = 100000;
+    std::vector<std::atomic<int>> hits(kCount);
+
+    co_await executor.parallel_for(0, kCount, [&](size_t i) { hits[i].fetch_add(1, std::memory_order_relaxed); });
+
+    size_t wrong = 0;
+    for (auto & h : hits)
+        wrong += h.load() != 1;
+    NITRO_CHECK_EQ(wrong, 0u);
+
+    // Empty ranges complete without touching the pool.
+    co_await executor.parallel_for(5, 5, [&](size_t) { ++wrong; });
+    NITRO_CHECK_EQ(wrong, 0u);
+}
+
+/** parallel_transform and parallel_reduce match their sequential results. */
+NITRO_TEST(executor_transform_reduce)
+{
+    WorkStealingExecutor executor(4);
+    std::vector<int> in(10000);
+    std::iota(in.begin(), in.end(), 0);
+    std::vector<long long> out(in.size());
+
+    co_await executor.parallel_transform(std::span<const int>(in), std::span<long long>(out), [](int v) {
+        return static_cast<long long>(v) * v;
+    });
+    NITRO_CHECK_EQ(out[0], 0);
+    NITRO_CHECK_EQ(out[9999], 9999LL * 9999);
+
+    long long sum = co_await executor.parallel_reduce(
+        0, out.size(), 7LL, [&](size_t i) { return out[i]; }, [](long long a, long long b) { return a + b; });
+    NITRO_CHECK_EQ(sum, 7 + std::accumulate(out.begin(), out.end(), 0LL));
+
+    // Non-commutative reduce: chunks are combined in index order.
+    std::string word = co_await executor.parallel_reduce(
+        0, 26, std::string(), [](size_t i) { return std::string(1, static_cast<char>('a' + i)); },
+        [](std::string a, std::string b) { return a + b; }, 1);
+    NITRO_CHECK_EQ(word, std::string("abcdefghijklmnopqrstuvwxyz"));
+}
+
+/** A failing iteration fails the whole parallel_for. */
+NITRO_TEST(executor_parallel_for_exception)
+{
+    WorkStealingExecutor executor(2);
+    NITRO_CHECK_THROWS_AS(co_await executor.parallel_for(0, 1000, [](size_t i) {
+        if (i == 500)
+            throw std::logic_error("bad index");
+    }),
+                          std::logic_error);
+}
+
+/** Work pushed onto one worker's deque is stolen by idle workers. */
+NITRO_TEST(executor_steals_nested_work)
+{
+    WorkStealingExecutor executor(4);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+
+    // The outer job runs on one worker; the jobs it posts land on that worker's
+    // deque and the others must steal them to run concurrently.
+    co_await executor.run([&] {
+        std::atomic<int> remaining{ 16 };
+        for (int i = 0; i < 16; ++i)
+        {
+            executor.post([&] {
+                {
+                    std::lock_guard lock(mutex);
+                    threads.insert(std::this_thread::get_id());
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                remaining.fetch_sub(1);
+            });
+        }
+        while (remaining.load() > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+
+    NITRO_CHECK(threads.size() >= 2u);
+}
+
+/** post() works as a drop-in TaskQueue. */
+NITRO_TEST(executor_post_from_many_threads)
+{
+    auto executor = std::make_shared<WorkStealingExecutor>(3);
+    std::shared_ptr<TaskQueue> queue = executor;
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 5000;
+    std::atomic<int> ran{ 0 };
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; ++t)
+        producers.emplace_back([&] {
+            for (int i = 0; i < kPerThread; ++i)
+                queue->post([&] { ran.fetch_add(1, std::memory_order_relaxed); });
+        });
+    for (auto & p : producers)
+        p.join();
+
+    for (int i = 0; i < 200 && ran.load() < kThreads * kPerThread; ++i)
+        co_await Scheduler::current()->sleep_for(0.01);
+    NITRO_CHECK_EQ(ran.load(), kThreads * kPerThread);
+}
+
+int main(int argc, char ** argv)
+{
+    return nitrocoro::test::run_all(argc, argv);
+}
@@ -0,0 +1,244 @@
+/**
+ * @file mpsc_queue_test.cc
+ * @brief Tests and producer-scaling benchmark for MpscQueue and BoundedMpscQueue.
+ */
+#include <nitrocoro/core/MpscQueue.h>
+#include <nitrocoro/testing/Test.h>
+#include <nitrocoro/utils/Debug.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace nitrocoro;
+
+namespace
+{
+
+struct NoDefault
+{
+    explicit NoDefault(int v)
+        : value(v) {}
+    int value;
+};
+
+// The queue as it was before node recycling: one new/delete per element and
+// head/tail on one cache line. Kept here only as the benchmark baseline.
+template <typename T>
+class AllocatingMpscQueue
+{
+public:
+    AllocatingMpscQueue()
+    {
+        Node * stub = new Node();
+        head_.store(stub, std::memory_order_relaxed);
+        tail_ = stub;
+    }
+
+    ~AllocatingMpscQueue()
+    {
+        while (Node * node = head_.load(std::memory_order_relaxed))
+        {
+            head_.store(node->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            delete node;
+        }
+    }
+
+    void push(T value)
+    {
+        Node * node = new Node{ std::move(value), nullptr };
+        Node * prev = tail_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    std::optional<T> pop()
+    {
+        Node * head = head_.load(std::memory_order_relaxed);
+        Node * next = head->next.load(std::memory_order_acquire);
+        if (!next)
+            return std::nullopt;
+        T value = std::move(next->value);
+        head_.store(next, std::memory_order_release);
+        delete head;
+        return value;
+    }
+
+private:
+    struct Node
+    {
+        T value{};
+        std::atomic<Node *> next{ nullptr };
+    };
+
+    std::atomic<Node *> head_;
+    std::atomic<Node *> tail_;
+};
+
+// Runs @p producers threads pushing @p perProducer items each through
+// @p push while the calling thread pops them all; returns items per second.
+template <typename Push, typename Pop>
+double measure(int producers, long long perProducer, Push push, Pop pop)
+{
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p] {
+            while (!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            for (long long i = 0; i < perProducer; ++i)
+                push(p * perProducer + i);
+        });
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    long long total = producers * perProducer;
+    for (long long received = 0; received < total;)
+    {
+        if (pop())
+            ++received;
+        else
+            std::this_thread::yield();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - t0;
+    for (auto & t : threads)
+        t.join();
+    return total / std::chrono::duration<double>(elapsed).count();
+}
+
+} // namespace
+
+/** FIFO order, move-only and non-default-constructible values, node reuse. */
+NITRO_TEST(mpsc_queue_fifo)
+{
+    MpscQueue<std::unique_ptr<int>> queue;
+    NITRO_CHECK(queue.empty());
+    NITRO_CHECK(!queue.pop().has_value());
+
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 100; ++i)
+            queue.push(std::make_unique<int>(i));
+        NITRO_CHECK(!queue.empty());
+        for (int i = 0; i < 100; ++i)
+            NITRO_CHECK_EQ(**queue.pop(), i);
+        NITRO_CHECK(queue.empty());
+    }
+
+    MpscQueue<NoDefault> noDefault;
+    noDefault.push(NoDefault(7));
+    NITRO_CHECK_EQ(noDefault.pop()->value, 7);
+    co_return;
+}
+
+/** Popped values are destroyed at once; values still queued are destroyed with the queue. */
+NITRO_TEST(mpsc_queue_value_lifetime)
+{
+    auto tracker = std::make_shared<int>(0);
+    {
+        MpscQueue<std::shared_ptr<int>> queue;
+        for (int i = 0; i < 10; ++i)
+            queue.push(tracker);
+        NITRO_CHECK_EQ(tracker.use_count(), 11);
+        for (int i = 0; i < 4; ++i)
+            queue.pop();
+        NITRO_CHECK_EQ(tracker.use_count(), 7);
+    }
+    NITRO_CHECK_EQ(tracker.use_count(), 1);
+    co_return;
+}
+
+/** Concurrent producers: every item arrives once, in per-producer order. */
+NITRO_TEST(mpsc_queue_multi_producer)
+{
+    constexpr int kProducers = 8;
+    constexpr int kPerProducer = 50000;
+
+    MpscQueue<std::pair<int, int>> queue;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p)
+    {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; ++i)
+                queue.push({ p, i });
+        });
+    }
+
+    std::vector<int> nextExpected(kProducers, 0);
+    bool ordered = true;
+    for (int received = 0; received < kProducers * kPerProducer;)
+    {
+        if (auto item = queue.pop())
+        {
+            ordered = ordered && item->second == nextExpected[item->first];
+            ++nextExpected[item->first];
+            ++received;
+        }
+    }
+    for (auto & t : threads)
+        t.join();
+
+    NITRO_CHECK(ordered);
+    NITRO_CHECK(queue.empty());
+    for (int p = 0; p < kProducers; ++p)
+        NITRO_CHECK_EQ(nextExpected[p], kPerProducer);
+    co_return;
+}
+
+/** try_push fails once the ring is full and succeeds again after a pop. */
+NITRO_TEST(bounded_mpsc_queue_try_push)
+{
+    BoundedMpscQueue<int> queue(5);
+    NITRO_CHECK_EQ(queue.capacity(), 8u);
+    for (int i = 0; i < 8; ++i)
+        NITRO_CHECK(queue.try_push(i));
+    NITRO_CHECK(!queue.try_push(8));
+    NITRO_CHECK_EQ(*queue.pop(), 0);
+    NITRO_CHECK(queue.try_push(8));
+    for (int i = 1; i <= 8; ++i)
+        NITRO_CHECK_EQ(*queue.pop(), i);
+    NITRO_CHECK(!queue.pop().has_value());
+    co_return;
+}
+
+/** Items/sec through each queue with 1, 4 and 16 producer threads and one consumer. */
+NITRO_TEST(mpsc_queue_producer_scaling)
+{
+    constexpr long long kTotal = 800000;
+    for (int producers : { 1, 4, 16 })
+    {
+        long long perProducer = kTotal / producers;
+
+        AllocatingMpscQueue<long long> allocating;
+        double before = measure(producers, perProducer,
+                                [&](long long v) { allocating.push(v); },
+                                [&] { return allocating.pop().has_value(); });
+
+        MpscQueue<long long> recycling;
+        double after = measure(producers, perProducer,
+                               [&](long long v) { recycling.push(v); },
+                               [&] { return recycling.pop().has_value(); });
+
+        BoundedMpscQueue<long long> bounded(1024);
+        double ring = measure(producers, perProducer,
+                              [&](long long v) {
+                                  while (!bounded.try_push(v))
+                                      std::this_thread::yield();
+                              },
+                              [&] { return bounded.pop().has_value(); });
+
+        NITRO_INFO("%2d producers, items/sec: allocating %.0f, recycling %.0f, bounded ring %.0f",
+                   producers, before, after, ring);
+    }
+    co_return;
+}
+
+int main(int argc, char ** argv)
+{
+    return nitrocoro::test::run_all(argc, argv);
+}
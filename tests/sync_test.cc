@@ -1,12 +1,25 @@
 /**
  * @file sync_test.cc
- * @brief Tests for Future/Promise/SharedFuture and Mutex.
+ * @brief Tests for Future/Promise/SharedFuture, Mutex, Semaphore, RwLock, Event, Latch and Barrier.
  */
+#include <nitrocoro/core/Barrier.h>
+#include <nitrocoro/core/Event.h>
 #include <nitrocoro/core/Future.h>
+#include <nitrocoro/core/Latch.h>
 #include <nitrocoro/core/Mutex.h>
+#include <nitrocoro/core/RwLock.h>
 #include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/SchedulerGroup.h>
+#include <nitrocoro/core/Semaphore.h>
 #include <nitrocoro/core/Task.h>
+#include <nitrocoro/core/TaskGroup.h>
 #include <nitrocoro/testing/Test.h>
+#include <nitrocoro/utils/Debug.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
 
 using namespace nitrocoro;
 
@@ -210,6 +223,399 @@ NITRO_TEST(mutex_scoped_lock_exclusive)
     NITRO_CHECK_EQ(counter, 10);
 }
 
+// ── Semaphore ─────────────────────────────────────────────────────────────────
+
+/** try_acquire takes free permits only; release hands them back. */
+NITRO_TEST(semaphore_try_acquire)
+{
+    Semaphore sem(2);
+    NITRO_CHECK(sem.try_acquire());
+    NITRO_CHECK(sem.try_acquire());
+    NITRO_CHECK(!sem.try_acquire());
+    sem.release(2);
+    NITRO_CHECK_EQ(sem.available(), 2);
+    {
+        auto permit = co_await sem.scoped_acquire();
+        NITRO_CHECK_EQ(sem.available(), 1);
+    }
+    NITRO_CHECK_EQ(sem.available(), 2);
+}
+
+/** At most N holders at once, even with acquirers spread across Schedulers. */
+NITRO_TEST(semaphore_bounds_concurrency)
+{
+    SchedulerGroup loops(4);
+    loops.start();
+
+    Semaphore sem(3);
+    std::atomic<int> inFlight{ 0 };
+    std::atomic<int> peak{ 0 };
+    std::atomic<int> done{ 0 };
+    {
+        TaskGroup group;
+        for (int i = 0; i < 24; ++i)
+        {
+            group.spawn([&]() -> Task<> {
+                auto permit = co_await sem.scoped_acquire();
+                int now = inFlight.fetch_add(1) + 1;
+                int prev = peak.load();
+                while (now > prev && !peak.compare_exchange_weak(prev, now))
+                {
+                }
+                co_await Scheduler::current()->sleep_for(0.002);
+                inFlight.fetch_sub(1);
+                done.fetch_add(1);
+            }, loops.next());
+        }
+        co_await group.join();
+    }
+
+    NITRO_CHECK_EQ(done.load(), 24);
+    NITRO_CHECK(peak.load() <= 3);
+    NITRO_CHECK_EQ(sem.available(), 3);
+
+    loops.stop();
+    loops.wait();
+}
+
+// ── RwLock ────────────────────────────────────────────────────────────────────
+
+/** Readers share the lock; a writer excludes readers and other writers. */
+NITRO_TEST(rwlock_shared_and_exclusive)
+{
+    RwLock lock;
+    NITRO_CHECK(lock.try_lock_shared());
+    NITRO_CHECK(lock.try_lock_shared());
+    NITRO_CHECK(!lock.try_lock());
+    lock.unlock_shared();
+    lock.unlock_shared();
+    NITRO_CHECK(lock.try_lock());
+    NITRO_CHECK(!lock.try_lock_shared());
+    lock.unlock();
+
+    SchedulerGroup loops(4);
+    loops.start();
+
+    std::atomic<int> readers{ 0 };
+    std::atomic<int> writers{ 0 };
+    std::atomic<int> maxReaders{ 0 };
+    std::atomic<bool> violated{ false };
+    long long value = 0;
+    {
+        TaskGroup group;
+        for (int i = 0; i < 16; ++i)
+        {
+            bool writer = i % 4 == 0;
+            group.spawn([&, writer]() -> Task<> {
+                for (int round = 0; round < 50; ++round)
+                {
+                    if (writer)
+                    {
+                        auto guard = co_await lock.scoped_lock();
+                        if (writers.fetch_add(1) != 0 || readers.load() != 0)
+                            violated = true;
+                        ++value;
+                        writers.fetch_sub(1);
+                    }
+                    else
+                    {
+                        auto guard = co_await lock.scoped_lock_shared();
+                        int now = readers.fetch_add(1) + 1;
+                        if (writers.load() != 0)
+                            violated = true;
+                        int prev = maxReaders.load();
+                        while (now > prev && !maxReaders.compare_exchange_weak(prev, now))
+                        {
+                        }
+                        co_await Scheduler::current()->sleep_for(0.0002);
+                        readers.fetch_sub(1);
+                    }
+                }
+            }, loops.next());
+        }
+        co_await group.join();
+    }
+
+    NITRO_CHECK(!violated.load());
+    NITRO_CHECK_EQ(value, 4 * 50);
+    NITRO_CHECK(maxReaders.load() >= 2);
+
+    loops.stop();
+    loops.wait();
+}
+
+/** A queued writer blocks new readers, so it gets in while readers keep arriving. */
+NITRO_TEST(rwlock_writer_not_starved)
+{
+    RwLock lock;
+    bool stop = false;
+    bool writerDone = false;
+    int readersAfterWriter = 0;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        Scheduler::current()->spawn([&]() -> Task<> {
+            while (!stop)
+            {
+                auto guard = co_await lock.scoped_lock_shared();
+                if (writerDone)
+                    ++readersAfterWriter;
+                co_await Scheduler::current()->sleep_for(0.001);
+            }
+        });
+    }
+    co_await Scheduler::current()->sleep_for(0.005);
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        auto guard = co_await lock.scoped_lock();
+        writerDone = true;
+    }
+    NITRO_CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100));
+
+    co_await Scheduler::current()->sleep_for(0.005);
+    stop = true;
+    co_await Scheduler::current()->sleep_for(0.005);
+    NITRO_CHECK(readersAfterWriter > 0);
+}
+
+// ── Event / Latch / Barrier ──────────────────────────────────────────────────
+
+/** set() releases waiters on every Scheduler; reset() makes wait() suspend again. */
+NITRO_TEST(event_set_reset)
+{
+    SchedulerGroup loops(3);
+    loops.start();
+
+    Event event;
+    NITRO_CHECK(!event.isSet());
+    std::atomic<int> woke{ 0 };
+    {
+        TaskGroup group;
+        for (int i = 0; i < 6; ++i)
+        {
+            group.spawn([&]() -> Task<> {
+                co_await event.wait();
+                woke.fetch_add(1);
+            }, loops.next());
+        }
+        co_await Scheduler::current()->sleep_for(0.01);
+        NITRO_CHECK_EQ(woke.load(), 0);
+        event.set();
+        co_await group.join();
+    }
+    NITRO_CHECK_EQ(woke.load(), 6);
+
+    // Already set: completes without suspending.
+    co_await event.wait();
+    event.reset();
+    NITRO_CHECK(!event.isSet());
+
+    bool resumed = false;
+    Scheduler::current()->spawn([&]() -> Task<> {
+        co_await event.wait();
+        resumed = true;
+    });
+    co_await Scheduler::current()->sleep_for(0.005);
+    NITRO_CHECK(!resumed);
+    event.set();
+    co_await Scheduler::current()->sleep_for(0.005);
+    NITRO_CHECK(resumed);
+
+    loops.stop();
+    loops.wait();
+}
+
+/** wait() completes once count_down() has been called the expected number of times. */
+NITRO_TEST(latch_count_down)
+{
+    SchedulerGroup loops(2);
+    loops.start();
+
+    Latch latch(4);
+    NITRO_CHECK(!latch.try_wait());
+    for (int i = 0; i < 4; ++i)
+    {
+        loops.next()->spawn([&latch]() -> Task<> {
+            co_await Scheduler::current()->sleep_for(0.002);
+            latch.count_down();
+        });
+    }
+    co_await latch.wait();
+    NITRO_CHECK(latch.try_wait());
+    co_await latch.wait();
+
+    Latch zero(0);
+    co_await zero.wait();
+
+    loops.stop();
+    loops.wait();
+}
+
+/** No participant enters phase k+1 before all have finished phase k; the barrier is reusable. */
+NITRO_TEST(barrier_phases)
+{
+    constexpr int kParticipants = 4;
+    constexpr int kPhases = 20;
+
+    SchedulerGroup loops(kParticipants);
+    loops.start();
+
+    Barrier barrier(kParticipants);
+    std::atomic<int> arrivals[kPhases] = {};
+    std::atomic<bool> violated{ false };
+    {
+        TaskGroup group;
+        for (int i = 0; i < kParticipants; ++i)
+        {
+            group.spawn([&]() -> Task<> {
+                for (int phase = 0; phase < kPhases; ++phase)
+                {
+                    arrivals[phase].fetch_add(1);
+                    co_await barrier.arrive_and_wait();
+                    if (arrivals[phase].load() != kParticipants)
+                        violated = true;
+                }
+            }, loops.next());
+        }
+        co_await group.join();
+    }
+    NITRO_CHECK(!violated.load());
+
+    loops.stop();
+    loops.wait();
+}
+
+// ── Benchmarks ────────────────────────────────────────────────────────────────
+
+namespace
+{
+
+using BenchClock = std::chrono::steady_clock;
+
+double opsPerSec(long long ops, BenchClock::duration d)
+{
+    return static_cast<double>(ops) / std::chrono::duration<double>(d).count();
+}
+
+// Runs @p body(iterations) on @p workers coroutines spread over @p loops.
+template <typename Body>
+Task<double> contendedOpsPerSec(SchedulerGroup & loops, int workers, int iterations, Body body)
+{
+    auto start = BenchClock::now();
+    TaskGroup group;
+    for (int w = 0; w < workers; ++w)
+        group.spawn([&body, iterations]() -> Task<> { co_await body(iterations); }, loops.next());
+    co_await group.join();
+    co_return opsPerSec(static_cast<long long>(workers) * iterations, BenchClock::now() - start);
+}
+
+} // namespace
+
+/** Microbenchmark: uncontended acquire/release round trips on one coroutine. */
+NITRO_TEST(sync_uncontended_throughput)
+{
+    constexpr int kOps = 200000;
+    Mutex mutex;
+    Semaphore sem(1);
+    RwLock rw;
+
+    auto t0 = BenchClock::now();
+    for (int i = 0; i < kOps; ++i)
+    {
+        co_await mutex.lock();
+        mutex.unlock();
+    }
+    double mutexRate = opsPerSec(kOps, BenchClock::now() - t0);
+
+    t0 = BenchClock::now();
+    for (int i = 0; i < kOps; ++i)
+    {
+        co_await sem.acquire();
+        sem.release();
+    }
+    double semRate = opsPerSec(kOps, BenchClock::now() - t0);
+
+    t0 = BenchClock::now();
+    for (int i = 0; i < kOps; ++i)
+    {
+        co_await rw.lock_shared();
+        rw.unlock_shared();
+    }
+    double readRate = opsPerSec(kOps, BenchClock::now() - t0);
+
+    t0 = BenchClock::now();
+    for (int i = 0; i < kOps; ++i)
+    {
+        co_await rw.lock();
+        rw.unlock();
+    }
+    double writeRate = opsPerSec(kOps, BenchClock::now() - t0);
+
+    NITRO_INFO("uncontended ops/sec: Mutex %.0f, Semaphore %.0f, RwLock read %.0f, RwLock write %.0f",
+               mutexRate, semRate, readRate, writeRate);
+    NITRO_CHECK(sem.available() == 1);
+}
+
+/** Microbenchmark: 8 coroutines on 4 Schedulers hammering the same primitive. */
+NITRO_TEST(sync_contended_throughput)
+{
+    constexpr int kWorkers = 8;
+    constexpr int kOps = 5000;
+    SchedulerGroup loops(4);
+    loops.start();
+
+    Mutex mutex;
+    Semaphore sem(2);
+    RwLock rw;
+    long long counter = 0;
+
+    double mutexRate = co_await contendedOpsPerSec(loops, kWorkers, kOps, [&](int n) -> Task<> {
+        for (int i = 0; i < n; ++i)
+        {
+            co_await mutex.lock();
+            ++counter;
+            mutex.unlock();
+        }
+    });
+    NITRO_CHECK_EQ(counter, static_cast<long long>(kWorkers) * kOps);
+
+    double semRate = co_await contendedOpsPerSec(loops, kWorkers, kOps, [&](int n) -> Task<> {
+        for (int i = 0; i < n; ++i)
+        {
+            co_await sem.acquire();
+            sem.release();
+        }
+    });
+
+    // One writer in eight.
+    std::atomic<int> next{ 0 };
+    double rwRate = co_await contendedOpsPerSec(loops, kWorkers, kOps, [&](int n) -> Task<> {
+        bool writer = next.fetch_add(1) % kWorkers == 0;
+        for (int i = 0; i < n; ++i)
+        {
+            if (writer)
+            {
+                co_await rw.lock();
+                ++counter;
+                rw.unlock();
+            }
+            else
+            {
+                co_await rw.lock_shared();
+                rw.unlock_shared();
+            }
+        }
+    });
+
+    NITRO_INFO("contended ops/sec (%d coroutines, 4 loops): Mutex %.0f, Semaphore(2) %.0f, RwLock 1:7 %.0f",
+               kWorkers, mutexRate, semRate, rwRate);
+    NITRO_CHECK_EQ(sem.available(), 2);
+
+    loops.stop();
+    loops.wait();
+}
+
 int main(int argc, char ** argv)
 {
     return nitrocoro::test::run_all(argc, argv);
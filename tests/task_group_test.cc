@@ -0,0 +1,200 @@
+/**
+ * @file task_group_test.cc
+ * @brief Tests for whenAll, whenAny and TaskGroup.
+ */
+#include <nitrocoro/core/CancelToken.h>
+#include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/SchedulerGroup.h>
+#include <nitrocoro/core/Task.h>
+#include <nitrocoro/core/TaskGroup.h>
+#include <nitrocoro/testing/Test.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace nitrocoro;
+
+namespace
+{
+
+Task<int> delayedValue(int value, double seconds)
+{
+    co_await Scheduler::current()->sleep_for(seconds);
+    co_return value;
+}
+
+Task<> delayedThrow(double seconds)
+{
+    co_await Scheduler::current()->sleep_for(seconds);
+    throw std::runtime_error("child failed");
+}
+
+} // namespace
+
+// ── whenAll ───────────────────────────────────────────────────────────────────
+
+/** whenAll runs tasks concurrently and returns their results in order. */
+NITRO_TEST(when_all_tuple)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto [a, b, c] = co_await whenAll(delayedValue(1, 0.05), delayedValue(2, 0.05), []() -> Task<std::string> {
+        co_return "sync";
+    }());
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    NITRO_CHECK_EQ(a, 1);
+    NITRO_CHECK_EQ(b, 2);
+    NITRO_CHECK_EQ(c, std::string("sync"));
+    NITRO_CHECK(elapsed < std::chrono::milliseconds(90));
+}
+
+/** Tasks that all complete synchronously do not suspend the caller. */
+NITRO_TEST(when_all_synchronous)
+{
+    auto one = []() -> Task<int> { co_return 1; };
+    auto none = []() -> Task<> { co_return; };
+    auto [x, unit] = co_await whenAll(one(), none());
+    NITRO_CHECK_EQ(x, 1);
+    (void)unit;
+}
+
+/** The vector form collects values; the first exception is rethrown after all finish. */
+NITRO_TEST(when_all_vector)
+{
+    std::vector<Task<int>> tasks;
+    for (int i = 0; i < 8; ++i)
+        tasks.push_back(delayedValue(i, 0.01 * (8 - i)));
+    auto values = co_await whenAll(std::move(tasks));
+    NITRO_REQUIRE(values.size() == 8u);
+    for (int i = 0; i < 8; ++i)
+        NITRO_CHECK_EQ(values[i], i);
+
+    bool finished = false;
+    auto slowSibling = [&finished]() -> Task<> {
+        co_await Scheduler::current()->sleep_for(0.03);
+        finished = true;
+    };
+    std::vector<Task<>> failing;
+    failing.push_back(delayedThrow(0.01));
+    failing.push_back(slowSibling());
+    NITRO_CHECK_THROWS_AS(co_await whenAll(std::move(failing)), std::runtime_error);
+    NITRO_CHECK(finished);
+}
+
+// ── whenAny ───────────────────────────────────────────────────────────────────
+
+/** whenAny resumes with the first finisher and cancels the losers' token. */
+NITRO_TEST(when_any_first_wins)
+{
+    CancelSource losers;
+    auto token = losers.token();
+    bool loserSawCancel = false;
+
+    auto slow = [&loserSawCancel](CancelToken t) -> Task<int> {
+        co_await t.cancelled();
+        loserSawCancel = true;
+        co_return -1;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Task<int>> tasks;
+    tasks.push_back(slow(token));
+    tasks.push_back(delayedValue(7, 0.02));
+    auto result = co_await whenAny(losers, std::move(tasks));
+
+    NITRO_CHECK_EQ(result.index, 1u);
+    NITRO_CHECK_EQ(result.value, 7);
+    NITRO_CHECK(token.isCancelled());
+    NITRO_CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(200));
+
+    co_await Scheduler::current()->sleep_for(0.01);
+    NITRO_CHECK(loserSawCancel);
+}
+
+/** Losers that keep running after whenAny returns are cleaned up safely. */
+NITRO_TEST(when_any_detached_losers)
+{
+    auto result = co_await whenAny(delayedValue(1, 0.05), delayedValue(2, 0.01), delayedValue(3, 0.03));
+    NITRO_CHECK_EQ(result.index, 1u);
+    NITRO_CHECK_EQ(result.value, 2);
+    co_await Scheduler::current()->sleep_for(0.06);
+}
+
+// ── TaskGroup ────────────────────────────────────────────────────────────────
+
+/** Children can be placed on other Schedulers; join() waits for all of them. */
+NITRO_TEST(task_group_cross_scheduler)
+{
+    SchedulerGroup loops(3);
+    loops.start();
+
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic<int> done{ 0 };
+    {
+        TaskGroup group;
+        for (int i = 0; i < 12; ++i)
+        {
+            group.spawn([&]() -> Task<> {
+                co_await Scheduler::current()->sleep_for(0.01);
+                {
+                    std::lock_guard lock(mutex);
+                    threads.insert(std::this_thread::get_id());
+                }
+                done.fetch_add(1);
+            }, loops.next());
+        }
+        co_await group.join();
+    }
+
+    NITRO_CHECK_EQ(done.load(), 12);
+    NITRO_CHECK_EQ(threads.size(), 3u);
+    NITRO_CHECK(threads.count(std::this_thread::get_id()) == 0);
+
+    loops.stop();
+    loops.wait();
+}
+
+/** The first failure cancels siblings through the group token and is rethrown by join(). */
+NITRO_TEST(task_group_failure_cancels_siblings)
+{
+    TaskGroup group;
+    bool siblingCancelled = false;
+
+    group.spawn([&siblingCancelled](CancelToken token) -> Task<> {
+        co_await token.cancelled();
+        siblingCancelled = true;
+    });
+    group.spawn([]() -> Task<> { co_await delayedThrow(0.01); });
+
+    NITRO_CHECK_THROWS_AS(co_await group.join(), std::runtime_error);
+    NITRO_CHECK(siblingCancelled);
+    NITRO_CHECK(group.isCancelled());
+}
+
+/** A joined group can be reused, and join() on an empty group completes immediately. */
+NITRO_TEST(task_group_reuse)
+{
+    TaskGroup group;
+    co_await group.join();
+
+    int sum = 0;
+    for (int round = 0; round < 2; ++round)
+    {
+        for (int i = 1; i <= 3; ++i)
+            group.spawn([&sum, i]() -> Task<> { sum += co_await delayedValue(i, 0.005); });
+        co_await group.join();
+    }
+    NITRO_CHECK_EQ(sum, 12);
+}
+
+int main(int argc, char ** argv)
+{
+    return nitrocoro::test::run_all(argc, argv);
+}
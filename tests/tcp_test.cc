@@ -2,13 +2,24 @@
  * @file tcp_test.cc
  * @brief Tests for TcpServer and TcpConnection.
  */
+#include <nitrocoro/core/CancelToken.h>
 #include <nitrocoro/core/Future.h>
 #include <nitrocoro/core/Scheduler.h>
+#include <nitrocoro/core/SchedulerGroup.h>
 #include <nitrocoro/core/Task.h>
+#include <nitrocoro/core/Timeout.h>
+#include <nitrocoro/io/Stream.h>
 #include <nitrocoro/net/InetAddress.h>
 #include <nitrocoro/net/TcpConnection.h>
 #include <nitrocoro/net/TcpServer.h>
 #include <nitrocoro/testing/Test.h>
+#include <nitrocoro/utils/Debug.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
 
 using namespace nitrocoro;
 using namespace nitrocoro::net;
@@ -115,6 +126,55 @@ NITRO_TEST(tcp_multiple_clients)
     co_await server.stop();
 }
 
+/** A multi-loop server shards connections across a SchedulerGroup via SO_REUSEPORT. */
+NITRO_TEST(tcp_server_multi_loop)
+{
+    Scheduler * testScheduler = Scheduler::current();
+    SchedulerGroup group(4);
+    group.start();
+    {
+        TcpServer server(0, group);
+        uint16_t port = server.port();
+
+        testScheduler->spawn([TEST_CTX, &server]() -> Task<> {
+            co_await server.start([](TcpConnectionPtr conn) -> Task<> {
+                char buf[256];
+                size_t n = co_await conn->read(buf, sizeof(buf));
+                co_await conn->write(buf, n);
+            });
+        });
+
+        co_await server.started();
+
+        constexpr int kClients = 16;
+        int received = 0;
+        Promise<> done(testScheduler);
+        auto f = done.get_future();
+
+        for (int i = 0; i < kClients; ++i)
+        {
+            testScheduler->spawn([TEST_CTX, port, i, &received, &done]() mutable -> Task<> {
+                auto conn = co_await TcpConnection::connect({ "127.0.0.1", port });
+                std::string msg = "client" + std::to_string(i);
+                co_await conn->write(msg.data(), msg.size());
+
+                char buf[256]{};
+                size_t n = co_await conn->read(buf, sizeof(buf));
+                NITRO_CHECK(std::string_view(buf, n) == msg);
+
+                if (++received == kClients)
+                    done.set_value();
+            });
+        }
+
+        co_await f.get();
+        co_await server.stop();
+        NITRO_CHECK(Scheduler::current() == testScheduler);
+    }
+    group.stop();
+    group.wait();
+}
+
 /** localAddr and peerAddr are correctly set on both server and client connections. */
 NITRO_TEST(tcp_connection_addrs)
 {
@@ -288,6 +348,464 @@ NITRO_TEST(tcp_force_close)
     co_await server.stop();
 }
 
+/** forceClose() resumes a read parked on the same connection instead of stranding it. */
+NITRO_TEST(tcp_force_close_pending_read)
+{
+    TcpServer server(0);
+    uint16_t port = server.port();
+
+    Scheduler::current()->spawn([TEST_CTX, &server]() -> Task<> {
+        co_await server.start([](TcpConnectionPtr conn) -> Task<> {
+            co_await Scheduler::current()->sleep_for(0.1);
+        });
+    });
+
+    co_await server.started();
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", port });
+    bool resumed = false;
+    char buf[16]{};
+    Scheduler::current()->spawn([&]() -> Task<> {
+        try
+        {
+            co_await conn->read(buf, sizeof(buf));
+        }
+        catch (...)
+        {
+        }
+        resumed = true;
+    });
+    co_await Scheduler::current()->sleep_for(0.01);
+    NITRO_CHECK(!resumed);
+
+    co_await conn->forceClose();
+    co_await Scheduler::current()->sleep_for(0.02);
+    NITRO_CHECK(resumed);
+
+    co_await server.stop();
+}
+
+/** readSome() on already-buffered data completes inline without touching the frame pool. */
+NITRO_TEST(tcp_read_some_buffered)
+{
+    TcpServer server(0);
+    uint16_t port = server.port();
+
+    Scheduler::current()->spawn([TEST_CTX, &server]() -> Task<> {
+        co_await server.start([](TcpConnectionPtr conn) -> Task<> {
+            co_await conn->write("ping", 4);
+            char buf[16];
+            co_await conn->read(buf, sizeof(buf));
+        });
+    });
+
+    co_await server.started();
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", port });
+    co_await Scheduler::current()->sleep_for(0.02); // let "ping" arrive
+
+    // First call learns readiness from the poller; later calls stay inline.
+    char buf[16]{};
+    size_t n = co_await conn->readSome(buf, 2);
+    NITRO_CHECK_EQ(n, 2u);
+
+    auto before = framePoolStats();
+    auto * scheduler = Scheduler::current();
+    auto ready = conn->readSome(buf + 2, sizeof(buf) - 2);
+    NITRO_CHECK(ready.await_ready());
+    n = ready.await_resume();
+    NITRO_CHECK_EQ(n, 2u);
+    NITRO_CHECK(std::string_view(buf, 4) == "ping");
+    auto after = framePoolStats();
+    NITRO_CHECK_EQ(after.hits + after.misses, before.hits + before.misses);
+    NITRO_CHECK(Scheduler::current() == scheduler);
+
+    NITRO_CHECK_EQ(co_await conn->writeSome("x", 1), 1u);
+    co_await server.stop();
+}
+
+/** readSome() suspends on an empty socket and resumes with the data once it arrives. */
+NITRO_TEST(tcp_read_some_waits)
+{
+    TcpServer server(0);
+    uint16_t port = server.port();
+
+    Scheduler::current()->spawn([TEST_CTX, &server]() -> Task<> {
+        co_await server.start([](TcpConnectionPtr conn) -> Task<> {
+            co_await Scheduler::current()->sleep_for(0.02);
+            co_await conn->write("late", 4);
+            co_await conn->shutdown();
+        });
+    });
+
+    co_await server.started();
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", port });
+    char buf[16]{};
+    size_t n = co_await conn->readSome(buf, sizeof(buf));
+    NITRO_CHECK_EQ(n, 4u);
+    NITRO_CHECK(std::string_view(buf, n) == "late");
+
+    n = co_await conn->readSome(buf, sizeof(buf));
+    NITRO_CHECK_EQ(n, 0u);
+    NITRO_CHECK(conn->state() == TcpConnection::State::PeerShutdown);
+
+    co_await server.stop();
+}
+
+/** A read deadline cancels the pending wait and leaves the connection usable. */
+NITRO_TEST(tcp_read_deadline)
+{
+    TcpServer server(0);
+    uint16_t port = server.port();
+
+    Scheduler::current()->spawn([TEST_CTX, &server]() -> Task<> {
+        co_await server.start([](TcpConnectionPtr conn) -> Task<> {
+            co_await Scheduler::current()->sleep_for(0.1);
+            co_await conn->write("late", 4);
+            co_await conn->shutdown();
+        });
+    });
+
+    co_await server.started();
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", port }, std::chrono::seconds(5));
+    char buf[16]{};
+    auto start = std::chrono::steady_clock::now();
+    NITRO_CHECK_THROWS_AS(co_await conn->read(buf, sizeof(buf), std::chrono::milliseconds(20)), TimeoutException);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    NITRO_CHECK(elapsed >= std::chrono::milliseconds(15));
+    NITRO_CHECK(elapsed < std::chrono::milliseconds(90));
+    NITRO_CHECK(conn->state() == TcpConnection::State::Connected);
+
+    size_t n = co_await conn->readSome(buf, sizeof(buf), std::chrono::seconds(5));
+    NITRO_CHECK_EQ(n, 4u);
+    NITRO_CHECK(std::string_view(buf, n) == "late");
+
+    co_await server.stop();
+}
+
+/** Cancelling the token of a parked read resumes it with CancelledException. */
+NITRO_TEST(tcp_read_cancel_token)
+{
+    TcpServer server(0);
+    uint16_t port = server.port();
+
+    Scheduler::current()->spawn([TEST_CTX, &server]() -> Task<> {
+        co_await server.start([](TcpConnectionPtr conn) -> Task<> {
+            co_await Scheduler::current()->sleep_for(0.1);
+        });
+    });
+
+    co_await server.started();
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", port });
+    CancelSource source;
+    Scheduler::current()->spawn([&source]() -> Task<> {
+        co_await Scheduler::current()->sleep_for(0.01);
+        source.cancel();
+    });
+
+    char buf[16]{};
+    NITRO_CHECK_THROWS_AS(co_await conn->read(buf, sizeof(buf), source.token()), CancelledException);
+    // An already cancelled token fails fast without waiting.
+    NITRO_CHECK_THROWS_AS(co_await conn->readSome(buf, sizeof(buf), source.token()), CancelledException);
+
+    co_await server.stop();
+}
+
+/** A write deadline fires when the peer stops draining the socket. */
+NITRO_TEST(tcp_write_deadline)
+{
+    TcpServer server(0);
+    uint16_t port = server.port();
+
+    Scheduler::current()->spawn([TEST_CTX, &server]() -> Task<> {
+        co_await server.start([](TcpConnectionPtr conn) -> Task<> {
+            co_await Scheduler::current()->sleep_for(0.2);
+        });
+    });
+
+    co_await server.started();
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", port });
+    std::vector<char> chunk(1 << 20, 'x');
+    bool timedOut = false;
+    for (int i = 0; i < 64 && !timedOut; ++i)
+    {
+        try
+        {
+            co_await conn->write(chunk.data(), chunk.size(), std::chrono::milliseconds(30));
+        }
+        catch (const TimeoutException &)
+        {
+            timedOut = true;
+        }
+    }
+    NITRO_CHECK(timedOut);
+
+    co_await server.stop();
+}
+
+/** writev() sends every buffer in order, resuming after short writes mid-iovec. */
+NITRO_TEST(tcp_writev)
+{
+    TcpServer server(0);
+    uint16_t port = server.port();
+
+    Promise<std::string> receivedPromise;
+    auto received = receivedPromise.get_future().share();
+    Scheduler::current()->spawn([TEST_CTX, &server, &receivedPromise]() -> Task<> {
+        co_await server.start([&receivedPromise](TcpConnectionPtr conn) -> Task<> {
+            std::string all;
+            char buf[65536];
+            while (size_t n = co_await conn->read(buf, sizeof(buf)))
+                all.append(buf, n);
+            receivedPromise.set_value(std::move(all));
+        });
+    });
+
+    co_await server.started();
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", port });
+    std::string head = "head:";
+    std::string big(4 << 20, 'b');
+    big.back() = 'B';
+    std::string tail = ":tail";
+    iovec iov[] = {
+        { head.data(), head.size() },
+        { nullptr, 0 },
+        { big.data(), big.size() },
+        { tail.data(), tail.size() },
+    };
+    size_t n = co_await conn->writev(iov);
+    NITRO_CHECK_EQ(n, head.size() + big.size() + tail.size());
+
+    io::Stream stream(conn);
+    iovec more[] = { { tail.data(), 1 }, { head.data(), 1 } };
+    NITRO_CHECK_EQ(co_await stream.writev(more), 2u);
+    co_await conn->shutdown();
+
+    std::string all = co_await received.get();
+    NITRO_CHECK(all == head + big + tail + ":h");
+
+    co_await server.stop();
+}
+
+/** readv() scatters into several buffers; waitReadable() returns once data is pending without consuming it. */
+NITRO_TEST(tcp_readv_wait_readable)
+{
+    TcpServer server(0);
+    uint16_t port = server.port();
+
+    Promise<> sendPromise;
+    auto sendNow = sendPromise.get_future().share();
+    Scheduler::current()->spawn([TEST_CTX, &server, &sendNow]() -> Task<> {
+        co_await server.start([&sendNow](TcpConnectionPtr conn) -> Task<> {
+            co_await sendNow.get();
+            co_await conn->write("0123456789", 10);
+            co_await conn->shutdown();
+        });
+    });
+
+    co_await server.started();
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", port });
+    bool woke = false;
+    Scheduler::current()->spawn([conn, &woke]() -> Task<> {
+        co_await conn->waitReadable();
+        woke = true;
+    });
+    co_await Scheduler::current()->sleep_for(0.02);
+    NITRO_CHECK(!woke);
+
+    sendPromise.set_value();
+    co_await Scheduler::current()->sleep_for(0.05);
+    NITRO_CHECK(woke);
+
+    // Data still pending: returns at once
+    io::Stream stream(conn);
+    co_await stream.waitReadable();
+
+    // One 10-byte segment on loopback: a single readv() gets all of it
+    char a[4], b[16];
+    iovec iov[] = { { a, sizeof(a) }, { b, sizeof(b) } };
+    NITRO_CHECK_EQ(co_await stream.readv(iov), 10u);
+    NITRO_CHECK_EQ(std::string(a, 4) + std::string(b, 6), "0123456789");
+    NITRO_CHECK_EQ(co_await conn->readv(iov), 0u);
+
+    co_await server.stop();
+}
+
+/** tryReadv() reads only what is already pending; waitReadable() after an empty try still wakes on data. */
+NITRO_TEST(tcp_try_readv)
+{
+    TcpServer server(0);
+    uint16_t port = server.port();
+
+    Promise<> sendPromise;
+    auto sendNow = sendPromise.get_future().share();
+    Scheduler::current()->spawn([TEST_CTX, &server, &sendNow]() -> Task<> {
+        co_await server.start([&sendNow](TcpConnectionPtr conn) -> Task<> {
+            co_await sendNow.get();
+            co_await conn->write("abcdef", 6);
+            co_await conn->shutdown();
+        });
+    });
+
+    co_await server.started();
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", port });
+    char a[2], b[16];
+    iovec iov[] = { { a, sizeof(a) }, { b, sizeof(b) } };
+    NITRO_CHECK(!conn->tryReadv(iov).has_value());
+
+    io::Stream stream(conn);
+    NITRO_CHECK(!stream.tryReadv(iov).has_value());
+
+    bool woke = false;
+    Scheduler::current()->spawn([conn, &woke]() -> Task<> {
+        co_await conn->waitReadable();
+        woke = true;
+    });
+    co_await Scheduler::current()->sleep_for(0.02);
+    NITRO_CHECK(!woke);
+
+    sendPromise.set_value();
+    co_await Scheduler::current()->sleep_for(0.05);
+    NITRO_CHECK(woke);
+
+    auto got = stream.tryReadv(iov);
+    NITRO_CHECK(got.has_value());
+    NITRO_CHECK_EQ(*got, 6u);
+    NITRO_CHECK_EQ(std::string(a, 2) + std::string(b, 4), "abcdef");
+
+    auto eof = conn->tryReadv(iov);
+    NITRO_CHECK(eof.has_value());
+    NITRO_CHECK_EQ(*eof, 0u);
+    NITRO_CHECK(conn->state() == TcpConnection::State::PeerShutdown);
+
+    co_await server.stop();
+}
+
+/** sendFile() sends a byte range of a file, leaving the fd's own offset alone. */
+NITRO_TEST(tcp_send_file)
+{
+    TcpServer server(0);
+    uint16_t port = server.port();
+
+    Promise<std::string> receivedPromise;
+    auto received = receivedPromise.get_future().share();
+    Scheduler::current()->spawn([TEST_CTX, &server, &receivedPromise]() -> Task<> {
+        co_await server.start([&receivedPromise](TcpConnectionPtr conn) -> Task<> {
+            std::string all;
+            char buf[65536];
+            while (size_t n = co_await conn->read(buf, sizeof(buf)))
+                all.append(buf, n);
+            receivedPromise.set_value(std::move(all));
+        });
+    });
+
+    co_await server.started();
+
+    std::string content(2 * 1024 * 1024, '\0');
+    for (size_t i = 0; i < content.size(); ++i)
+        content[i] = static_cast<char>(i * 7);
+    char path[] = "/tmp/nitrocoro_sendfile_XXXXXX";
+    int fd = ::mkstemp(path);
+    NITRO_REQUIRE(fd >= 0);
+    ::unlink(path);
+    NITRO_REQUIRE(::write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size()));
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", port });
+    size_t n = co_await conn->sendFile(fd, 1000, content.size() - 2000);
+    NITRO_CHECK_EQ(n, content.size() - 2000);
+    NITRO_CHECK_EQ(::lseek(fd, 0, SEEK_CUR), static_cast<off_t>(content.size()));
+    NITRO_CHECK_THROWS_AS(co_await conn->sendFile(fd, content.size() - 10, 20), std::runtime_error);
+    co_await conn->shutdown();
+    ::close(fd);
+
+    std::string all = co_await received.get();
+    NITRO_CHECK(all == content.substr(1000, content.size() - 2000) + content.substr(content.size() - 10));
+
+    co_await server.stop();
+}
+
+/** Writes and gathers above the zero-copy threshold arrive intact, mixed with ordinary copied writes. */
+NITRO_TEST(tcp_zero_copy_write)
+{
+    TcpServer server(0);
+    uint16_t port = server.port();
+
+    Promise<std::string> receivedPromise;
+    auto received = receivedPromise.get_future().share();
+    Scheduler::current()->spawn([TEST_CTX, &server, &receivedPromise]() -> Task<> {
+        co_await server.start([&receivedPromise](TcpConnectionPtr conn) -> Task<> {
+            std::string all;
+            char buf[65536];
+            while (size_t n = co_await conn->read(buf, sizeof(buf)))
+                all.append(buf, n);
+            receivedPromise.set_value(std::move(all));
+        });
+    });
+
+    co_await server.started();
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", port });
+    if (!conn->setZeroCopyThreshold(64 * 1024))
+    {
+        NITRO_INFO("SO_ZEROCOPY unsupported here, skipping");
+        co_await server.stop();
+        co_return;
+    }
+
+    std::string big(3 * 1024 * 1024 + 5, '\0');
+    for (size_t i = 0; i < big.size(); ++i)
+        big[i] = static_cast<char>(i * 13);
+    NITRO_CHECK_EQ(co_await conn->write(big.data(), big.size()), big.size());
+    NITRO_CHECK_EQ(co_await conn->write("small", 5), 5u);
+    NITRO_CHECK_EQ(co_await conn->write(big.data(), big.size()), big.size());
+    // A gather above the threshold goes out zero-copy too, empty buffers included.
+    iovec iov[] = { { const_cast<char *>("head:"), 5 }, { nullptr, 0 }, { big.data(), big.size() }, { const_cast<char *>(":tail"), 5 } };
+    NITRO_CHECK_EQ(co_await conn->writev(iov), big.size() + 10);
+    co_await conn->shutdown();
+
+    std::string all = co_await received.get();
+    NITRO_CHECK(all == big + "small" + big + "head:" + big + ":tail");
+
+    co_await server.stop();
+}
+
+/** A deadline that interrupts a zero-copy write throws and resets the connection. */
+NITRO_TEST(tcp_zero_copy_write_deadline)
+{
+    TcpServer server(0);
+    uint16_t port = server.port();
+
+    // The peer neither reads nor closes until the check is done.
+    Promise<> donePromise;
+    auto done = donePromise.get_future().share();
+    Scheduler::current()->spawn([TEST_CTX, &server, done]() -> Task<> {
+        co_await server.start([done](TcpConnectionPtr conn) -> Task<> {
+            co_await done.get();
+        });
+    });
+
+    co_await server.started();
+
+    auto conn = co_await TcpConnection::connect({ "127.0.0.1", port });
+    if (conn->setZeroCopyThreshold(64 * 1024))
+    {
+        std::vector<char> chunk(64 << 20, 'z');
+        NITRO_CHECK_THROWS_AS(co_await conn->write(chunk.data(), chunk.size(), std::chrono::milliseconds(50)),
+                              TimeoutException);
+        NITRO_CHECK(conn->state() == TcpConnection::State::Closed);
+    }
+    donePromise.set_value();
+
+    co_await server.stop();
+}
+
 int main(int argc, char ** argv)
 {
     return nitrocoro::test::run_all(argc, argv);
@@ -10,6 +10,14 @@
 #include <nitrocoro/net/TcpConnection.h>
 #include <nitrocoro/testing/Test.h>
 
+#include <memory>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 using namespace nitrocoro;
 using namespace nitrocoro::net;
 
@@ -72,10 +80,22 @@ NITRO_TEST(timeout_inner_continues_after_timeout)
     NITRO_CHECK(innerCompleted); // inner ran to completion despite timeout
 }
 
+/** withTimeout hands back move-only results from the driver frame. */
+NITRO_TEST(timeout_move_only_result)
+{
+    auto make = []() -> Task<std::unique_ptr<int>> {
+        co_await Scheduler::current()->sleep_for(0.005);
+        co_return std::make_unique<int>(5);
+    };
+    auto value = co_await withTimeout(make(), std::chrono::seconds(1));
+    NITRO_REQUIRE(value != nullptr);
+    NITRO_CHECK_EQ(*value, 5);
+}
+
 /**
- * Demonstrates the known limitation: after TimeoutException, the inner connect
- * coroutine keeps running (holding the fd) until the OS-level TCP timeout fires.
- * There is currently no way to cancel it from outside.
+ * Demonstrates the limitation of withTimeout: after TimeoutException, the inner
+ * connect coroutine keeps running (holding the fd) until the OS-level TCP
+ * timeout fires. Use connect()'s own deadline to cancel the wait instead.
  */
 NITRO_TEST(timeout_tcp_connect_no_cancel)
 {
@@ -91,6 +111,40 @@ NITRO_TEST(timeout_tcp_connect_no_cancel)
     // stop_token propagation through the coroutine chain, which is not yet implemented.
 }
 
+/** connect() with a deadline cancels its own pending wait and releases the fd. */
+NITRO_TEST(timeout_tcp_connect_deadline)
+{
+    // A listener that never accepts: once its backlog is full the kernel drops
+    // further SYNs, so the handshake hangs without needing a network.
+    int listener = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    NITRO_REQUIRE(listener >= 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    NITRO_REQUIRE(::bind(listener, reinterpret_cast<sockaddr *>(&addr), addrLen) == 0);
+    NITRO_REQUIRE(::listen(listener, 0) == 0);
+    NITRO_REQUIRE(::getsockname(listener, reinterpret_cast<sockaddr *>(&addr), &addrLen) == 0);
+    InetAddress target("127.0.0.1", ntohs(addr.sin_port));
+
+    std::vector<TcpConnectionPtr> queued;
+    bool timedOut = false;
+    for (int i = 0; i < 8 && !timedOut; ++i)
+    {
+        try
+        {
+            queued.push_back(co_await TcpConnection::connect(target, std::chrono::milliseconds(50)));
+        }
+        catch (const TimeoutException &)
+        {
+            timedOut = true;
+        }
+    }
+    NITRO_CHECK(timedOut);
+    queued.clear();
+    ::close(listener);
+}
+
 int main(int argc, char ** argv)
 {
     return nitrocoro::test::run_all(argc, argv);
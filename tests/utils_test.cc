@@ -1,8 +1,13 @@
 #include <nitrocoro/testing/Test.h>
 #include <nitrocoro/utils/Base64.h>
+#include <nitrocoro/utils/BufferPool.h>
+#include <nitrocoro/utils/IoBuffer.h>
 #include <nitrocoro/utils/Md5.h>
 #include <nitrocoro/utils/Sha1.h>
 
+#include <cstring>
+#include <string>
+
 using namespace nitrocoro::utils;
 
 // ── Base64 ────────────────────────────────────────────────────────────────────
@@ -74,6 +79,153 @@ NITRO_TEST(md5_hex)
     co_return;
 }
 
+// ── IoBuffer ──────────────────────────────────────────────────────────────────
+
+namespace
+{
+
+// Appends @p data, filling the current block before starting the next one.
+void append(IoBuffer & buf, std::string_view data)
+{
+    while (!data.empty())
+    {
+        size_t n = std::min(data.size(), buf.writableSize());
+        if (n == 0)
+        {
+            buf.prepareWrite(1);
+            continue;
+        }
+        std::memcpy(buf.beginWrite(), data.data(), n);
+        buf.commitWrite(n);
+        data.remove_prefix(n);
+    }
+}
+
+std::string drain(IoBuffer & buf)
+{
+    std::string out(buf.remainSize(), '\0');
+    buf.read(out.data(), out.size());
+    return out;
+}
+
+} // namespace
+
+NITRO_TEST(io_buffer_chain)
+{
+    constexpr size_t kBlock = BufferPool::kBlockSize;
+    std::string data(kBlock * 2 + 100, '\0');
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<char>('a' + i % 26);
+
+    IoBuffer buf;
+    append(buf, data);
+    NITRO_CHECK_EQ(buf.remainSize(), data.size());
+    NITRO_CHECK_EQ(buf.blockCount(), 3u);
+    NITRO_CHECK_EQ(buf.view().size(), kBlock);
+
+    // Drained head blocks go back to the pool at once
+    buf.consume(kBlock + 10);
+    NITRO_CHECK_EQ(buf.blockCount(), 2u);
+    NITRO_CHECK_EQ(drain(buf), data.substr(kBlock + 10));
+    NITRO_CHECK(!buf.hasRemaining());
+    co_return;
+}
+
+NITRO_TEST(io_buffer_find_and_pullup)
+{
+    constexpr size_t kBlock = BufferPool::kBlockSize;
+    IoBuffer buf;
+    append(buf, std::string(kBlock - 1, 'x'));
+    append(buf, "\r\nline two\r\n");
+
+    // "\r\n" straddles the first and second block
+    NITRO_CHECK_EQ(buf.find("\r\n"), kBlock - 1);
+    NITRO_CHECK_EQ(buf.find("\r\n", kBlock), kBlock + 9);
+    NITRO_CHECK_EQ(buf.find("two"), kBlock + 6);
+    NITRO_CHECK_EQ(buf.find("missing"), IoBuffer::npos);
+
+    buf.consume(kBlock - 4);
+    std::string_view line = buf.pullup(13);
+    NITRO_CHECK_EQ(line, std::string_view("xxx\r\nline two"));
+    NITRO_CHECK_EQ(buf.view().substr(0, 13), line);
+    buf.consume(13);
+    NITRO_CHECK_EQ(drain(buf), "\r\n");
+    co_return;
+}
+
+NITRO_TEST(io_buffer_prepare_writev)
+{
+    constexpr size_t kBlock = BufferPool::kBlockSize;
+    IoBuffer buf;
+    append(buf, std::string(kBlock - 100, 'a'));
+
+    iovec iov[2];
+    size_t count = buf.prepareWritev(iov, 2, 4096);
+    NITRO_CHECK_EQ(count, 2u);
+    NITRO_CHECK_EQ(iov[0].iov_len, 100u);
+    NITRO_CHECK_EQ(iov[1].iov_len, kBlock);
+
+    // Simulate a readv() that fills the tail and spills into the next block
+    std::memset(iov[0].iov_base, 'b', 100);
+    std::memset(iov[1].iov_base, 'c', 50);
+    buf.commitWrite(150);
+    NITRO_CHECK_EQ(buf.remainSize(), kBlock + 50);
+    NITRO_CHECK_EQ(buf.find("bc"), kBlock - 1);
+    NITRO_CHECK_EQ(buf.writableSize(), kBlock - 50);
+    co_return;
+}
+
+NITRO_TEST(io_buffer_shrink_returns_blocks)
+{
+    int64_t baseline = bufferPoolStats().inUse;
+    {
+        IoBuffer buf;
+        iovec iov[4];
+        buf.prepareWritev(iov, 4, 3 * BufferPool::kBlockSize);
+        NITRO_CHECK_EQ(bufferPoolStats().inUse, baseline + 3);
+
+        buf.commitWrite(10);
+        buf.shrink(); // keeps the block holding data, drops the spares
+        NITRO_CHECK_EQ(buf.blockCount(), 1u);
+        NITRO_CHECK_EQ(bufferPoolStats().inUse, baseline + 1);
+
+        buf.consume(10);
+        buf.shrink();
+        NITRO_CHECK_EQ(buf.blockCount(), 0u);
+        NITRO_CHECK_EQ(bufferPoolStats().inUse, baseline);
+
+        // Reuses a cached block
+        uint64_t hits = bufferPoolStats().hits;
+        buf.prepareWrite(1);
+        NITRO_CHECK_EQ(bufferPoolStats().hits, hits + 1);
+    }
+    NITRO_CHECK_EQ(bufferPoolStats().inUse, baseline);
+    co_return;
+}
+
+NITRO_TEST(io_buffer_oversize_write)
+{
+    constexpr size_t kBlock = BufferPool::kBlockSize;
+    int64_t baseline = bufferPoolStats().inUse;
+    IoBuffer buf;
+    append(buf, "head");
+    char * ptr = buf.prepareWrite(kBlock * 3);
+    NITRO_CHECK(buf.writableSize() >= kBlock * 3);
+    NITRO_CHECK_EQ(reinterpret_cast<uintptr_t>(ptr) % BufferPool::kAlignment, 0u);
+    std::memset(ptr, 'z', kBlock * 3);
+    buf.commitWrite(kBlock * 3);
+    NITRO_CHECK_EQ(buf.remainSize(), kBlock * 3 + 4);
+    // Only the first block comes from the pool
+    NITRO_CHECK_EQ(bufferPoolStats().inUse, baseline + 1);
+
+    IoBuffer moved = std::move(buf);
+    NITRO_CHECK_EQ(buf.remainSize(), 0u);
+    NITRO_CHECK_EQ(drain(moved), "head" + std::string(kBlock * 3, 'z'));
+    moved.shrink();
+    NITRO_CHECK_EQ(bufferPoolStats().inUse, baseline);
+    co_return;
+}
+
 int main(int argc, char ** argv)
 {
     return nitrocoro::test::run_all(argc, argv);